@@ -64,6 +64,27 @@ void DBcore::ping()
 	MDatabase.unlock();
 }
 
+static thread_local uint64 thread_query_time = 0;
+static thread_local int    thread_query_depth = 0;
+
+// adds the time spent in the outermost QueryDatabase call to the thread's total
+struct QueryTimeScope {
+	BenchTimer timer;
+
+	QueryTimeScope() { ++thread_query_depth; }
+	~QueryTimeScope()
+	{
+		if (--thread_query_depth == 0) {
+			thread_query_time += static_cast<uint64>(timer.elapsed() * 1000000.0);
+		}
+	}
+};
+
+uint64 DBcore::GetThreadQueryTime()
+{
+	return thread_query_time;
+}
+
 MySQLRequestResult DBcore::QueryDatabase(std::string query, bool retryOnFailureOnce)
 {
 	return QueryDatabase(query.c_str(), query.length(), retryOnFailureOnce);
@@ -71,6 +92,7 @@ MySQLRequestResult DBcore::QueryDatabase(std::string query, bool retryOnFailureO
 
 MySQLRequestResult DBcore::QueryDatabase(const char *query, uint32 querylen, bool retryOnFailureOnce)
 {
+	QueryTimeScope query_time;
 	BenchTimer timer;
 	timer.reset();
 
@@ -29,6 +29,9 @@ public:
 	void	ping();
 	MYSQL*	getMySQL(){ return &mysql; }
 
+	// total wall time this thread has spent in QueryDatabase, in microseconds
+	static uint64 GetThreadQueryTime();
+
 protected:
 	bool	Open(const char* iHost, const char* iUser, const char* iPassword, const char* iDatabase, uint32 iPort, uint32* errnum = 0, char* errbuf = 0, bool iCompress = false, bool iSSL = false);
 private:
@@ -1,3 +1,4 @@
+#include <iterator>
 #include <utility>
 
 #include "global_define.h"
@@ -6,12 +7,16 @@
 #include "eq_stream_proxy.h"
 #include "misc.h"
 
+EQStreamIdentifier::EQStreamIdentifier() {
+	m_polled = 0;
+}
+
 EQStreamIdentifier::~EQStreamIdentifier() {
 	while(!m_identified.empty()) {
 		m_identified.front()->ReleaseFromUse();
 		m_identified.pop();
 	}
-	std::vector<Record>::iterator cur, end;
+	std::list<Record>::iterator cur, end;
 	cur = m_streams.begin();
 	end = m_streams.end();
 	for(; cur != end; ++cur) {
@@ -32,121 +37,232 @@ void EQStreamIdentifier::RegisterPatch(const EQStreamInterface::Signature &sig,
 	p->name = name;
 	p->opcodes = opcodes;
 	p->structs = structs;
+	p->order = m_patches.size();
 	m_patches.push_back(p);
+
+	m_patch_index[(uint64(sig.first_eq_opcode) << 32) | sig.first_length].push_back(p);
+	m_patch_opcodes[sig.first_eq_opcode].push_back(p);
+	if(sig.ignore_eq_opcode != 0) {
+		m_ignore_opcodes[sig.ignore_eq_opcode]++;
+	}
 }
 
 void EQStreamIdentifier::Process() {
-	std::vector<Record>::iterator cur;
-	std::vector<Patch *>::iterator curp, endp;
+	//only the oldest records can have expired
+	while(!m_streams.empty() && m_streams.front().expire.Check(false)) {
+		//closing fires the state change event synchronously, so forget the stream first
+		auto stream = m_streams.front().stream;
+		LogNetcode("[StreamIdentify] Unable to identify stream from [{}:{}] before timeout", stream->GetRemoteAddr().c_str(), ntohs(stream->GetRemotePort()));
+		RemoveRecord(m_streams.begin());
+		stream->Close();
+	}
 
-	//foreach pending stream.
-	cur = m_streams.begin();
+	//everything else is identified as packets arrive, only streams we can't peek into still need polling
+	if(m_polled == 0) {
+		return;
+	}
+
+	auto cur = m_streams.begin();
 	while(cur != m_streams.end()) {
-		Record &r = *cur;
+		auto next = std::next(cur);
+		if(cur->poll) {
+			Identify(cur);
+		}
+		cur = next;
+	}
+}
 
-		//first see if this stream has expired
-		if(r.expire.Check(false)) {
-			LogNetcode("[StreamIdentify] Unable to identify stream from [{}:{}] before timeout", r.stream->GetRemoteAddr().c_str(), ntohs(r.stream->GetRemotePort()));
-			r.stream->Close();
+void EQStreamIdentifier::PacketReceived(EQStreamInterface *eqs) {
+	auto iter = m_stream_index.find(eqs);
+	if(iter == m_stream_index.end()) {
+		return;
+	}
 
-			cur = m_streams.erase(cur);
-			continue;
-		}
+	Identify(iter->second);
+}
 
-		//then make sure the stream is still active
-		//if stream hasn't finished initializing then continue;
-		if(r.stream->GetState() == UNESTABLISHED)
+void EQStreamIdentifier::StreamClosed(EQStreamInterface *eqs) {
+	auto iter = m_stream_index.find(eqs);
+	if(iter == m_stream_index.end()) {
+		return;
+	}
+
+	Record &r = *iter->second;
+	LogNetcode("[StreamIdentify] Unable to identify stream from [{}:{}] before it closed", long2ip(r.stream->GetRemoteIP()).c_str(), ntohs(r.stream->GetRemotePort()));
+	r.stream->ReleaseFromUse();
+	RemoveRecord(iter->second);
+}
+
+void EQStreamIdentifier::Identify(std::list<Record>::iterator record) {
+	Record &r = *record;
+
+	//if stream hasn't finished initializing then wait for the next packet
+	if(r.stream->GetState() == UNESTABLISHED) {
+		return;
+	}
+
+	if(r.stream->GetState() != ESTABLISHED) {
+		//the stream closed before it was identified.
+		LogNetcode("[StreamIdentify] Unable to identify stream from [{}:{}] before it closed", long2ip(r.stream->GetRemoteIP()).c_str(), ntohs(r.stream->GetRemotePort()));
+		switch(r.stream->GetState())
 		{
-			++cur;
-			continue;
+		case CLOSING:
+			LogNetcode("[StreamIdentify] Stream state was Closing");
+			break;
+		case DISCONNECTING:
+			LogNetcode("[StreamIdentify] Stream state was Disconnecting");
+			break;
+		case CLOSED:
+			LogNetcode("[StreamIdentify] Stream state was Closed");
+			break;
+		default:
+			LogNetcode("[StreamIdentify] Stream state was Unestablished or unknown");
+			break;
 		}
-		if(r.stream->GetState() != ESTABLISHED) {
-			//the stream closed before it was identified.
-			LogNetcode("[StreamIdentify] Unable to identify stream from [{}:{}] before it closed", long2ip(r.stream->GetRemoteIP()).c_str(), ntohs(r.stream->GetRemotePort()));
-			switch(r.stream->GetState())
-			{
-			case ESTABLISHED:
-				LogNetcode("[StreamIdentify] Stream state was Established");
-				break;
-			case CLOSING:
-				LogNetcode("[StreamIdentify] Stream state was Closing");
-				break;
-			case DISCONNECTING:
-				LogNetcode("[StreamIdentify] Stream state was Disconnecting");
-				break;
-			case CLOSED:
-				LogNetcode("[StreamIdentify] Stream state was Closed");
-				break;
-			default:
-				LogNetcode("[StreamIdentify] Stream state was Unestablished or unknown");
-				break;
-			}
-			r.stream->ReleaseFromUse();
-			cur = m_streams.erase(cur);
-			continue;
+		r.stream->ReleaseFromUse();
+		RemoveRecord(record);
+		return;
+	}
+
+	Patch *p = nullptr;
+	switch(Match(r, p)) {
+	case EQStreamInterface::MatchNotReady:
+		//the stream has not received enough packets to compare with every candidate
+		break;
+	case EQStreamInterface::MatchSuccessful: {
+		LogNetcode("[StreamIdentify] Identified stream [{}:{}] with signature [{}]", long2ip(r.stream->GetRemoteIP()).c_str(), ntohs(r.stream->GetRemotePort()), p->name.c_str());
+
+		// before we assign the eqstream to an interface, let the stream recognize it is in use and the session should not be reset any further
+		r.stream->SetActive(true);
+		r.stream->CaptureClientVersion(p->name);
+
+		//might want to do something less-specific here... some day..
+		EQStreamInterface *s = new EQStreamProxy(r.stream, p->structs, p->opcodes);
+		m_identified.push(s);
+
+		RemoveRecord(record);
+		break;
+	}
+	case EQStreamInterface::MatchFailed:
+		//the stream cannot be identified.
+		LogNetcode("[StreamIdentify] Unable to identify stream from [{}:{}], no match found", long2ip(r.stream->GetRemoteIP()).c_str(), ntohs(r.stream->GetRemotePort()));
+		r.stream->ReleaseFromUse();
+		RemoveRecord(record);
+		break;
+	}
+}
+
+EQStreamInterface::MatchState EQStreamIdentifier::Match(Record &r, Patch *&match) {
+	match = nullptr;
+	if(r.poll) {
+		return MatchAll(r, match);
+	}
+
+	uint16 opcode = 0;
+	uint32 length = 0;
+	auto res = r.stream->PeekPacket(0, opcode, length);
+	if(res == EQStreamInterface::MatchFailed) {
+		r.poll = true;
+		m_polled++;
+		return MatchAll(r, match);
+	}
+
+	if(res == EQStreamInterface::MatchNotReady) {
+		return res;
+	}
+
+	FindCandidates(opcode, length, opcode, false, match);
+
+	//patches that skip this opcode (usually an ack) are judged on the packet after it
+	bool ready = true;
+	if(m_ignore_opcodes.find(opcode) != m_ignore_opcodes.end()) {
+		uint16 next_opcode = 0;
+		uint32 next_length = 0;
+		if(r.stream->PeekPacket(1, next_opcode, next_length) == EQStreamInterface::MatchSuccessful) {
+			FindCandidates(next_opcode, next_length, opcode, true, match);
+		} else {
+			ready = false;
+		}
+	}
+
+	if(match) {
+		return EQStreamInterface::MatchSuccessful;
+	}
+
+	return ready ? EQStreamInterface::MatchFailed : EQStreamInterface::MatchNotReady;
+}
+
+void EQStreamIdentifier::FindCandidates(uint16 opcode, uint32 length, uint16 skipped, bool after_skip, Patch *&best) {
+	//a zero length packet matches any length, same as CheckSignature
+	const std::vector<Patch *> *candidates = nullptr;
+	if(length == 0) {
+		auto iter = m_patch_opcodes.find(opcode);
+		if(iter != m_patch_opcodes.end()) {
+			candidates = &iter->second;
+		}
+	} else {
+		auto iter = m_patch_index.find((uint64(opcode) << 32) | length);
+		if(iter != m_patch_index.end()) {
+			candidates = &iter->second;
 		}
+	}
+
+	if(!candidates) {
+		return;
+	}
 
-		//not expired, check against all patch signatures
-
-		bool found_one = false;		//"we found a matching patch for this stream"
-		bool all_ready = true;		//"all signatures were ready to check the stream"
-
-		//foreach possbile patch...
-		curp = m_patches.begin();
-		endp = m_patches.end();
-		for(; !found_one && curp != endp; ++curp) {
-			Patch *p = *curp;
-
-			//ask the stream to see if it matches the supplied signature
-			EQStreamInterface::MatchState res = r.stream->CheckSignature(&p->signature);
-			switch(res) {
-			case EQStreamInterface::MatchNotReady:
-				//the stream has not received enough packets to compare with this signature
-//				Log.LogDebugType(Logs::General, Logs::Netcode, "[StreamIdentify] %s:%d: Tried patch %s, but stream is not ready for it.", long2ip(r.stream->GetRemoteIP()).c_str(), ntohs(r.stream->GetRemotePort()), p->name.c_str());
-				all_ready = false;
-				break;
-			case EQStreamInterface::MatchSuccessful: {
-				//yay, a match.
-
-				LogNetcode("[StreamIdentify] Identified stream [{}:{}] with signature [{}]", long2ip(r.stream->GetRemoteIP()).c_str(), ntohs(r.stream->GetRemotePort()), p->name.c_str());
-
-				// before we assign the eqstream to an interface, let the stream recognize it is in use and the session should not be reset any further
-				r.stream->SetActive(true);
-
-				//might want to do something less-specific here... some day..
-				EQStreamInterface *s = new EQStreamProxy(r.stream, p->structs, p->opcodes);
-				m_identified.push(s);
-
-				found_one = true;
-				break;
-			}
-			case EQStreamInterface::MatchFailed:
-				//do nothing...
-				LogNetcode("[StreamIdentify] [{}:{}] Tried patch [{}] and it did not match", long2ip(r.stream->GetRemoteIP()).c_str(), ntohs(r.stream->GetRemotePort()), p->name.c_str());
-				break;
-			}
+	for(auto p : *candidates) {
+		bool skips = p->signature.ignore_eq_opcode != 0 && p->signature.ignore_eq_opcode == skipped;
+		if(skips != after_skip) {
+			continue;
 		}
 
-		//if we checked all patches and did not find a match.
-		if(all_ready && !found_one) {
-			//the stream cannot be identified.
-			LogNetcode("[StreamIdentify] Unable to identify stream from [{}:{}], no match found", long2ip(r.stream->GetRemoteIP()).c_str(), ntohs(r.stream->GetRemotePort()));
-			r.stream->ReleaseFromUse();
+		if(!best || p->order < best->order) {
+			best = p;
 		}
+	}
+}
 
-		//if we found a match, or were not able to identify it
-		if(found_one || all_ready) {
-			//cannot print ip/port here. r.stream is invalid.
-			cur = m_streams.erase(cur);
-		} else {
-			++cur;
+EQStreamInterface::MatchState EQStreamIdentifier::MatchAll(Record &r, Patch *&match) {
+	bool all_ready = true;		//"all signatures were ready to check the stream"
+
+	//foreach possbile patch...
+	for(auto p : m_patches) {
+		//ask the stream to see if it matches the supplied signature
+		EQStreamInterface::MatchState res = r.stream->CheckSignature(&p->signature);
+		switch(res) {
+		case EQStreamInterface::MatchNotReady:
+			//the stream has not received enough packets to compare with this signature
+			all_ready = false;
+			break;
+		case EQStreamInterface::MatchSuccessful:
+			match = p;
+			return res;
+		case EQStreamInterface::MatchFailed:
+			LogNetcode("[StreamIdentify] [{}:{}] Tried patch [{}] and it did not match", long2ip(r.stream->GetRemoteIP()).c_str(), ntohs(r.stream->GetRemotePort()), p->name.c_str());
+			break;
 		}
-	}	//end foreach stream
+	}
+
+	return all_ready ? EQStreamInterface::MatchFailed : EQStreamInterface::MatchNotReady;
+}
+
+void EQStreamIdentifier::RemoveRecord(std::list<Record>::iterator record) {
+	if(record->poll) {
+		m_polled--;
+	}
+
+	m_stream_index.erase(record->stream.get());
+	m_streams.erase(record);
 }
 
 void EQStreamIdentifier::AddStream(std::shared_ptr<EQStreamInterface> eqs) {
 	m_streams.push_back(Record(eqs));
 	eqs = nullptr;
+
+	auto record = std::prev(m_streams.end());
+	m_stream_index[record->stream.get()] = record;
+	Identify(record);
 }
 
 EQStreamInterface *EQStreamIdentifier::PopIdentified() {
@@ -159,7 +275,8 @@ EQStreamInterface *EQStreamIdentifier::PopIdentified() {
 
 EQStreamIdentifier::Record::Record(std::shared_ptr<EQStreamInterface> s)
 :	stream(std::move(s)),
-	expire(STREAM_IDENT_WAIT_MS)
+	expire(STREAM_IDENT_WAIT_MS),
+	poll(false)
 {
 }
 
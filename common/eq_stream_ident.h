@@ -5,7 +5,9 @@
 #include "timer.h"
 #include <vector>
 #include <queue>
+#include <list>
 #include <memory>
+#include <unordered_map>
 
 #define STREAM_IDENT_WAIT_MS 30000
 
@@ -15,6 +17,7 @@ class EQStreamInterface;
 
 class EQStreamIdentifier {
 public:
+	EQStreamIdentifier();
 	~EQStreamIdentifier();
 
 	//registration interface.
@@ -25,6 +28,10 @@ public:
 	void AddStream(std::shared_ptr<EQStreamInterface> eqs);
 	EQStreamInterface *PopIdentified();
 
+	//event interface, lets streams identify on their first packet instead of waiting for Process
+	void PacketReceived(EQStreamInterface *eqs);
+	void StreamClosed(EQStreamInterface *eqs);
+
 protected:
 
 	//registered patches..
@@ -34,17 +41,34 @@ protected:
 		EQStreamInterface::Signature		signature;
 		OpcodeManager **		opcodes;
 		const StructStrategy *structs;
+		size_t					order;	//registration order, earlier patches win ties
 	};
 	std::vector<Patch *> m_patches;	//we own these objects.
 
+	//patches by (first opcode, first length), and by first opcode alone for zero length packets
+	std::unordered_map<uint64, std::vector<Patch *>> m_patch_index;
+	std::unordered_map<uint16, std::vector<Patch *>> m_patch_opcodes;
+	std::unordered_map<uint16, size_t> m_ignore_opcodes;
+
 	//pending streams..
 	class Record {
 	public:
 		Record(std::shared_ptr<EQStreamInterface> s);
 		std::shared_ptr<EQStreamInterface> stream;		//we own this
 		Timer expire;
+		bool poll;		//stream cannot be peeked, fall back to trying every signature each Process
 	};
-	std::vector<Record> m_streams;	//we own these objects, and the streams contained in them.
+
+	void Identify(std::list<Record>::iterator record);
+	EQStreamInterface::MatchState Match(Record &r, Patch *&match);
+	EQStreamInterface::MatchState MatchAll(Record &r, Patch *&match);
+	void FindCandidates(uint16 opcode, uint32 length, uint16 skipped, bool after_skip, Patch *&best);
+	void RemoveRecord(std::list<Record>::iterator record);
+
+	//all records share one timeout so arrival order is also expiry order
+	std::list<Record> m_streams;	//we own these objects, and the streams contained in them.
+	std::unordered_map<EQStreamInterface *, std::list<Record>::iterator> m_stream_index;
+	size_t m_polled;
 	std::queue<EQStreamInterface *> m_identified;	//we own these objects
 };
 
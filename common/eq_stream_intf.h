@@ -44,6 +44,8 @@ struct EQStreamManagerInterfaceOptions
 
 	int opcode_size;
 	bool track_opcode_stats;
+	//when set every new stream records its application packets to <capture_directory>/<ms>-<ip>-<port>.eqcap
+	std::string capture_directory;
 	EQ::Net::DaybreakConnectionManagerOptions daybreak_options;
 };
 
@@ -98,8 +100,11 @@ public:
 	virtual std::string Describe() const = 0;
 	virtual void SetActive(bool val) { }
 	virtual MatchState CheckSignature(const Signature *sig) { return MatchFailed; }
+	//eq opcode and payload length of a queued packet; MatchFailed if this stream can't be peeked
+	virtual MatchState PeekPacket(size_t index, uint16 &eq_opcode, uint32 &length) const { return MatchFailed; }
 	virtual EQStreamState GetState() = 0;
 	virtual void SetOpcodeManager(OpcodeManager **opm) = 0;
+	virtual void CaptureClientVersion(const std::string &name) { }
 	virtual const EQ::versions::ClientVersion ClientVersion() const { return EQ::versions::ClientVersion::Unknown; }
 	virtual Stats GetStats() const = 0;
 	virtual void ResetStats() = 0;
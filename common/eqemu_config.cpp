@@ -135,9 +135,11 @@ void EQEmuConfig::parse_config()
 	QuestDir     = _root["server"]["directories"].get("quests", "quests/").asString();
 	PluginDir    = _root["server"]["directories"].get("plugins", "plugins/").asString();
 	LuaModuleDir = _root["server"]["directories"].get("lua_modules", "lua_modules/").asString();
+	LuaBytecodeDir = _root["server"]["directories"].get("lua_bytecode", "lua_bytecode/").asString();
 	PatchDir     = _root["server"]["directories"].get("patches", "./").asString();
 	SharedMemDir = _root["server"]["directories"].get("shared_memory", "shared/").asString();
 	LogDir       = _root["server"]["directories"].get("logs", "logs/").asString();
+	PacketCaptureDir = _root["server"]["directories"].get("packet_captures", "").asString();
 
 	/**
 	 * Logs
@@ -278,6 +280,9 @@ std::string EQEmuConfig::GetByName(const std::string &var_name) const
 	if (var_name == "LuaModuleDir") {
 		return (LuaModuleDir);
 	}
+	if (var_name == "LuaBytecodeDir") {
+		return (LuaBytecodeDir);
+	}
 	if (var_name == "PatchDir") {
 		return (PatchDir);
 	}
@@ -287,6 +292,9 @@ std::string EQEmuConfig::GetByName(const std::string &var_name) const
 	if (var_name == "LogDir") {
 		return (LogDir);
 	}
+	if (var_name == "PacketCaptureDir") {
+		return (PacketCaptureDir);
+	}
 	if (var_name == "LogPrefix") {
 		return (LogPrefix);
 	}
@@ -351,9 +359,11 @@ void EQEmuConfig::Dump() const
 	std::cout << "QuestDir = " << QuestDir << std::endl;
 	std::cout << "PluginDir = " << PluginDir << std::endl;
 	std::cout << "LuaModuleDir = " << LuaModuleDir << std::endl;
+	std::cout << "LuaBytecodeDir = " << LuaBytecodeDir << std::endl;
 	std::cout << "PatchDir = " << PatchDir << std::endl;
 	std::cout << "SharedMemDir = " << SharedMemDir << std::endl;
 	std::cout << "LogDir = " << LogDir << std::endl;
+	std::cout << "PacketCaptureDir = " << PacketCaptureDir << std::endl;
 	std::cout << "ZonePortLow = " << ZonePortLow << std::endl;
 	std::cout << "ZonePortHigh = " << ZonePortHigh << std::endl;
 	std::cout << "DefaultStatus = " << (int) DefaultStatus << std::endl;
@@ -92,9 +92,11 @@ class EQEmuConfig
 		std::string QuestDir;
 		std::string PluginDir;
 		std::string LuaModuleDir;
+		std::string LuaBytecodeDir;
 		std::string PatchDir;
 		std::string SharedMemDir;
 		std::string LogDir;
+		std::string PacketCaptureDir;
 
 		// From <launcher/>
 		std::string LogPrefix;
@@ -25,6 +25,18 @@
 
 namespace EQ {
 
+	/*! Storage layouts a FixedMemoryHashSet can be built with.
+	    Offsets stores a key -> slot table in front of a packed element array and suits sparse keys.
+	    Dense stores every element at its own key with a presence bitmap, so lookups skip the
+	    offset table entirely; it only pays off when the keys are compact.
+	    Auto lets the builder pick based on key density.
+	*/
+	enum class FixedMemoryHashSetLayout : uint32 {
+		Auto = 0,
+		Offsets = 1,
+		Dense = 2
+	};
+
 	/*! Simple HashSet designed to be used in fixed memory that may be difficult to use an
 	allocator for (shared memory), we assume all keys are unsigned int
 	*/
@@ -43,10 +55,13 @@ namespace EQ {
 		\param size Raw data size
 		\param element_count Max number of possible unique elements that can be inserted.
 		\param max_element_id Number of offsets to store: eg highest "key" that will be used.
+		\param layout Storage layout to build, Auto picks one from the key density.
 		*/
-		FixedMemoryHashSet(byte *data, size_type size, key_type element_count, key_type max_element_id) {
+		FixedMemoryHashSet(byte *data, size_type size, key_type element_count, key_type max_element_id,
+			FixedMemoryHashSetLayout layout = FixedMemoryHashSetLayout::Auto) {
 			data_ = data;
 			size_ = size;
+			layout_ = resolve_layout(element_count, max_element_id, layout);
 
 			byte *ptr = data;
 			*reinterpret_cast<key_type*>(ptr) = max_element_id + 1;
@@ -61,9 +76,17 @@ namespace EQ {
 			current_elements_ = 0;
 			ptr += sizeof(key_type);
 
+			*reinterpret_cast<key_type*>(ptr) = static_cast<key_type>(layout_);
+			ptr += sizeof(key_type);
+
 			offsets_ = reinterpret_cast<key_type*>(ptr);
-			memset(ptr, 0xFFFFFFFFU, sizeof(key_type) * (max_element_id + 1));
-			ptr += sizeof(key_type) * (max_element_id + 1);
+			if(layout_ == FixedMemoryHashSetLayout::Dense) {
+				memset(ptr, 0, sizeof(key_type) * bitmap_words(offset_count_));
+				ptr += sizeof(key_type) * bitmap_words(offset_count_);
+			} else {
+				memset(ptr, 0xFFFFFFFFU, sizeof(key_type) * (max_element_id + 1));
+				ptr += sizeof(key_type) * (max_element_id + 1);
+			}
 
 			elements_ = reinterpret_cast<value_type*>(ptr);
 		}
@@ -89,8 +112,15 @@ namespace EQ {
 			current_elements_ = *reinterpret_cast<key_type*>(ptr);
 			ptr += sizeof(key_type);
 
+			layout_ = static_cast<FixedMemoryHashSetLayout>(*reinterpret_cast<key_type*>(ptr));
+			ptr += sizeof(key_type);
+
 			offsets_ = reinterpret_cast<key_type*>(ptr);
-			ptr += sizeof(key_type) * offset_count_;
+			if(layout_ == FixedMemoryHashSetLayout::Dense) {
+				ptr += sizeof(key_type) * bitmap_words(offset_count_);
+			} else {
+				ptr += sizeof(key_type) * offset_count_;
+			}
 
 			elements_ = reinterpret_cast<value_type*>(ptr);
 		}
@@ -99,6 +129,7 @@ namespace EQ {
 		FixedMemoryHashSet(const FixedMemoryHashSet& other) :
 			data_(other.data_),
 			size_(other.size_),
+			layout_(other.layout_),
 			offset_count_(other.offset_count_),
 			max_elements_(other.max_elements_),
 			current_elements_(other.current_elements_),
@@ -112,6 +143,7 @@ namespace EQ {
 		FixedMemoryHashSet(FixedMemoryHashSet&& other) :
 			data_(other.data_),
 			size_(other.size_),
+			layout_(other.layout_),
 			offset_count_(other.offset_count_),
 			max_elements_(other.max_elements_),
 			current_elements_(other.current_elements_),
@@ -129,6 +161,7 @@ namespace EQ {
 		const FixedMemoryHashSet& operator=(const FixedMemoryHashSet& other) {
 			data_ = other.data_;
 			size_ = other.size_;
+			layout_ = other.layout_;
 			offset_count_ = other.offset_count_;
 			max_elements_ = other.max_elements_;
 			current_elements_ = other.current_elements_;
@@ -157,20 +190,17 @@ namespace EQ {
 			return offset_count_ > 0 ? (offset_count_ - 1) : 0;
 		}
 
+		//! Returns the storage layout the set was built with.
+		FixedMemoryHashSetLayout layout() const {
+			return layout_;
+		}
+
 		/*!
 			Retrieve value operator
 		\param i Index to retrieve the value from
 		*/
 		reference operator[](const key_type& i) {
-			if(i >= offset_count_) {
-				EQ_EXCEPT("Fixed Memory Hash Set", "Index out of range");
-			}
-
-			if(offsets_[i] == 0xFFFFFFFFU) {
-				EQ_EXCEPT("Fixed Memory Hash Set", "Element not found.");
-			}
-
-			return elements_[offsets_[i]];
+			return at(i);
 		}
 
 		/*!
@@ -182,11 +212,25 @@ namespace EQ {
 				EQ_EXCEPT("Fixed Memory Hash Set", "Index out of range.");
 			}
 
-			if(offsets_[i] == 0xFFFFFFFFU) {
+			value_type *v = lookup(i);
+			if(!v) {
 				EQ_EXCEPT("Fixed Memory Hash Set", "Element not found.");
 			}
 
-			return elements_[offsets_[i]];
+			return *v;
+		}
+
+		/*!
+			Retrieve value function that does not throw, one probe for both the existence check and the fetch
+		\param i Index to retrieve the value from
+		\return Pointer to the value or nullptr if there is none
+		*/
+		value_type *find(const key_type& i) {
+			if(i >= offset_count_) {
+				return nullptr;
+			}
+
+			return lookup(i);
 		}
 
 		/*!
@@ -198,6 +242,10 @@ namespace EQ {
 				return false;
 			}
 
+			if(layout_ == FixedMemoryHashSetLayout::Dense) {
+				return bitmap_test(i);
+			}
+
 			if(offsets_[i] == 0xFFFFFFFFU) {
 				return false;
 			}
@@ -215,6 +263,23 @@ namespace EQ {
 				EQ_EXCEPT("Fixed Memory Hash Set", "Index out of range.");
 			}
 
+			if(layout_ == FixedMemoryHashSetLayout::Dense) {
+				if(bitmap_test(i)) {
+					elements_[i] = v;
+					return;
+				}
+
+				if(current_elements_ >= max_elements_) {
+					EQ_EXCEPT("Fixed Memory Hash Set", "Insert pointer out of range.");
+				}
+
+				memcpy(&elements_[i], &v, sizeof(value_type));
+				offsets_[i >> 5] |= (1U << (i & 31));
+				++current_elements_;
+				*reinterpret_cast<key_type*>(data_ + (sizeof(key_type) * 2)) = current_elements_;
+				return;
+			}
+
 			if(offsets_[i] != 0xFFFFFFFFU) {
 				elements_[offsets_[i]] = v;
 			} else {
@@ -229,20 +294,67 @@ namespace EQ {
 			}
 		}
 
+		/*!
+			Picks the layout the builder will use for a given key set. Dense only wins when the slots it
+			leaves empty cost less than the offset table it replaces, so wide elements such as items or
+			faction lists stay on Offsets unless their key range is almost completely filled.
+		*/
+		static FixedMemoryHashSetLayout resolve_layout(key_type element_count, key_type max_elements,
+			FixedMemoryHashSetLayout layout = FixedMemoryHashSetLayout::Auto) {
+			if(layout != FixedMemoryHashSetLayout::Auto) {
+				return layout;
+			}
+
+			size_type key_count = static_cast<size_type>(max_elements) + 1;
+			size_type wasted = key_count > element_count ? key_count - element_count : 0;
+			size_type dense_overhead = sizeof(T) * wasted + sizeof(key_type) * bitmap_words(key_count);
+			size_type offsets_overhead = sizeof(key_type) * key_count;
+			if(dense_overhead < offsets_overhead) {
+				return FixedMemoryHashSetLayout::Dense;
+			}
+
+			return FixedMemoryHashSetLayout::Offsets;
+		}
+
 		//! Calculates how much memory we should allocate based on element size and count
-		static size_type estimated_size(key_type element_count, key_type max_elements) {
-			size_type total_size = 3 * sizeof(key_type);
-			total_size += sizeof(key_type) * (max_elements + 1);
-			total_size += sizeof(T) * element_count;
+		static size_type estimated_size(key_type element_count, key_type max_elements,
+			FixedMemoryHashSetLayout layout = FixedMemoryHashSetLayout::Auto) {
+			size_type total_size = 4 * sizeof(key_type);
+			if(resolve_layout(element_count, max_elements, layout) == FixedMemoryHashSetLayout::Dense) {
+				total_size += sizeof(key_type) * bitmap_words(max_elements + 1);
+				total_size += sizeof(T) * (static_cast<size_type>(max_elements) + 1);
+			} else {
+				total_size += sizeof(key_type) * (max_elements + 1);
+				total_size += sizeof(T) * element_count;
+			}
 			return total_size;
 		}
 
 	private:
+		static size_type bitmap_words(size_type key_count) {
+			return (key_count + 31) / 32;
+		}
+
+		bool bitmap_test(const key_type& i) const {
+			return (offsets_[i >> 5] & (1U << (i & 31))) != 0;
+		}
+
+		value_type *lookup(const key_type& i) {
+			if(layout_ == FixedMemoryHashSetLayout::Dense) {
+				return bitmap_test(i) ? &elements_[i] : nullptr;
+			}
+
+			key_type offset = offsets_[i];
+			return offset != 0xFFFFFFFFU ? &elements_[offset] : nullptr;
+		}
+
 		unsigned char *data_;
 		size_type size_;
+		FixedMemoryHashSetLayout layout_;
 		key_type offset_count_;
 		key_type max_elements_;
 		key_type current_elements_;
+		//! Slot table for the Offsets layout, presence bitmap for the Dense layout
 		key_type *offsets_;
 		value_type *elements_;
 	};
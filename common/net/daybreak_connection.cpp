@@ -5,8 +5,22 @@
 #include "crc32.h"
 #include <zlib.h>
 #include <fmt/format.h>
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 
+//datagrams are read straight into one buffer owned by the manager. when libuv
+//can batch reads with recvmmsg the buffer holds that many datagrams.
+#if UV_VERSION_MAJOR > 1 || (UV_VERSION_MAJOR == 1 && UV_VERSION_MINOR >= 40)
+#define DAYBREAK_RECVMMSG
+#endif
+
+namespace
+{
+	const size_t RecvDatagramSize = 64 * 1024;
+	const size_t RecvBatchCount = 16;
+}
+
 EQ::Net::DaybreakConnectionManager::DaybreakConnectionManager()
 {
 	m_attached = nullptr;
@@ -46,7 +60,14 @@ void EQ::Net::DaybreakConnectionManager::Attach(uv_loop_t *loop)
 			c->ProcessResend();
 		}, update_rate, update_rate);
 
+#ifdef DAYBREAK_RECVMMSG
+		uv_udp_init_ex(loop, &m_socket, AF_INET | UV_UDP_RECVMMSG);
+		m_recv_buffer_size = uv_udp_using_recvmmsg(&m_socket) ? RecvDatagramSize * RecvBatchCount : RecvDatagramSize;
+#else
 		uv_udp_init(loop, &m_socket);
+		m_recv_buffer_size = RecvDatagramSize;
+#endif
+		m_recv_buffer.reset(new char[m_recv_buffer_size]);
 		m_socket.data = this;
 		struct sockaddr_in recv_addr;
 		uv_ip4_addr("0.0.0.0", m_options.port, &recv_addr);
@@ -54,22 +75,18 @@ void EQ::Net::DaybreakConnectionManager::Attach(uv_loop_t *loop)
 
 		rc = uv_udp_recv_start(&m_socket,
 			[](uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
-			buf->base = new char[suggested_size];
-			memset(buf->base, 0, suggested_size);
-			buf->len = suggested_size;
+			//libuv finishes with a read before it asks for the next buffer
+			DaybreakConnectionManager *c = (DaybreakConnectionManager*)handle->data;
+			buf->base = c->m_recv_buffer.get();
+			buf->len = c->m_recv_buffer_size;
 		},
 			[](uv_udp_t* handle, ssize_t nread, const uv_buf_t* buf, const struct sockaddr* addr, unsigned flags) {
 			DaybreakConnectionManager *c = (DaybreakConnectionManager*)handle->data;
-			if (nread < 0 || addr == nullptr) {
-				delete[] buf->base;
+			if (nread < 0 || addr == nullptr || addr->sa_family != AF_INET) {
 				return;
 			}
 
-			char endpoint[16];
-			uv_ip4_name((const sockaddr_in*)addr, endpoint, 16);
-			auto port = ntohs(((const sockaddr_in*)addr)->sin_port);
-			c->ProcessPacket(endpoint, port, buf->base, nread);
-			delete[] buf->base;
+			c->ProcessPacket(*(const sockaddr_in*)addr, buf->base, nread);
 		});
 
 		m_attached = loop;
@@ -96,7 +113,7 @@ void EQ::Net::DaybreakConnectionManager::Connect(const std::string &addr, int po
 		m_on_new_connection(connection);
 	}
 
-	m_connections.insert(std::make_pair(std::make_pair(addr, port), connection));
+	m_connections.insert(std::make_pair(EndpointKey(connection->m_remote_addr), connection));
 }
 
 void EQ::Net::DaybreakConnectionManager::Process()
@@ -203,7 +220,12 @@ void EQ::Net::DaybreakConnectionManager::ProcessResend()
 	}
 }
 
-void EQ::Net::DaybreakConnectionManager::ProcessPacket(const std::string &endpoint, int port, const char *data, size_t size)
+uint64_t EQ::Net::DaybreakConnectionManager::EndpointKey(const sockaddr_in &addr)
+{
+	return ((uint64_t)ntohl(addr.sin_addr.s_addr) << 16) | ntohs(addr.sin_port);
+}
+
+void EQ::Net::DaybreakConnectionManager::ProcessPacket(const sockaddr_in &addr, const char *data, size_t size)
 {
 	if (m_options.simulated_in_packet_loss && m_options.simulated_in_packet_loss >= m_rand.Int(0, 100)) {
 		return;
@@ -217,7 +239,7 @@ void EQ::Net::DaybreakConnectionManager::ProcessPacket(const std::string &endpoi
 	}
 
 	try {
-		auto connection = FindConnectionByEndpoint(endpoint, port);
+		auto connection = FindConnectionByEndpoint(addr);
 		if (connection) {
 			StaticPacket p((void*)data, size);
 			connection->ProcessPacket(p);
@@ -227,17 +249,19 @@ void EQ::Net::DaybreakConnectionManager::ProcessPacket(const std::string &endpoi
 				StaticPacket p((void*)data, size);
 				auto request = p.GetSerialize<DaybreakConnect>(0);
 
-				connection = std::shared_ptr<DaybreakConnection>(new DaybreakConnection(this, request, endpoint, port));
+				char endpoint[16];
+				uv_ip4_name(&addr, endpoint, 16);
+				connection = std::shared_ptr<DaybreakConnection>(new DaybreakConnection(this, request, endpoint, ntohs(addr.sin_port)));
 				connection->m_self = connection;
 
 				if (m_on_new_connection) {
 					m_on_new_connection(connection);
 				}
-				m_connections.insert(std::make_pair(std::make_pair(endpoint, port), connection));
+				m_connections.insert(std::make_pair(EndpointKey(addr), connection));
 				connection->ProcessPacket(p);
 			}
 			else if (data[1] != OP_OutOfSession) {
-				SendDisconnect(endpoint, port);
+				SendDisconnect(addr);
 			}
 		}
 	}
@@ -248,10 +272,9 @@ void EQ::Net::DaybreakConnectionManager::ProcessPacket(const std::string &endpoi
 	}
 }
 
-std::shared_ptr<EQ::Net::DaybreakConnection> EQ::Net::DaybreakConnectionManager::FindConnectionByEndpoint(std::string addr, int port)
+std::shared_ptr<EQ::Net::DaybreakConnection> EQ::Net::DaybreakConnectionManager::FindConnectionByEndpoint(const sockaddr_in &addr)
 {
-	auto p = std::make_pair(addr, port);
-	auto iter = m_connections.find(p);
+	auto iter = m_connections.find(EndpointKey(addr));
 	if (iter != m_connections.end()) {
 		return iter->second;
 	}
@@ -259,7 +282,7 @@ std::shared_ptr<EQ::Net::DaybreakConnection> EQ::Net::DaybreakConnectionManager:
 	return nullptr;
 }
 
-void EQ::Net::DaybreakConnectionManager::SendDisconnect(const std::string &addr, int port)
+void EQ::Net::DaybreakConnectionManager::SendDisconnect(const sockaddr_in &addr)
 {
 	DaybreakDisconnect header;
 	header.zero = 0;
@@ -270,15 +293,13 @@ void EQ::Net::DaybreakConnectionManager::SendDisconnect(const std::string &addr,
 	out.PutSerialize(0, header);
 
 	uv_udp_send_t *send_req = new uv_udp_send_t;
-	sockaddr_in send_addr;
-	uv_ip4_addr(addr.c_str(), port, &send_addr);
 	uv_buf_t send_buffers[1];
 
 	char *data = new char[out.Length()];
 	memcpy(data, out.Data(), out.Length());
 	send_buffers[0] = uv_buf_init(data, out.Length());
 	send_req->data = send_buffers[0].base;
-	int ret = uv_udp_send(send_req, &m_socket, send_buffers, 1, (sockaddr*)&send_addr,
+	int ret = uv_udp_send(send_req, &m_socket, send_buffers, 1, (const sockaddr*)&addr,
 		[](uv_udp_send_t* req, int status) {
 		delete[](char*)req->data;
 		delete req;
@@ -294,6 +315,7 @@ EQ::Net::DaybreakConnection::DaybreakConnection(DaybreakConnectionManager *owner
 	m_status = StatusConnected;
 	m_endpoint = endpoint;
 	m_port = port;
+	uv_ip4_addr(endpoint.c_str(), port, &m_remote_addr);
 	m_connect_code = NetworkToHost(connect.connect_code);
 	m_encode_key = m_owner->m_rand.Int(std::numeric_limits<uint32_t>::min(), std::numeric_limits<uint32_t>::max());
 	m_max_packet_size = (uint32_t)std::min(owner->m_options.max_packet_size, (size_t)NetworkToHost(connect.max_packet_size));
@@ -308,6 +330,14 @@ EQ::Net::DaybreakConnection::DaybreakConnection(DaybreakConnectionManager *owner
 	m_combined[1] = OP_Combined;
 	m_last_session_stats = Clock::now();
 	m_outgoing_budget = owner->m_options.outgoing_data_rate;
+	m_cwnd = owner->m_options.congestion_window_initial;
+	m_ssthresh = owner->m_options.congestion_window_max;
+	m_bytes_in_flight = 0;
+	m_srtt = 0.0;
+	m_rttvar = 0.0;
+	m_pacing_tokens = (double)m_cwnd;
+	m_pacing_refill = Clock::now();
+	m_recovery_until = Clock::now();
 }
 
 //new connection made as client
@@ -319,6 +349,7 @@ EQ::Net::DaybreakConnection::DaybreakConnection(DaybreakConnectionManager *owner
 	m_status = StatusConnecting;
 	m_endpoint = endpoint;
 	m_port = port;
+	uv_ip4_addr(endpoint.c_str(), port, &m_remote_addr);
 	m_connect_code = m_owner->m_rand.Int(std::numeric_limits<uint32_t>::min(), std::numeric_limits<uint32_t>::max());
 	m_encode_key = 0;
 	m_max_packet_size = (uint32_t)owner->m_options.max_packet_size;
@@ -331,6 +362,14 @@ EQ::Net::DaybreakConnection::DaybreakConnection(DaybreakConnectionManager *owner
 	m_combined[1] = OP_Combined;
 	m_last_session_stats = Clock::now();
 	m_outgoing_budget = owner->m_options.outgoing_data_rate;
+	m_cwnd = owner->m_options.congestion_window_initial;
+	m_ssthresh = owner->m_options.congestion_window_max;
+	m_bytes_in_flight = 0;
+	m_srtt = 0.0;
+	m_rttvar = 0.0;
+	m_pacing_tokens = (double)m_cwnd;
+	m_pacing_refill = Clock::now();
+	m_recovery_until = Clock::now();
 }
 
 EQ::Net::DaybreakConnection::~DaybreakConnection()
@@ -379,6 +418,10 @@ EQ::Net::DaybreakConnectionStats EQ::Net::DaybreakConnection::GetStats()
 	EQ::Net::DaybreakConnectionStats ret = m_stats;
 	ret.datarate_remaining = m_outgoing_budget;
 	ret.avg_ping = m_rolling_ping;
+	ret.congestion_window = m_cwnd;
+	ret.bytes_in_flight = m_bytes_in_flight;
+	ret.smoothed_rtt = (uint64_t)m_srtt;
+	ret.pacing_rate = PacingRate() * 1000.0 / 1024.0;
 
 	return ret;
 }
@@ -398,6 +441,7 @@ void EQ::Net::DaybreakConnection::Process()
 		}
 
 		ProcessQueue();
+		SendPending();
 	}
 	catch (std::exception &ex) {
 		if (m_owner->m_on_error_message) {
@@ -492,15 +536,15 @@ void EQ::Net::DaybreakConnection::ProcessQueue()
 		auto stream = &m_streams[i];
 		for (;;) {
 
-			auto iter = stream->packet_queue.find(stream->sequence_in);
-			if (iter == stream->packet_queue.end()) {
+			auto queued = stream->packet_queue.Find(stream->sequence_in);
+			if (!queued) {
 				break;
 			}
 
-			auto packet = iter->second;
-			stream->packet_queue.erase(iter);
-			ProcessDecodedPacket(*packet);
-			delete packet;
+			//processing may queue more packets on this stream, so take it out first
+			DynamicPacket packet(std::move(*queued));
+			stream->packet_queue.Erase(stream->sequence_in);
+			ProcessDecodedPacket(packet);
 		}
 	}
 }
@@ -508,23 +552,16 @@ void EQ::Net::DaybreakConnection::ProcessQueue()
 void EQ::Net::DaybreakConnection::RemoveFromQueue(int stream, uint16_t seq)
 {
 	auto s = &m_streams[stream];
-	auto iter = s->packet_queue.find(seq);
-	if (iter != s->packet_queue.end()) {
-		auto packet = iter->second;
-		s->packet_queue.erase(iter);
-		delete packet;
-	}
+	s->packet_queue.Erase(seq);
 }
 
 void EQ::Net::DaybreakConnection::AddToQueue(int stream, uint16_t seq, const Packet &p)
 {
 	auto s = &m_streams[stream];
-	auto iter = s->packet_queue.find(seq);
-	if (iter == s->packet_queue.end()) {
-		DynamicPacket *out = new DynamicPacket();
-		out->PutPacket(0, p);
-
-		s->packet_queue.insert(std::make_pair(seq, out));
+	if (!s->packet_queue.Find(seq)) {
+		auto &out = s->packet_queue.Insert(seq);
+		out.Clear();
+		out.PutPacket(0, p);
 	}
 }
 
@@ -950,73 +987,105 @@ void EQ::Net::DaybreakConnection::Encode(Packet &p, size_t offset, size_t length
 	}
 }
 
-uint32_t Inflate(const uint8_t* in, uint32_t in_len, uint8_t* out, uint32_t out_len) {
-	if (!in) {
-		return 0;
+//every connection of a manager runs on its loop's thread, so one deflate and one
+//inflate stream per thread is set up once and reset between packets
+struct ZlibContexts
+{
+	ZlibContexts() : deflate_ready(false), deflate_level(0), inflate_ready(false) { }
+	~ZlibContexts() {
+		if (deflate_ready) {
+			deflateEnd(&deflate_stream);
+		}
+
+		if (inflate_ready) {
+			inflateEnd(&inflate_stream);
+		}
 	}
 
-	z_stream zstream;
-	memset(&zstream, 0, sizeof(zstream));
-	int zerror = 0;
-	int i;
+	z_stream *Deflater(int level) {
+		if (!deflate_ready) {
+			memset(&deflate_stream, 0, sizeof(deflate_stream));
+			if (deflateInit(&deflate_stream, level) != Z_OK) {
+				return nullptr;
+			}
 
-	zstream.next_in = const_cast<unsigned char *>(in);
-	zstream.avail_in = in_len;
-	zstream.next_out = out;
-	zstream.avail_out = out_len;
-	zstream.opaque = Z_NULL;
+			deflate_ready = true;
+			deflate_level = level;
+		}
+		else if (deflate_level != level) {
+			deflateReset(&deflate_stream);
+			if (deflateParams(&deflate_stream, level, Z_DEFAULT_STRATEGY) != Z_OK) {
+				return nullptr;
+			}
 
-	i = inflateInit2(&zstream, 15);
+			deflate_level = level;
+		}
 
-	if (i != Z_OK) {
-		return 0;
+		return &deflate_stream;
 	}
 
-	zerror = inflate(&zstream, Z_FINISH);
+	z_stream *Inflater() {
+		if (!inflate_ready) {
+			memset(&inflate_stream, 0, sizeof(inflate_stream));
+			if (inflateInit2(&inflate_stream, 15) != Z_OK) {
+				return nullptr;
+			}
 
-	if (zerror == Z_STREAM_END) {
-		inflateEnd(&zstream);
-		return zstream.total_out;
-	}
-	else {
-		if (zerror == Z_MEM_ERROR && !zstream.msg)
-		{
-			return 0;
+			inflate_ready = true;
 		}
 
-		zerror = inflateEnd(&zstream);
-		return 0;
+		return &inflate_stream;
 	}
-}
 
-uint32_t Deflate(const uint8_t* in, uint32_t in_len, uint8_t* out, uint32_t out_len) {
-	if (!in) {
+	z_stream deflate_stream;
+	bool deflate_ready;
+	int deflate_level;
+	z_stream inflate_stream;
+	bool inflate_ready;
+};
+
+static thread_local ZlibContexts zlib_contexts;
+
+uint32_t Inflate(z_stream *zstream, const uint8_t* in, uint32_t in_len, uint8_t* out, uint32_t out_len) {
+	if (!in || !zstream) {
 		return 0;
 	}
 
-	z_stream zstream;
-	memset(&zstream, 0, sizeof(zstream));
-	int zerror;
+	if (inflateReset(zstream) != Z_OK) {
+		return 0;
+	}
 
-	zstream.next_in = const_cast<unsigned char *>(in);
-	zstream.avail_in = in_len;
-	zstream.opaque = Z_NULL;
+	zstream->next_in = const_cast<unsigned char *>(in);
+	zstream->avail_in = in_len;
+	zstream->next_out = out;
+	zstream->avail_out = out_len;
 
-	deflateInit(&zstream, Z_BEST_SPEED);
-	zstream.next_out = out;
-	zstream.avail_out = out_len;
+	if (inflate(zstream, Z_FINISH) == Z_STREAM_END) {
+		return zstream->total_out;
+	}
 
-	zerror = deflate(&zstream, Z_FINISH);
+	return 0;
+}
 
-	if (zerror == Z_STREAM_END)
-	{
-		deflateEnd(&zstream);
-		return zstream.total_out;
+uint32_t Deflate(z_stream *zstream, const uint8_t* in, uint32_t in_len, uint8_t* out, uint32_t out_len) {
+	if (!in || !zstream) {
+		return 0;
 	}
-	else {
-		zerror = deflateEnd(&zstream);
+
+	if (deflateReset(zstream) != Z_OK) {
 		return 0;
 	}
+
+	zstream->next_in = const_cast<unsigned char *>(in);
+	zstream->avail_in = in_len;
+	zstream->next_out = out;
+	zstream->avail_out = out_len;
+
+	if (deflate(zstream, Z_FINISH) == Z_STREAM_END) {
+		return zstream->total_out;
+	}
+
+	return 0;
 }
 
 void EQ::Net::DaybreakConnection::Decompress(Packet &p, size_t offset, size_t length)
@@ -1025,12 +1094,12 @@ void EQ::Net::DaybreakConnection::Decompress(Packet &p, size_t offset, size_t le
 		return;
 	}
 
-	static uint8_t new_buffer[4096];
+	static thread_local uint8_t new_buffer[4096];
 	uint8_t *buffer = (uint8_t*)p.Data() + offset;
 	uint32_t new_length = 0;
 
 	if (buffer[0] == 0x5a) {
-		new_length = Inflate(buffer + 1, (uint32_t)length - 1, new_buffer, 4096);
+		new_length = Inflate(zlib_contexts.Inflater(), buffer + 1, (uint32_t)length - 1, new_buffer, 4096);
 	}
 	else if (buffer[0] == 0xa5) {
 		memcpy(new_buffer, buffer + 1, length - 1);
@@ -1044,17 +1113,23 @@ void EQ::Net::DaybreakConnection::Decompress(Packet &p, size_t offset, size_t le
 	p.PutData(offset, new_buffer, new_length);
 }
 
+bool EQ::Net::DaybreakConnection::PacketShouldBeCompressed(size_t length) const
+{
+	return length > m_owner->m_options.compression_min_size;
+}
+
 void EQ::Net::DaybreakConnection::Compress(Packet &p, size_t offset, size_t length)
 {
-	uint8_t new_buffer[2048] = { 0 };
+	uint8_t new_buffer[2048];
 	uint8_t *buffer = (uint8_t*)p.Data() + offset;
 	uint32_t new_length = 0;
 	bool send_uncompressed = true;
 
-	if (length > 30) {
-		new_length = Deflate(buffer, (uint32_t)length, new_buffer + 1, 2048) + 1;
+	if (PacketShouldBeCompressed(length)) {
+		new_length = Deflate(zlib_contexts.Deflater(m_owner->m_options.compression_level), buffer, (uint32_t)length, new_buffer + 1, 2047);
 		new_buffer[0] = 0x5a;
-		send_uncompressed = (new_length > length);
+		send_uncompressed = (new_length == 0 || new_length + 1 > length);
+		new_length += 1;
 	}
 	if (send_uncompressed) {
 		memcpy(new_buffer + 1, buffer, length);
@@ -1078,107 +1153,293 @@ void EQ::Net::DaybreakConnection::ProcessResend(int stream)
 	if (m_status == DbProtocolStatus::StatusDisconnected) {
 		return;
 	}
-	
-	auto resends = 0;
+
 	auto now = Clock::now();
 	auto s = &m_streams[stream];
-	for (auto &entry : s->sent_packets) {
-		auto time_since_last_send = std::chrono::duration_cast<std::chrono::milliseconds>(now - entry.second.last_sent);
-		if (entry.second.times_resent == 0) {
-			if ((size_t)time_since_last_send.count() > entry.second.resend_delay) {
-				auto &p = entry.second.packet;
-				if (p.Length() >= DaybreakHeader::size()) {
-					if (p.GetInt8(0) == 0 && p.GetInt8(1) >= OP_Fragment && p.GetInt8(1) <= OP_Fragment4) {
-						m_stats.resent_fragments++;
-					}
-					else {
-						m_stats.resent_full++;
-					}
-				}
-				else {
-					m_stats.resent_full++;
-				}
-				m_stats.resent_packets++;
 
-				InternalBufferedSend(p);
-				entry.second.last_sent = now;
-				entry.second.times_resent++;
-				entry.second.resend_delay = EQ::Clamp(entry.second.resend_delay * 2, m_owner->m_options.resend_delay_min, m_owner->m_options.resend_delay_max);
-				resends++;
-			}
+	//the oldest unacked packet is the first one to hit the timeout
+	auto first = s->sent_packets.Find(s->sent_first);
+	if (first && first->times_resent > 0) {
+		auto time_since_first_sent = std::chrono::duration_cast<std::chrono::milliseconds>(now - first->first_sent);
+		if (time_since_first_sent.count() >= m_owner->m_options.resend_timeout) {
+			Close();
+			return;
 		}
-		else {
-			auto time_since_first_sent = std::chrono::duration_cast<std::chrono::milliseconds>(now - entry.second.first_sent);
+	}
+
+	while (!s->resend_queue.empty() && s->resend_queue.front().resend_at <= now) {
+		auto next = s->resend_queue.front();
+		std::pop_heap(s->resend_queue.begin(), s->resend_queue.end(), std::greater<DaybreakResend>());
+		s->resend_queue.pop_back();
+
+		auto sent = s->sent_packets.Find(next.sequence);
+		if (!sent || sent->resend_at != next.resend_at) {
+			continue;
+		}
+
+		if (sent->times_resent > 0) {
+			auto time_since_first_sent = std::chrono::duration_cast<std::chrono::milliseconds>(now - sent->first_sent);
 			if (time_since_first_sent.count() >= m_owner->m_options.resend_timeout) {
 				Close();
 				return;
 			}
-	
-			if ((size_t)time_since_last_send.count() > entry.second.resend_delay) {
-				auto &p = entry.second.packet;
-				if (p.Length() >= DaybreakHeader::size()) {
-					if (p.GetInt8(0) == 0 && p.GetInt8(1) >= OP_Fragment && p.GetInt8(1) <= OP_Fragment4) {
-						m_stats.resent_fragments++;
-					}
-					else {
-						m_stats.resent_full++;
-					}
-				}
-				else {
-					m_stats.resent_full++;
-				}
-				m_stats.resent_packets++;
+		}
 
-				InternalBufferedSend(p);
-				entry.second.last_sent = now;
-				entry.second.times_resent++;
-				entry.second.resend_delay = EQ::Clamp(entry.second.resend_delay * 2, m_owner->m_options.resend_delay_min, m_owner->m_options.resend_delay_max);
-				resends++;
-			}
+		if (CongestionControlled()) {
+			OnCongestionLoss(now);
 		}
+
+		Resend(*sent, now);
+		ScheduleResend(*s, next.sequence, *sent);
 	}
 }
 
-void EQ::Net::DaybreakConnection::Ack(int stream, uint16_t seq)
+void EQ::Net::DaybreakConnection::Resend(DaybreakSentPacket &sent, Timestamp now)
+{
+	auto &p = sent.packet;
+	if (p.Length() >= DaybreakHeader::size()) {
+		if (p.GetInt8(0) == 0 && p.GetInt8(1) >= OP_Fragment && p.GetInt8(1) <= OP_Fragment4) {
+			m_stats.resent_fragments++;
+		}
+		else {
+			m_stats.resent_full++;
+		}
+	}
+	else {
+		m_stats.resent_full++;
+	}
+	m_stats.resent_packets++;
+
+	InternalBufferedSend(p);
+	sent.last_sent = now;
+	sent.times_resent++;
+	sent.resend_delay = EQ::Clamp(sent.resend_delay * 2, m_owner->m_options.resend_delay_min, m_owner->m_options.resend_delay_max);
+}
+
+void EQ::Net::DaybreakConnection::TrackSent(int stream_id, const Packet &p)
 {
+	auto stream = &m_streams[stream_id];
 
+	auto &sent = stream->sent_packets.Insert(stream->sequence_out);
+	sent.packet.Clear();
+	sent.packet.PutPacket(0, p);
+	sent.times_resent = 0;
+	sent.in_flight = false;
+
+	auto seq = stream->sequence_out++;
+	if (CongestionControlled()) {
+		stream->pending.push_back(seq);
+		SendPending();
+	}
+	else {
+		TransmitSent(*stream, seq, sent);
+	}
+}
+
+void EQ::Net::DaybreakConnection::TransmitSent(DaybreakStream &stream, uint16_t seq, DaybreakSentPacket &sent)
+{
 	auto now = Clock::now();
-	auto s = &m_streams[stream];
-	auto iter = s->sent_packets.begin();
-	while (iter != s->sent_packets.end()) {
-		auto order = CompareSequence(seq, iter->first);
+	sent.last_sent = now;
+	sent.first_sent = now;
+	sent.resend_delay = ResendDelay();
+	sent.in_flight = true;
+	m_bytes_in_flight += sent.packet.Length();
+
+	ScheduleResend(stream, seq, sent);
+	InternalBufferedSend(sent.packet);
+}
+
+void EQ::Net::DaybreakConnection::SendPending()
+{
+	if (!CongestionControlled()) {
+		return;
+	}
+
+	auto now = Clock::now();
+
+	//lower streams go first and a blocked stream holds back the ones after it
+	for (int i = 0; i < 4; ++i) {
+		auto &stream = m_streams[i];
+		while (!stream.pending.empty()) {
+			auto seq = stream.pending.front();
+			auto sent = stream.sent_packets.Find(seq);
+			if (!sent || sent->in_flight) {
+				stream.pending.pop_front();
+				continue;
+			}
+
+			//with nothing in flight one packet always goes out so the window can't stall
+			if (m_bytes_in_flight > 0 && (m_bytes_in_flight + sent->packet.Length() > m_cwnd || !RefillPacing(now))) {
+				return;
+			}
+
+			stream.pending.pop_front();
+			TransmitSent(stream, seq, *sent);
+		}
+	}
+}
+
+bool EQ::Net::DaybreakConnection::CongestionControlled() const
+{
+	return m_owner->m_options.congestion_control;
+}
+
+//bytes per millisecond
+double EQ::Net::DaybreakConnection::PacingRate() const
+{
+	auto rtt = m_srtt > 0.0 ? m_srtt : (double)m_rolling_ping;
+	auto rate = m_owner->m_options.pacing_gain * (double)m_cwnd / std::max(rtt, 1.0);
+
+	auto outgoing_data_rate = m_owner->m_options.outgoing_data_rate;
+	if (outgoing_data_rate > 0.0) {
+		rate = std::min(rate, outgoing_data_rate * 1024.0 / 1000.0);
+	}
 
-		if (order != SequenceFuture) {
-			uint64_t round_time = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - iter->second.last_sent).count();
+	return rate;
+}
 
-			m_stats.max_ping = std::max(m_stats.max_ping, round_time);
-			m_stats.min_ping = std::min(m_stats.min_ping, round_time);
-			m_stats.last_ping = round_time;
-			m_rolling_ping = (m_rolling_ping * 2 + round_time) / 3;
+bool EQ::Net::DaybreakConnection::RefillPacing(Timestamp now)
+{
+	auto elapsed = std::chrono::duration<double, std::milli>(now - m_pacing_refill).count();
+	m_pacing_refill = now;
 
-			iter = s->sent_packets.erase(iter);
+	auto burst = (double)std::max((size_t)m_max_packet_size * 4, m_cwnd / 4);
+	m_pacing_tokens = std::min(burst, m_pacing_tokens + PacingRate() * elapsed);
+	return m_pacing_tokens > 0.0;
+}
+
+void EQ::Net::DaybreakConnection::OnCongestionAck(const DaybreakSentPacket &sent, Timestamp now)
+{
+	//resent packets give ambiguous samples
+	if (sent.times_resent == 0) {
+		auto sample = std::max(std::chrono::duration<double, std::milli>(now - sent.last_sent).count(), 1.0);
+		if (m_srtt == 0.0) {
+			m_srtt = sample;
+			m_rttvar = sample / 2.0;
 		}
 		else {
-			++iter;
+			m_rttvar = 0.75 * m_rttvar + 0.25 * std::fabs(m_srtt - sample);
+			m_srtt = 0.875 * m_srtt + 0.125 * sample;
 		}
 	}
+
+	//only grow a window that is actually being used
+	auto bytes = sent.packet.Length();
+	if (m_bytes_in_flight + bytes < m_cwnd / 2) {
+		return;
+	}
+
+	if (m_cwnd < m_ssthresh) {
+		m_cwnd += bytes;
+	}
+	else {
+		m_cwnd += std::max((size_t)1, (size_t)m_max_packet_size * bytes / m_cwnd);
+	}
+
+	m_cwnd = std::min(m_cwnd, m_owner->m_options.congestion_window_max);
 }
 
-void EQ::Net::DaybreakConnection::OutOfOrderAck(int stream, uint16_t seq)
+void EQ::Net::DaybreakConnection::OnCongestionLoss(Timestamp now)
 {
-	auto now = Clock::now();
-	auto s = &m_streams[stream];
-	auto iter = s->sent_packets.find(seq);
-	if (iter != s->sent_packets.end()) {
-		uint64_t round_time = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - iter->second.last_sent).count();
+	//one cut per round trip however many packets of that window were lost
+	if (now < m_recovery_until) {
+		return;
+	}
+
+	m_ssthresh = std::max(m_cwnd / 2, (size_t)m_max_packet_size * 2);
+	m_cwnd = m_ssthresh;
+
+	auto rtt = m_srtt > 0.0 ? m_srtt : (double)m_rolling_ping;
+	m_recovery_until = now + std::chrono::milliseconds((int64_t)rtt);
+}
+
+size_t EQ::Net::DaybreakConnection::ResendDelay() const
+{
+	auto &opts = m_owner->m_options;
+	if (CongestionControlled() && m_srtt > 0.0) {
+		return EQ::Clamp(
+			static_cast<size_t>(m_srtt + std::max(4.0 * m_rttvar, (double)opts.resend_delay_ms)),
+			opts.resend_delay_min,
+			opts.resend_delay_max);
+	}
+
+	return EQ::Clamp(
+		static_cast<size_t>((m_rolling_ping * opts.resend_delay_factor) + opts.resend_delay_ms),
+		opts.resend_delay_min,
+		opts.resend_delay_max);
+}
+
+void EQ::Net::DaybreakConnection::ScheduleResend(DaybreakStream &stream, uint16_t seq, DaybreakSentPacket &sent)
+{
+	//resent once more than resend_delay whole milliseconds have passed since the last send
+	sent.resend_at = sent.last_sent + std::chrono::milliseconds(sent.resend_delay + 1);
+
+	auto &queue = stream.resend_queue;
+	queue.push_back({ sent.resend_at, seq });
+	std::push_heap(queue.begin(), queue.end(), std::greater<DaybreakResend>());
+
+	//acked packets leave their entries behind until they surface
+	if (queue.size() > 64 && queue.size() > stream.sent_packets.Size() * 2) {
+		queue.clear();
+		stream.sent_packets.ForEach([&queue](uint16_t sequence, DaybreakSentPacket &entry) {
+			queue.push_back({ entry.resend_at, sequence });
+		});
+		std::make_heap(queue.begin(), queue.end(), std::greater<DaybreakResend>());
+	}
+}
+
+void EQ::Net::DaybreakConnection::AckSent(DaybreakStream &stream, uint16_t seq, Timestamp now)
+{
+	auto sent = stream.sent_packets.Find(seq);
+	if (sent && !sent->in_flight) {
+		stream.sent_packets.Erase(seq);
+	}
+	else if (sent) {
+		m_bytes_in_flight -= std::min(m_bytes_in_flight, sent->packet.Length());
+		if (CongestionControlled()) {
+			OnCongestionAck(*sent, now);
+		}
+
+		uint64_t round_time = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - sent->last_sent).count();
 
 		m_stats.max_ping = std::max(m_stats.max_ping, round_time);
 		m_stats.min_ping = std::min(m_stats.min_ping, round_time);
 		m_stats.last_ping = round_time;
 		m_rolling_ping = (m_rolling_ping * 2 + round_time) / 3;
 
-		s->sent_packets.erase(iter);
+		stream.sent_packets.Erase(seq);
+	}
+}
+
+void EQ::Net::DaybreakConnection::Ack(int stream, uint16_t seq)
+{
+	auto now = Clock::now();
+	auto s = &m_streams[stream];
+	while (s->sent_first != s->sequence_out) {
+		if (CompareSequence(seq, s->sent_first) != SequenceFuture) {
+			AckSent(*s, s->sent_first, now);
+		}
+		else if (s->sent_packets.Find(s->sent_first)) {
+			break;
+		}
+
+		s->sent_first++;
+	}
+
+	SendPending();
+}
+
+void EQ::Net::DaybreakConnection::OutOfOrderAck(int stream, uint16_t seq)
+{
+	auto now = Clock::now();
+	auto s = &m_streams[stream];
+	AckSent(*s, seq, now);
+
+	while (s->sent_first != s->sequence_out && !s->sent_packets.Find(s->sent_first)) {
+		s->sent_first++;
 	}
+
+	SendPending();
 }
 
 void EQ::Net::DaybreakConnection::UpdateDataBudget(double budget_add)
@@ -1277,7 +1538,10 @@ void EQ::Net::DaybreakConnection::SendKeepAlive()
 
 void EQ::Net::DaybreakConnection::InternalSend(Packet &p)
 {
-	if (m_owner->m_options.outgoing_data_rate > 0.0) {
+	if (CongestionControlled()) {
+		m_pacing_tokens -= (double)p.Length();
+	}
+	else if (m_owner->m_options.outgoing_data_rate > 0.0) {
 		auto new_budget = m_outgoing_budget - (p.Length() / 1024.0);
 		if (new_budget <= 0.0) {
 			m_stats.dropped_datarate_packets++;
@@ -1325,8 +1589,6 @@ void EQ::Net::DaybreakConnection::InternalSend(Packet &p)
 
 		uv_udp_send_t *send_req = new uv_udp_send_t;
 		memset(send_req, 0, sizeof(*send_req));
-		sockaddr_in send_addr;
-		uv_ip4_addr(m_endpoint.c_str(), m_port, &send_addr);
 		uv_buf_t send_buffers[1];
 
 		char *data = new char[out.Length()];
@@ -1342,15 +1604,13 @@ void EQ::Net::DaybreakConnection::InternalSend(Packet &p)
 			return;
 		}
 
-		uv_udp_send(send_req, &m_owner->m_socket, send_buffers, 1, (sockaddr*)&send_addr, send_func);
+		uv_udp_send(send_req, &m_owner->m_socket, send_buffers, 1, (const sockaddr*)&m_remote_addr, send_func);
 		return;
 	}
 
 	m_stats.bytes_before_encode += p.Length();
 
 	uv_udp_send_t *send_req = new uv_udp_send_t;
-	sockaddr_in send_addr;
-	uv_ip4_addr(m_endpoint.c_str(), m_port, &send_addr);
 	uv_buf_t send_buffers[1];
 
 	char *data = new char[p.Length()];
@@ -1367,7 +1627,7 @@ void EQ::Net::DaybreakConnection::InternalSend(Packet &p)
 		return;
 	}
 
-	uv_udp_send(send_req, &m_owner->m_socket, send_buffers, 1, (sockaddr*)&send_addr, send_func);
+	uv_udp_send(send_req, &m_owner->m_socket, send_buffers, 1, (const sockaddr*)&m_remote_addr, send_func);
 }
 
 void EQ::Net::DaybreakConnection::InternalQueuePacket(Packet &p, int stream_id, bool reliable)
@@ -1379,6 +1639,19 @@ void EQ::Net::DaybreakConnection::InternalQueuePacket(Packet &p, int stream_id,
 			return;
 		}
 
+		//when constrained reliable data goes first, a dropped update is superseded by the next one anyway
+		if (CongestionControlled()) {
+			bool backlog = false;
+			for (auto &stream : m_streams) {
+				backlog = backlog || !stream.pending.empty();
+			}
+
+			if (backlog || !RefillPacing(Clock::now())) {
+				m_stats.dropped_datarate_packets++;
+				return;
+			}
+		}
+
 		InternalBufferedSend(p);
 		return;
 	}
@@ -1400,19 +1673,7 @@ void EQ::Net::DaybreakConnection::InternalQueuePacket(Packet &p, int stream_id,
 		first_packet.PutData(DaybreakReliableFragmentHeader::size(), (char*)p.Data() + used, sublen);
 		used += sublen;
 
-		DaybreakSentPacket sent;
-		sent.packet.PutPacket(0, first_packet);
-		sent.last_sent = Clock::now();
-		sent.first_sent = Clock::now();
-		sent.times_resent = 0;
-		sent.resend_delay = EQ::Clamp(
-			static_cast<size_t>((m_rolling_ping * m_owner->m_options.resend_delay_factor) + m_owner->m_options.resend_delay_ms), 
-			m_owner->m_options.resend_delay_min, 
-			m_owner->m_options.resend_delay_max);
-		stream->sent_packets.insert(std::make_pair(stream->sequence_out, sent));
-		stream->sequence_out++;
-
-		InternalBufferedSend(first_packet);
+		TrackSent(stream_id, first_packet);
 
 		while (used < length) {
 			auto left = length - used;
@@ -1432,19 +1693,7 @@ void EQ::Net::DaybreakConnection::InternalQueuePacket(Packet &p, int stream_id,
 				used += left;
 			}
 
-			DaybreakSentPacket sent;
-			sent.packet.PutPacket(0, packet);
-			sent.last_sent = Clock::now();
-			sent.first_sent = Clock::now();
-			sent.times_resent = 0;
-			sent.resend_delay = EQ::Clamp(
-				static_cast<size_t>((m_rolling_ping * m_owner->m_options.resend_delay_factor) + m_owner->m_options.resend_delay_ms),
-				m_owner->m_options.resend_delay_min,
-				m_owner->m_options.resend_delay_max);
-			stream->sent_packets.insert(std::make_pair(stream->sequence_out, sent));
-			stream->sequence_out++;
-
-			InternalBufferedSend(packet);
+			TrackSent(stream_id, packet);
 		}
 	}
 	else {
@@ -1456,19 +1705,7 @@ void EQ::Net::DaybreakConnection::InternalQueuePacket(Packet &p, int stream_id,
 		packet.PutSerialize(0, header);
 		packet.PutPacket(DaybreakReliableHeader::size(), p);
 
-		DaybreakSentPacket sent;
-		sent.packet.PutPacket(0, packet);
-		sent.last_sent = Clock::now();
-		sent.first_sent = Clock::now();
-		sent.times_resent = 0;
-		sent.resend_delay = EQ::Clamp(
-			static_cast<size_t>((m_rolling_ping * m_owner->m_options.resend_delay_factor) + m_owner->m_options.resend_delay_ms),
-			m_owner->m_options.resend_delay_min,
-			m_owner->m_options.resend_delay_max);
-		stream->sent_packets.insert(std::make_pair(stream->sequence_out, sent));
-		stream->sequence_out++;
-
-		InternalBufferedSend(packet);
+		TrackSent(stream_id, packet);
 	}
 }
 
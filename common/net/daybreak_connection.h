@@ -3,12 +3,15 @@
 #include "../random.h"
 #include "packet.h"
 #include "daybreak_structs.h"
+#include "sequence_buffer.h"
 #include <uv.h>
 #include <chrono>
 #include <functional>
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include <queue>
+#include <deque>
 #include <list>
 
 namespace EQ
@@ -93,6 +96,10 @@ namespace EQ
 				datarate_remaining = 0.0;
 				bytes_after_decode = 0;
 				bytes_before_encode = 0;
+				congestion_window = 0;
+				bytes_in_flight = 0;
+				smoothed_rtt = 0;
+				pacing_rate = 0.0;
 			}
 
 			void Reset() {
@@ -131,6 +138,10 @@ namespace EQ
 			double datarate_remaining;
 			uint64_t bytes_after_decode;
 			uint64_t bytes_before_encode;
+			uint64_t congestion_window;
+			uint64_t bytes_in_flight;
+			uint64_t smoothed_rtt;
+			double pacing_rate; //KB / sec
 		};
 
 		class DaybreakConnectionManager;
@@ -162,6 +173,7 @@ namespace EQ
 			DaybreakConnectionManager *m_owner;
 			std::string m_endpoint;
 			int m_port;
+			sockaddr_in m_remote_addr;
 			uint32_t m_connect_code;
 			uint32_t m_encode_key;
 			uint32_t m_max_packet_size;
@@ -181,13 +193,33 @@ namespace EQ
 			Timestamp m_close_time;
 			double m_outgoing_budget;
 
+			//adaptive congestion control, only used when the manager's congestion_control option is set
+			size_t m_cwnd;
+			size_t m_ssthresh;
+			size_t m_bytes_in_flight;
+			double m_srtt;
+			double m_rttvar;
+			double m_pacing_tokens;
+			Timestamp m_pacing_refill;
+			Timestamp m_recovery_until;
+
 			struct DaybreakSentPacket
 			{
 				DynamicPacket packet;
 				Timestamp last_sent;
 				Timestamp first_sent;
+				Timestamp resend_at;
 				size_t times_resent;
 				size_t resend_delay;
+				bool in_flight; //false while held back by the congestion window
+			};
+
+			struct DaybreakResend
+			{
+				Timestamp resend_at;
+				uint16_t sequence;
+
+				bool operator>(const DaybreakResend &o) const { return resend_at > o.resend_at; }
 			};
 
 			struct DaybreakStream
@@ -195,19 +227,27 @@ namespace EQ
 				DaybreakStream() {
 					sequence_in = 0;
 					sequence_out = 0;
+					sent_first = 0;
 					fragment_current_bytes = 0;
 					fragment_total_bytes = 0;
 				}
 
 				uint16_t sequence_in;
 				uint16_t sequence_out;
-				std::map<uint16_t, Packet*> packet_queue;
+				SequenceBuffer<DynamicPacket> packet_queue;
 
 				DynamicPacket fragment_packet;
 				uint32_t fragment_current_bytes;
 				uint32_t fragment_total_bytes;
 
-				std::map<uint16_t, DaybreakSentPacket> sent_packets;
+				//every unacked packet is in [sent_first, sequence_out) and sent_first is
+				//always either unacked or equal to sequence_out
+				uint16_t sent_first;
+				SequenceBuffer<DaybreakSentPacket> sent_packets;
+				//min heap on resend_at, entries whose packet was acked or resent since are skipped
+				std::vector<DaybreakResend> resend_queue;
+				//tracked packets waiting for room in the congestion window, in sequence order
+				std::deque<uint16_t> pending;
 			};
 
 			DaybreakStream m_streams[4];
@@ -223,12 +263,25 @@ namespace EQ
 			bool ValidateCRC(Packet &p);
 			void AppendCRC(Packet &p);
 			bool PacketCanBeEncoded(Packet &p) const;
+			bool PacketShouldBeCompressed(size_t length) const;
 			void Decode(Packet &p, size_t offset, size_t length);
 			void Encode(Packet &p, size_t offset, size_t length);
 			void Decompress(Packet &p, size_t offset, size_t length);
 			void Compress(Packet &p, size_t offset, size_t length);
 			void ProcessResend();
 			void ProcessResend(int stream);
+			void Resend(DaybreakSentPacket &sent, Timestamp now);
+			void TrackSent(int stream, const Packet &p);
+			void TransmitSent(DaybreakStream &stream, uint16_t seq, DaybreakSentPacket &sent);
+			void SendPending();
+			bool CongestionControlled() const;
+			bool RefillPacing(Timestamp now);
+			void OnCongestionAck(const DaybreakSentPacket &sent, Timestamp now);
+			void OnCongestionLoss(Timestamp now);
+			size_t ResendDelay() const;
+			double PacingRate() const;
+			void ScheduleResend(DaybreakStream &stream, uint16_t seq, DaybreakSentPacket &sent);
+			void AckSent(DaybreakStream &stream, uint16_t seq, Timestamp now);
 			void Ack(int stream, uint16_t seq);
 			void OutOfOrderAck(int stream, uint16_t seq);
 			void UpdateDataBudget(double budget_add);
@@ -272,6 +325,12 @@ namespace EQ
 				resend_timeout = 30000;
 				connection_close_time = 2000;
 				outgoing_data_rate = 0.0;
+				compression_level = 1; //Z_BEST_SPEED
+				compression_min_size = 30;
+				congestion_control = false;
+				congestion_window_initial = 8192;
+				congestion_window_max = 262144;
+				pacing_gain = 1.25;
 			}
 
 			size_t max_packet_size;
@@ -295,6 +354,12 @@ namespace EQ
 			DaybreakEncodeType encode_passes[2];
 			int port;
 			double outgoing_data_rate;
+			int compression_level;
+			size_t compression_min_size; //payloads this size or smaller are sent uncompressed
+			bool congestion_control; //AIMD window and paced sends instead of the fixed outgoing_data_rate budget
+			size_t congestion_window_initial;
+			size_t congestion_window_max;
+			double pacing_gain;
 		};
 
 		class DaybreakConnectionManager
@@ -327,11 +392,15 @@ namespace EQ
 			std::function<void(std::shared_ptr<DaybreakConnection>, DbProtocolStatus, DbProtocolStatus)> m_on_connection_state_change;
 			std::function<void(std::shared_ptr<DaybreakConnection>, const Packet&)> m_on_packet_recv;
 			std::function<void(const std::string&)> m_on_error_message;
-			std::map<std::pair<std::string, int>, std::shared_ptr<DaybreakConnection>> m_connections;
-
-			void ProcessPacket(const std::string &endpoint, int port, const char *data, size_t size);
-			std::shared_ptr<DaybreakConnection> FindConnectionByEndpoint(std::string addr, int port);
-			void SendDisconnect(const std::string &addr, int port);
+			//keyed by EndpointKey so the receive path never formats an address
+			std::unordered_map<uint64_t, std::shared_ptr<DaybreakConnection>> m_connections;
+			std::unique_ptr<char[]> m_recv_buffer;
+			size_t m_recv_buffer_size;
+
+			static uint64_t EndpointKey(const sockaddr_in &addr);
+			void ProcessPacket(const sockaddr_in &addr, const char *data, size_t size);
+			std::shared_ptr<DaybreakConnection> FindConnectionByEndpoint(const sockaddr_in &addr);
+			void SendDisconnect(const sockaddr_in &addr);
 
 			friend class DaybreakConnection;
 		};
@@ -1,5 +1,6 @@
 #include "eqstream.h"
 #include "../eqemu_logsys.h"
+#include <chrono>
 
 EQ::Net::EQStreamManager::EQStreamManager(const EQStreamManagerInterfaceOptions &options) : EQStreamManagerInterface(options), m_daybreak(options.daybreak_options)
 {
@@ -23,6 +24,16 @@ void EQ::Net::EQStreamManager::DaybreakNewConnection(std::shared_ptr<DaybreakCon
 {
 	std::shared_ptr<EQStream> stream(new EQStream(this, connection));
 	m_streams.insert(std::make_pair(connection, stream));
+
+	if (!m_options.capture_directory.empty()) {
+		auto &dir = m_options.capture_directory;
+		auto unix_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		auto path = fmt::format("{0}{1}{2}-{3}-{4}.eqcap", dir, dir.back() == '/' ? "" : "/", unix_ms, connection->RemoteEndpoint(), connection->RemotePort());
+		if (!stream->StartCapture(path)) {
+			LogF(Logs::General, Logs::Netcode, "Unable to open packet capture {0}", path);
+		}
+	}
+
 	if (m_on_new_connection) {
 		m_on_new_connection(stream);
 	}
@@ -47,9 +58,18 @@ void EQ::Net::EQStreamManager::DaybreakPacketRecv(std::shared_ptr<DaybreakConnec
 	auto iter = m_streams.find(connection);
 	if (iter != m_streams.end()) {
 		auto &stream = iter->second;
+		if (stream->m_capture) {
+			//the daybreak layer does not surface whether a client packet was sequenced, replay sends everything reliably
+			stream->m_capture->WritePacket(PacketCaptureInbound, p, true);
+		}
+
 		std::unique_ptr<EQ::Net::Packet> t(new EQ::Net::DynamicPacket());
 		t->PutPacket(0, p);
 		stream->m_packet_queue.push_back(std::move(t));
+
+		if (m_on_packet_recv) {
+			m_on_packet_recv(stream);
+		}
 	}
 }
 
@@ -87,6 +107,10 @@ void EQ::Net::EQStream::QueuePacket(const EQApplicationPacket *p, bool ack_req)
 			break;
 		}
 
+		if (m_capture) {
+			m_capture->WritePacket(PacketCaptureOutbound, out, ack_req);
+		}
+
 		if (ack_req) {
 			m_connection->QueuePacket(out);
 		}
@@ -209,6 +233,35 @@ EQStreamInterface::MatchState EQ::Net::EQStream::CheckSignature(const Signature
 	return MatchNotReady;
 }
 
+EQStreamInterface::MatchState EQ::Net::EQStream::PeekPacket(size_t index, uint16 &eq_opcode, uint32 &length) const {
+	if (index >= m_packet_queue.size()) {
+		return MatchNotReady;
+	}
+
+	auto p = m_packet_queue[index].get();
+	auto opcode_size = m_owner->GetOptions().opcode_size;
+	if (p->Length() < (size_t)opcode_size) {
+		//too short to carry an opcode, reported as one no patch uses
+		eq_opcode = 0;
+		length = 0;
+		return MatchSuccessful;
+	}
+
+	switch (opcode_size) {
+	case 1:
+		eq_opcode = p->GetUInt8(0);
+		break;
+	case 2:
+		eq_opcode = p->GetUInt16(0);
+		break;
+	default:
+		return MatchFailed;
+	}
+
+	length = (uint32)(p->Length() - opcode_size);
+	return MatchSuccessful;
+}
+
 EQStreamState EQ::Net::EQStream::GetState() {
 	auto status = m_connection->GetStatus();
 	switch (status) {
@@ -253,3 +306,21 @@ EQStreamManagerInterface *EQ::Net::EQStream::GetManager() const
 {
 	return m_owner;
 }
+
+bool EQ::Net::EQStream::StartCapture(const std::string &path)
+{
+	std::unique_ptr<PacketCaptureWriter> capture(new PacketCaptureWriter());
+	if (!capture->Open(path, m_owner->GetOptions().opcode_size)) {
+		return false;
+	}
+
+	m_capture = std::move(capture);
+	return true;
+}
+
+void EQ::Net::EQStream::CaptureClientVersion(const std::string &name)
+{
+	if (m_capture) {
+		m_capture->WriteClientVersion(name);
+	}
+}
@@ -4,6 +4,7 @@
 #include "../eq_stream_intf.h"
 #include "../opcodemgr.h"
 #include "daybreak_connection.h"
+#include "packet_capture.h"
 #include <vector>
 #include <deque>
 #include <unordered_map>
@@ -22,10 +23,12 @@ namespace EQ
 			virtual void SetOptions(const EQStreamManagerInterfaceOptions& options);
 			void OnNewConnection(std::function<void(std::shared_ptr<EQStream>)> func) { m_on_new_connection = func; }
 			void OnConnectionStateChange(std::function<void(std::shared_ptr<EQStream>, DbProtocolStatus, DbProtocolStatus)> func) { m_on_connection_state_change = func; }
+			void OnPacketRecv(std::function<void(std::shared_ptr<EQStream>)> func) { m_on_packet_recv = func; }
 		private:
 			DaybreakConnectionManager m_daybreak;
 			std::function<void(std::shared_ptr<EQStream>)> m_on_new_connection;
 			std::function<void(std::shared_ptr<EQStream>, DbProtocolStatus, DbProtocolStatus)> m_on_connection_state_change;
+			std::function<void(std::shared_ptr<EQStream>)> m_on_packet_recv;
 			std::map<std::shared_ptr<DaybreakConnection>, std::shared_ptr<EQStream>> m_streams;
 
 			void DaybreakNewConnection(std::shared_ptr<DaybreakConnection> connection);
@@ -53,14 +56,18 @@ namespace EQ
 			virtual std::string Describe() const { return "Direct EQStream"; }
 			virtual void SetActive(bool val) { }
 			virtual MatchState CheckSignature(const Signature *sig);
+			virtual MatchState PeekPacket(size_t index, uint16 &eq_opcode, uint32 &length) const;
 			virtual EQStreamState GetState();
 			virtual void SetOpcodeManager(OpcodeManager **opm) {
 				m_opcode_manager = opm;
 			}
+			virtual void CaptureClientVersion(const std::string &name);
 
 			virtual Stats GetStats() const;
 			virtual void ResetStats();
 			virtual EQStreamManagerInterface* GetManager() const;
+
+			bool StartCapture(const std::string &path);
 		private:
 			EQStreamManagerInterface *m_owner;
 			std::shared_ptr<DaybreakConnection> m_connection;
@@ -68,6 +75,7 @@ namespace EQ
 			std::deque<std::unique_ptr<EQ::Net::Packet>> m_packet_queue;
 			std::unordered_map<int, int> m_packet_recv_count;
 			std::unordered_map<int, int> m_packet_sent_count;
+			std::unique_ptr<PacketCaptureWriter> m_capture;
 			friend class EQStreamManager;
 		};
 	}
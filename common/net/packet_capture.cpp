@@ -0,0 +1,248 @@
+#include "packet_capture.h"
+
+namespace {
+	const char PacketCaptureMagic[4] = { 'E', 'Q', 'C', 'P' };
+	const uint16_t PacketCaptureVersion = 1;
+	const size_t PacketCaptureMaxRecord = 1024 * 1024;
+}
+
+EQ::Net::PacketCaptureWriter::PacketCaptureWriter()
+{
+	m_file = nullptr;
+}
+
+EQ::Net::PacketCaptureWriter::~PacketCaptureWriter()
+{
+	Close();
+}
+
+bool EQ::Net::PacketCaptureWriter::Open(const std::string &path, int opcode_size)
+{
+	Close();
+
+	m_file = fopen(path.c_str(), "wb");
+	if (!m_file) {
+		return false;
+	}
+
+	//captures are write heavy and rarely read while the zone is up, let stdio batch them
+	setvbuf(m_file, nullptr, _IOFBF, 64 * 1024);
+
+	m_start = std::chrono::steady_clock::now();
+	auto unix_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	fwrite(PacketCaptureMagic, 1, sizeof(PacketCaptureMagic), m_file);
+	WriteUInt16(PacketCaptureVersion);
+	WriteUInt8((uint8_t)opcode_size);
+	WriteUInt8(0);
+	WriteUInt64((uint64_t)unix_ms);
+	return true;
+}
+
+void EQ::Net::PacketCaptureWriter::Close()
+{
+	if (m_file) {
+		fclose(m_file);
+		m_file = nullptr;
+	}
+}
+
+void EQ::Net::PacketCaptureWriter::WriteClientVersion(const std::string &name)
+{
+	if (!m_file) {
+		return;
+	}
+
+	auto length = name.length() > 255 ? 255 : name.length();
+	WriteRecordHeader(PacketCaptureClientVersion);
+	WriteUInt8((uint8_t)length);
+	fwrite(name.data(), 1, length, m_file);
+}
+
+void EQ::Net::PacketCaptureWriter::WritePacket(PacketCaptureRecordType type, const Packet &p, bool reliable)
+{
+	if (!m_file) {
+		return;
+	}
+
+	WriteRecordHeader(type);
+	WriteUInt8(reliable ? PacketCaptureReliable : 0);
+	WriteUInt32((uint32_t)p.Length());
+	fwrite(p.Data(), 1, p.Length(), m_file);
+}
+
+void EQ::Net::PacketCaptureWriter::WriteRecordHeader(PacketCaptureRecordType type)
+{
+	auto offset = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start).count();
+	WriteUInt8(type);
+	WriteUInt32((uint32_t)offset);
+}
+
+void EQ::Net::PacketCaptureWriter::WriteUInt8(uint8_t v)
+{
+	fputc(v, m_file);
+}
+
+void EQ::Net::PacketCaptureWriter::WriteUInt16(uint16_t v)
+{
+	uint8_t b[2] = { (uint8_t)v, (uint8_t)(v >> 8) };
+	fwrite(b, 1, sizeof(b), m_file);
+}
+
+void EQ::Net::PacketCaptureWriter::WriteUInt32(uint32_t v)
+{
+	uint8_t b[4];
+	for (int i = 0; i < 4; ++i) {
+		b[i] = (uint8_t)(v >> (i * 8));
+	}
+
+	fwrite(b, 1, sizeof(b), m_file);
+}
+
+void EQ::Net::PacketCaptureWriter::WriteUInt64(uint64_t v)
+{
+	uint8_t b[8];
+	for (int i = 0; i < 8; ++i) {
+		b[i] = (uint8_t)(v >> (i * 8));
+	}
+
+	fwrite(b, 1, sizeof(b), m_file);
+}
+
+EQ::Net::PacketCaptureReader::PacketCaptureReader()
+{
+	m_file = nullptr;
+	m_opcode_size = 2;
+	m_start_time = 0;
+}
+
+EQ::Net::PacketCaptureReader::~PacketCaptureReader()
+{
+	Close();
+}
+
+bool EQ::Net::PacketCaptureReader::Open(const std::string &path)
+{
+	Close();
+
+	m_file = fopen(path.c_str(), "rb");
+	if (!m_file) {
+		return false;
+	}
+
+	char magic[4];
+	uint8_t version_lo = 0;
+	uint8_t version_hi = 0;
+	uint8_t opcode_size = 0;
+	uint8_t reserved = 0;
+
+	if (fread(magic, 1, sizeof(magic), m_file) != sizeof(magic) || memcmp(magic, PacketCaptureMagic, sizeof(magic)) != 0 ||
+		!ReadUInt8(version_lo) || !ReadUInt8(version_hi) || !ReadUInt8(opcode_size) || !ReadUInt8(reserved) ||
+		!ReadUInt64(m_start_time)) {
+		Close();
+		return false;
+	}
+
+	if ((uint16_t)(version_lo | (version_hi << 8)) != PacketCaptureVersion || (opcode_size != 1 && opcode_size != 2)) {
+		Close();
+		return false;
+	}
+
+	m_opcode_size = opcode_size;
+	return true;
+}
+
+void EQ::Net::PacketCaptureReader::Close()
+{
+	if (m_file) {
+		fclose(m_file);
+		m_file = nullptr;
+	}
+}
+
+bool EQ::Net::PacketCaptureReader::Next(PacketCaptureRecord &record)
+{
+	if (!m_file) {
+		return false;
+	}
+
+	uint8_t type = 0;
+	if (!ReadUInt8(type) || !ReadUInt32(record.offset_ms)) {
+		return false;
+	}
+
+	record.type = (PacketCaptureRecordType)type;
+	record.reliable = false;
+	record.client_version.clear();
+	record.data.clear();
+
+	switch (record.type) {
+	case PacketCaptureClientVersion:
+	{
+		uint8_t length = 0;
+		if (!ReadUInt8(length)) {
+			return false;
+		}
+
+		record.client_version.resize(length);
+		return length == 0 || fread(&record.client_version[0], 1, length, m_file) == length;
+	}
+	case PacketCaptureInbound:
+	case PacketCaptureOutbound:
+	{
+		uint8_t flags = 0;
+		uint32_t length = 0;
+		//a truncated tail from a crashed zone is treated as the end of the capture
+		if (!ReadUInt8(flags) || !ReadUInt32(length) || length > PacketCaptureMaxRecord) {
+			return false;
+		}
+
+		record.reliable = (flags & PacketCaptureReliable) != 0;
+		record.data.resize(length);
+		return length == 0 || fread(&record.data[0], 1, length, m_file) == length;
+	}
+	default:
+		return false;
+	}
+}
+
+bool EQ::Net::PacketCaptureReader::ReadUInt8(uint8_t &v)
+{
+	auto c = fgetc(m_file);
+	if (c == EOF) {
+		return false;
+	}
+
+	v = (uint8_t)c;
+	return true;
+}
+
+bool EQ::Net::PacketCaptureReader::ReadUInt32(uint32_t &v)
+{
+	uint8_t b[4];
+	if (fread(b, 1, sizeof(b), m_file) != sizeof(b)) {
+		return false;
+	}
+
+	v = 0;
+	for (int i = 0; i < 4; ++i) {
+		v |= (uint32_t)b[i] << (i * 8);
+	}
+
+	return true;
+}
+
+bool EQ::Net::PacketCaptureReader::ReadUInt64(uint64_t &v)
+{
+	uint8_t b[8];
+	if (fread(b, 1, sizeof(b), m_file) != sizeof(b)) {
+		return false;
+	}
+
+	v = 0;
+	for (int i = 0; i < 8; ++i) {
+		v |= (uint64_t)b[i] << (i * 8);
+	}
+
+	return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "packet.h"
+
+namespace EQ
+{
+	namespace Net
+	{
+		/*
+		 * .eqcap layout, all integers little endian:
+		 *   header: "EQCP" u16 version u8 opcode_size u8 reserved u64 start_unix_ms
+		 *   record: u8 type u32 offset_ms, then
+		 *     PacketCaptureClientVersion: u8 length, name
+		 *     PacketCaptureInbound/Outbound: u8 flags u32 length, wire app packet (opcode + payload)
+		 */
+		enum PacketCaptureRecordType : uint8_t
+		{
+			PacketCaptureClientVersion = 0,
+			PacketCaptureInbound = 1,
+			PacketCaptureOutbound = 2
+		};
+
+		enum PacketCaptureFlags : uint8_t
+		{
+			PacketCaptureReliable = 1
+		};
+
+		struct PacketCaptureRecord
+		{
+			PacketCaptureRecordType type;
+			uint32_t offset_ms;
+			bool reliable;
+			std::string client_version;
+			std::vector<char> data;
+		};
+
+		class PacketCaptureWriter
+		{
+		public:
+			PacketCaptureWriter();
+			~PacketCaptureWriter();
+
+			bool Open(const std::string &path, int opcode_size);
+			void Close();
+			bool IsOpen() const { return m_file != nullptr; }
+
+			void WriteClientVersion(const std::string &name);
+			void WritePacket(PacketCaptureRecordType type, const Packet &p, bool reliable);
+		private:
+			void WriteRecordHeader(PacketCaptureRecordType type);
+			void WriteUInt8(uint8_t v);
+			void WriteUInt16(uint16_t v);
+			void WriteUInt32(uint32_t v);
+			void WriteUInt64(uint64_t v);
+
+			FILE *m_file;
+			std::chrono::steady_clock::time_point m_start;
+		};
+
+		class PacketCaptureReader
+		{
+		public:
+			PacketCaptureReader();
+			~PacketCaptureReader();
+
+			bool Open(const std::string &path);
+			void Close();
+			bool Next(PacketCaptureRecord &record);
+
+			int OpcodeSize() const { return m_opcode_size; }
+			uint64_t StartTime() const { return m_start_time; }
+		private:
+			bool ReadUInt8(uint8_t &v);
+			bool ReadUInt32(uint32_t &v);
+			bool ReadUInt64(uint64_t &v);
+
+			FILE *m_file;
+			int m_opcode_size;
+			uint64_t m_start_time;
+		};
+	}
+}
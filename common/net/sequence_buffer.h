@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace EQ
+{
+	namespace Net
+	{
+		/*
+		 * Values keyed by a 16 bit sequence number, stored in a power of two ring
+		 * indexed by the low bits of the sequence. Lookups, inserts and erases are
+		 * O(1). When two live sequences would share a slot the ring doubles, so a
+		 * window may span up to the whole sequence space. Erased slots keep their
+		 * value so its storage is reused by the next insert into that slot.
+		 */
+		template<typename T>
+		class SequenceBuffer
+		{
+		public:
+			SequenceBuffer() : m_count(0) { }
+
+			T *Find(uint16_t seq) {
+				if (m_slots.empty()) {
+					return nullptr;
+				}
+
+				auto &slot = m_slots[seq & (m_slots.size() - 1)];
+				return slot.used && slot.seq == seq ? &slot.value : nullptr;
+			}
+
+			//returns the slot for seq, which still holds whatever was last stored there
+			T &Insert(uint16_t seq) {
+				if (m_slots.empty()) {
+					m_slots.resize(InitialSize);
+				}
+
+				for (;;) {
+					auto &slot = m_slots[seq & (m_slots.size() - 1)];
+					if (!slot.used || slot.seq == seq) {
+						if (!slot.used) {
+							slot.used = true;
+							slot.seq = seq;
+							m_count++;
+						}
+
+						return slot.value;
+					}
+
+					Grow();
+				}
+			}
+
+			bool Erase(uint16_t seq) {
+				if (m_slots.empty()) {
+					return false;
+				}
+
+				auto &slot = m_slots[seq & (m_slots.size() - 1)];
+				if (!slot.used || slot.seq != seq) {
+					return false;
+				}
+
+				slot.used = false;
+				m_count--;
+				return true;
+			}
+
+			template<typename Fn>
+			void ForEach(Fn fn) {
+				for (auto &slot : m_slots) {
+					if (slot.used) {
+						fn(slot.seq, slot.value);
+					}
+				}
+			}
+
+			std::size_t Size() const { return m_count; }
+			bool Empty() const { return m_count == 0; }
+
+			void Clear() {
+				for (auto &slot : m_slots) {
+					slot.used = false;
+				}
+
+				m_count = 0;
+			}
+		private:
+			enum { InitialSize = 64 };
+
+			struct Slot
+			{
+				Slot() : seq(0), used(false) { }
+
+				uint16_t seq;
+				bool used;
+				T value;
+			};
+
+			void Grow() {
+				std::vector<Slot> slots(m_slots.size() * 2);
+				for (auto &slot : m_slots) {
+					if (slot.used) {
+						auto &to = slots[slot.seq & (slots.size() - 1)];
+						to.seq = slot.seq;
+						to.used = true;
+						std::swap(to.value, slot.value);
+					}
+				}
+
+				m_slots.swap(slots);
+			}
+
+			std::vector<Slot> m_slots;
+			std::size_t m_count;
+		};
+	}
+}
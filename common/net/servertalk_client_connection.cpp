@@ -10,6 +10,9 @@ EQ::Net::ServertalkClient::ServertalkClient(const std::string &addr, int port, b
 	m_identifier = identifier.empty() ? "Unknown" : identifier;
 	m_credentials = credentials;
 	m_connecting = false;
+	m_batching = false;
+	m_shared_memory_active = false;
+	m_batch_timer.reset(new EQ::Timer(std::bind(&EQ::Net::ServertalkClient::FlushBatch, this)));
 	DNSLookup(addr, port, false, [this](const std::string &address) {
 		m_addr = address;
 	});
@@ -17,10 +20,37 @@ EQ::Net::ServertalkClient::ServertalkClient(const std::string &addr, int port, b
 
 EQ::Net::ServertalkClient::~ServertalkClient()
 {
+	//messages still waiting on the batch timer would otherwise be dropped
+	FlushBatch();
 }
 
 void EQ::Net::ServertalkClient::Send(uint16_t opcode, EQ::Net::Packet &p)
 {
+	auto &stats = m_stats.opcodes[opcode];
+	stats.sent_messages++;
+	stats.sent_bytes += p.Length();
+
+	if (m_shared_memory_active) {
+		//match the encrypted tcp path so handlers see the same payload either way
+		if (p.Length() == 0) {
+			p.PutUInt8(0, 0);
+		}
+
+		m_stats.shared_memory_messages++;
+		if (!m_shared_memory->Send(opcode, p) && m_connection) {
+			m_connection->Disconnect();
+		}
+		return;
+	}
+
+	if (m_batching && !ServertalkPriorityOpcode(opcode) && p.Length() <= ServertalkBatchMaxMessage) {
+		QueueBatch(opcode, p);
+		return;
+	}
+
+	//anything sent directly must not overtake what is already queued
+	FlushBatch();
+
 	EQ::Net::DynamicPacket out;
 #ifdef ENABLE_SECURITY
 	if (m_encrypted) {
@@ -88,6 +118,10 @@ void EQ::Net::ServertalkClient::Connect()
 		m_connection->OnDisconnect([this](EQ::Net::TCPConnection *c) {
 			LogF(Logs::General, Logs::TCPConnection, "Connection lost to {0}:{1}, attempting to reconnect...", m_addr, m_port);
 			m_encrypted = false;
+			m_batching = false;
+			m_batch.Clear();
+			m_shared_memory_active = false;
+			m_shared_memory.reset();
 			m_connection.reset();
 		});
 
@@ -161,6 +195,17 @@ void EQ::Net::ServertalkClient::ProcessReadBuffer()
 			case ServertalkMessage:
 				ProcessMessage(p);
 				break;
+			case ServertalkMessageBatch:
+				ProcessMessageBatch(p);
+				break;
+			case ServertalkSharedMemoryActive:
+				ProcessSharedMemoryActive();
+				break;
+			case ServertalkSharedMemoryDoorbell:
+				if (m_shared_memory) {
+					m_shared_memory->Wake();
+				}
+				break;
 			}
 		}
 		else {
@@ -172,6 +217,15 @@ void EQ::Net::ServertalkClient::ProcessReadBuffer()
 			case ServertalkMessage:
 				ProcessMessage(p);
 				break;
+			case ServertalkMessageBatch:
+				ProcessMessageBatch(p);
+				break;
+			case ServertalkSharedMemoryOffer:
+				ProcessSharedMemoryOffer(p);
+				break;
+			case ServertalkSharedMemoryActive:
+				ProcessSharedMemoryActive();
+				break;
 			}
 		}
 
@@ -196,6 +250,7 @@ void EQ::Net::ServertalkClient::ProcessHello(EQ::Net::Packet &p)
 	memset(m_nonce_theirs, 0, crypto_box_NONCEBYTES);
 	memset(m_shared_key, 0, crypto_box_BEFORENMBYTES);
 	m_encrypted = false;
+	m_batching = false;
 
 	try {
 		bool enc = p.GetInt8(0) == 1 ? true : false;
@@ -233,6 +288,8 @@ void EQ::Net::ServertalkClient::ProcessHello(EQ::Net::Packet &p)
 		}
 	}
 #else
+	m_batching = false;
+
 	try {
 		bool enc = p.GetInt8(0) == 1 ? true : false;
 
@@ -284,41 +341,20 @@ void EQ::Net::ServertalkClient::ProcessMessage(EQ::Net::Packet &p)
 
 				(*(uint64_t*)&m_nonce_theirs[0])++;
 
-				auto cb = m_message_callbacks.find(opcode);
-				if (cb != m_message_callbacks.end()) {
-					cb->second(opcode, decrypted_packet);
-				}
-
-				if (m_message_callback) {
-					m_message_callback(opcode, decrypted_packet);
-				}
+				DispatchMessage(opcode, decrypted_packet);
 			}
 			else {
 				size_t message_len = length;
 				EQ::Net::StaticPacket packet(&data[0], message_len);
 
-				auto cb = m_message_callbacks.find(opcode);
-				if (cb != m_message_callbacks.end()) {
-					cb->second(opcode, packet);
-				}
-
-				if (m_message_callback) {
-					m_message_callback(opcode, packet);
-				}
+				DispatchMessage(opcode, packet);
 			}
 
 #else
 			size_t message_len = length;
 			EQ::Net::StaticPacket packet(&data[0], message_len);
 
-			auto cb = m_message_callbacks.find(opcode);
-			if (cb != m_message_callbacks.end()) {
-				cb->second(opcode, packet);
-			}
-
-			if (m_message_callback) {
-				m_message_callback(opcode, packet);
-			}
+			DispatchMessage(opcode, packet);
 #endif
 		}
 	}
@@ -327,6 +363,16 @@ void EQ::Net::ServertalkClient::ProcessMessage(EQ::Net::Packet &p)
 	}
 }
 
+uint8_t EQ::Net::ServertalkClient::Capabilities() const
+{
+	uint8_t capabilities = ServertalkCapabilityBatch;
+	if (m_connection && ServertalkLocalPeer(m_connection->LocalIP(), m_connection->RemoteIP())) {
+		capabilities |= ServertalkCapabilitySharedMemory;
+	}
+
+	return capabilities;
+}
+
 void EQ::Net::ServertalkClient::SendHandshake(bool downgrade)
 {
 	EQ::Net::DynamicPacket handshake;
@@ -344,8 +390,8 @@ void EQ::Net::ServertalkClient::SendHandshake(bool downgrade)
 		memset(m_public_key_theirs, 0, crypto_box_PUBLICKEYBYTES);
 		memset(m_private_key_ours, 0, crypto_box_SECRETKEYBYTES);
 
-		size_t cipher_length = m_identifier.length() + 1 + m_credentials.length() + 1 + crypto_secretbox_MACBYTES;
-		size_t data_length = m_identifier.length() + 1 + m_credentials.length() + 1;
+		size_t cipher_length = m_identifier.length() + 1 + m_credentials.length() + 1 + 1 + crypto_secretbox_MACBYTES;
+		size_t data_length = m_identifier.length() + 1 + m_credentials.length() + 1 + 1;
 		
 		std::unique_ptr<unsigned char[]> signed_buffer(new unsigned char[cipher_length]);
 		std::unique_ptr<unsigned char[]> data_buffer(new unsigned char[data_length]);
@@ -353,6 +399,7 @@ void EQ::Net::ServertalkClient::SendHandshake(bool downgrade)
 		memset(&data_buffer[0], 0, data_length);
 		memcpy(&data_buffer[0], m_identifier.c_str(), m_identifier.length());
 		memcpy(&data_buffer[1 + m_identifier.length()], m_credentials.c_str(), m_credentials.length());
+		data_buffer[data_length - 1] = Capabilities();
 		
 		crypto_box_easy_afternm(&signed_buffer[0], &data_buffer[0], data_length, m_nonce_ours, m_shared_key);
 
@@ -364,11 +411,13 @@ void EQ::Net::ServertalkClient::SendHandshake(bool downgrade)
 		handshake.PutString(0, m_identifier);
 		handshake.PutString(m_identifier.length() + 1, m_credentials);
 		handshake.PutUInt8(m_identifier.length() + 1 + m_credentials.length(), 0);
+		handshake.PutUInt8(m_identifier.length() + 1 + m_credentials.length() + 1, Capabilities());
 	}
 #else
 	handshake.PutString(0, m_identifier);
 	handshake.PutString(m_identifier.length() + 1, m_credentials);
 	handshake.PutUInt8(m_identifier.length() + 1 + m_credentials.length(), 0);
+	handshake.PutUInt8(m_identifier.length() + 1 + m_credentials.length() + 1, Capabilities());
 #endif
 
 	if (downgrade) {
@@ -378,3 +427,174 @@ void EQ::Net::ServertalkClient::SendHandshake(bool downgrade)
 		InternalSend(ServertalkClientHandshake, handshake);
 	}
 }
+
+void EQ::Net::ServertalkClient::ProcessMessageBatch(EQ::Net::Packet &p)
+{
+	//an empty batch is the server agreeing to accept batches from us
+	if (p.Length() == 0) {
+		m_batching = true;
+		return;
+	}
+
+	try {
+#ifdef ENABLE_SECURITY
+		if (m_encrypted) {
+			if (p.Length() <= crypto_secretbox_MACBYTES) {
+				LogError("Message batch from server was too short to decrypt");
+				return;
+			}
+
+			size_t message_len = p.Length() - crypto_secretbox_MACBYTES;
+			std::unique_ptr<unsigned char[]> decrypted_text(new unsigned char[message_len]);
+			if (crypto_box_open_easy_afternm(&decrypted_text[0], (unsigned char*)p.Data(), p.Length(), m_nonce_theirs, m_shared_key))
+			{
+				LogError("Error decrypting message batch from server");
+				(*(uint64_t*)&m_nonce_theirs[0])++;
+				return;
+			}
+
+			(*(uint64_t*)&m_nonce_theirs[0])++;
+
+			EQ::Net::StaticPacket decrypted_packet(&decrypted_text[0], message_len);
+			DispatchBatch(decrypted_packet);
+			return;
+		}
+#endif
+		DispatchBatch(p);
+	}
+	catch (std::exception &ex) {
+		LogError("Error parsing message batch from server: {0}", ex.what());
+	}
+}
+
+void EQ::Net::ServertalkClient::DispatchBatch(EQ::Net::Packet &p)
+{
+	//same length/opcode header as a single message, but sealed once for the whole batch
+	size_t idx = 0;
+	while (idx + 6 <= p.Length()) {
+		auto length = p.GetUInt32(idx);
+		auto opcode = p.GetUInt16(idx + 4);
+		if (idx + 6 + length > p.Length()) {
+			LogError("Truncated message {0:#x} in batch from server", opcode);
+			return;
+		}
+
+		if (length > 0) {
+			EQ::Net::StaticPacket packet((char*)p.Data() + idx + 6, length);
+			DispatchMessage(opcode, packet);
+		}
+
+		idx += 6 + length;
+	}
+}
+
+void EQ::Net::ServertalkClient::DispatchMessage(uint16_t opcode, EQ::Net::Packet &p)
+{
+	auto &stats = m_stats.opcodes[opcode];
+	stats.recv_messages++;
+	stats.recv_bytes += p.Length();
+
+	auto cb = m_message_callbacks.find(opcode);
+	if (cb != m_message_callbacks.end()) {
+		cb->second(opcode, p);
+	}
+
+	if (m_message_callback) {
+		m_message_callback(opcode, p);
+	}
+}
+
+void EQ::Net::ServertalkClient::QueueBatch(uint16_t opcode, EQ::Net::Packet &p)
+{
+#ifdef ENABLE_SECURITY
+	//match the single message path so handlers see the same payload either way
+	if (m_encrypted && p.Length() == 0) {
+		p.PutUInt8(0, 0);
+	}
+#endif
+
+	auto idx = m_batch.Length();
+	m_batch.PutUInt32(idx, p.Length());
+	m_batch.PutUInt16(idx + 4, opcode);
+	if (p.Length() > 0) {
+		m_batch.PutPacket(idx + 6, p);
+	}
+
+	m_stats.batched_messages++;
+
+	if (m_batch.Length() >= ServertalkBatchMaxSize) {
+		FlushBatch();
+	}
+	else {
+		m_batch_timer->Start(0, false);
+	}
+}
+
+void EQ::Net::ServertalkClient::FlushBatch()
+{
+	if (m_batch.Length() == 0) {
+		return;
+	}
+
+#ifdef ENABLE_SECURITY
+	if (m_encrypted) {
+		EQ::Net::DynamicPacket out;
+		out.Resize(m_batch.Length() + crypto_secretbox_MACBYTES);
+		crypto_box_easy_afternm((unsigned char*)out.Data(), (unsigned char*)m_batch.Data(), m_batch.Length(), m_nonce_ours, m_shared_key);
+		(*(uint64_t*)&m_nonce_ours[0])++;
+		InternalSend(ServertalkMessageBatch, out);
+	}
+	else {
+		InternalSend(ServertalkMessageBatch, m_batch);
+	}
+#else
+	InternalSend(ServertalkMessageBatch, m_batch);
+#endif
+
+	m_batch.Clear();
+	m_stats.batches_sent++;
+}
+
+void EQ::Net::ServertalkClient::ProcessSharedMemoryOffer(EQ::Net::Packet &p)
+{
+	m_shared_memory.reset();
+
+	try {
+		auto token = p.GetUInt64(0);
+		auto path = p.GetCString(8);
+		m_shared_memory = ServertalkSharedMemory::Open(path, token);
+	}
+	catch (std::exception &ex) {
+		LogError("Error parsing shared memory offer from server: {0}", ex.what());
+	}
+
+	//anything queued for tcp has to be written before the accept, after it we only write to the ring
+	FlushBatch();
+
+	EQ::Net::DynamicPacket accept;
+	accept.PutUInt8(0, m_shared_memory ? 1 : 0);
+	InternalSend(ServertalkSharedMemoryAccept, accept);
+
+	if (!m_shared_memory) {
+		LogF(Logs::General, Logs::TCPConnection, "Could not map shared memory offered by {0}:{1}, staying on tcp", m_addr, m_port);
+		return;
+	}
+
+	m_shared_memory->OnMessage(std::bind(&EQ::Net::ServertalkClient::DispatchMessage, this, std::placeholders::_1, std::placeholders::_2));
+	m_shared_memory->OnDoorbell([this]() {
+		EQ::Net::DynamicPacket doorbell;
+		InternalSend(ServertalkSharedMemoryDoorbell, doorbell);
+	});
+	m_shared_memory_active = true;
+}
+
+void EQ::Net::ServertalkClient::ProcessSharedMemoryActive()
+{
+	if (!m_shared_memory) {
+		return;
+	}
+
+	//the server writes nothing more over tcp, so its ring is next in order
+	m_shared_memory->Start();
+	LogF(Logs::General, Logs::TCPConnection, "Switched to shared memory with {0}:{1}", m_addr, m_port);
+}
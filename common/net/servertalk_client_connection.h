@@ -3,6 +3,7 @@
 #include "tcp_connection.h"
 #include "../event/timer.h"
 #include "servertalk_common.h"
+#include "servertalk_shared_memory.h"
 #include "packet.h"
 #ifdef ENABLE_SECURITY
 #include <sodium.h>
@@ -20,6 +21,7 @@ namespace EQ
 
 			void Send(uint16_t opcode, EQ::Net::Packet &p);
 			void SendPacket(ServerPacket *p);
+			const ServertalkStats &GetStats() const { return m_stats; }
 			void OnConnect(std::function<void(ServertalkClient*)> cb) { m_on_connect_cb = cb; }
 			void OnMessage(uint16_t opcode, std::function<void(uint16_t, EQ::Net::Packet&)> cb);
 			void OnMessage(std::function<void(uint16_t, EQ::Net::Packet&)> cb);
@@ -34,6 +36,14 @@ namespace EQ
 			void ProcessReadBuffer();
 			void ProcessHello(EQ::Net::Packet &p);
 			void ProcessMessage(EQ::Net::Packet &p);
+			void ProcessMessageBatch(EQ::Net::Packet &p);
+			void DispatchBatch(EQ::Net::Packet &p);
+			void DispatchMessage(uint16_t opcode, EQ::Net::Packet &p);
+			void QueueBatch(uint16_t opcode, EQ::Net::Packet &p);
+			void FlushBatch();
+			void ProcessSharedMemoryOffer(EQ::Net::Packet &p);
+			void ProcessSharedMemoryActive();
+			uint8_t Capabilities() const;
 			void SendHandshake() { SendHandshake(false); }
 			void SendHandshake(bool downgrade);
 
@@ -50,6 +60,16 @@ namespace EQ
 			std::vector<char> m_buffer;
 			std::unordered_map<uint16_t, std::function<void(uint16_t, EQ::Net::Packet&)>> m_message_callbacks;
 			std::function<void(uint16_t, EQ::Net::Packet&)> m_message_callback;
+
+			//small messages queued this tick, sealed and written as one ServertalkMessageBatch
+			bool m_batching;
+			EQ::Net::DynamicPacket m_batch;
+			std::unique_ptr<EQ::Timer> m_batch_timer;
+			ServertalkStats m_stats;
+
+			//same host servers offer a mapped ring, we write to it as soon as we accept and read once they confirm
+			std::unique_ptr<ServertalkSharedMemory> m_shared_memory;
+			bool m_shared_memory_active;
 			std::function<void(ServertalkClient*)> m_on_connect_cb;
 
 #ifdef ENABLE_SECURITY
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "../servertalk.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
 
 namespace EQ
 {
@@ -13,6 +16,76 @@ namespace EQ
 			ServertalkClientHandshake,
 			ServertalkClientDowngradeSecurityHandshake,
 			ServertalkMessage,
+			ServertalkMessageBatch,
+			ServertalkSharedMemoryOffer,
+			ServertalkSharedMemoryAccept,
+			ServertalkSharedMemoryActive,
+			ServertalkSharedMemoryDoorbell,
 		};
+
+		//trailing handshake byte, older servers stop reading after the credentials and never see it
+		enum ServertalkCapability
+		{
+			ServertalkCapabilityBatch = 1,
+			ServertalkCapabilitySharedMemory = 2
+		};
+
+		enum
+		{
+			ServertalkBatchMaxMessage = 1024,
+			ServertalkBatchMaxSize = 64 * 1024
+		};
+
+		struct ServertalkOpcodeStats
+		{
+			ServertalkOpcodeStats() {
+				sent_messages = 0;
+				sent_bytes = 0;
+				recv_messages = 0;
+				recv_bytes = 0;
+			}
+
+			uint64_t sent_messages;
+			uint64_t sent_bytes;
+			uint64_t recv_messages;
+			uint64_t recv_bytes;
+		};
+
+		struct ServertalkStats
+		{
+			ServertalkStats() {
+				batches_sent = 0;
+				batched_messages = 0;
+				shared_memory_messages = 0;
+			}
+
+			std::unordered_map<uint16_t, ServertalkOpcodeStats> opcodes;
+			uint64_t batches_sent;
+			uint64_t batched_messages;
+			uint64_t shared_memory_messages;
+		};
+
+		//only peers on the same host can map each other's shared memory
+		inline bool ServertalkLocalPeer(const std::string &local_ip, const std::string &remote_ip)
+		{
+			return remote_ip == local_ip || remote_ip.compare(0, 4, "127.") == 0 || remote_ip == "::1";
+		}
+
+		//zoning and auth handoffs wait on these so they skip the batch and flush whatever is queued ahead of them
+		inline bool ServertalkPriorityOpcode(uint16_t opcode)
+		{
+			switch (opcode) {
+			case ServerOP_KeepAlive:
+			case ServerOP_ZonePlayer:
+			case ServerOP_KickPlayer:
+			case ServerOP_ZoneToZoneRequest:
+			case ServerOP_AcceptWorldEntrance:
+			case ServerOP_ZAAuth:
+			case ServerOP_ZoneIncClient:
+				return true;
+			default:
+				return false;
+			}
+		}
 	}
-}
\ No newline at end of file
+}
@@ -19,7 +19,10 @@ namespace EQ
 			bool ipv6;
 			bool encrypted;
 			bool allow_downgrade;
+			bool batching;
 			std::string credentials;
+			std::string shared_memory_directory;
+			uint32_t shared_memory_ring_size;
 
 			ServertalkServerOptions() {
 #ifdef ENABLE_SECURITY
@@ -30,6 +33,8 @@ namespace EQ
 				allow_downgrade = true;
 #endif
 				ipv6 = false;
+				batching = true;
+				shared_memory_ring_size = ServertalkSharedMemoryRingSize;
 			}
 		};
 
@@ -56,7 +61,10 @@ namespace EQ
 			std::map<std::string, std::function<void(std::shared_ptr<ServertalkServerConnection>)>> m_on_disc;
 			bool m_encrypted;
 			bool m_allow_downgrade;
+			bool m_batching;
 			std::string m_credentials;
+			std::string m_shared_memory_directory;
+			uint32_t m_shared_memory_ring_size;
 
 			friend class ServertalkServerConnection;
 		};
@@ -2,6 +2,7 @@
 #include "servertalk_server.h"
 #include "../eqemu_logsys.h"
 #include "../util/uuid.h"
+#include <random>
 
 EQ::Net::ServertalkServerConnection::ServertalkServerConnection(std::shared_ptr<EQ::Net::TCPConnection> c, EQ::Net::ServertalkServer *parent, bool encrypted, bool allow_downgrade)
 {
@@ -9,6 +10,9 @@ EQ::Net::ServertalkServerConnection::ServertalkServerConnection(std::shared_ptr<
 	m_parent = parent;
 	m_encrypted = encrypted;
 	m_allow_downgrade = allow_downgrade;
+	m_batching = false;
+	m_shared_memory_active = false;
+	m_batch_timer.reset(new EQ::Timer(std::bind(&ServertalkServerConnection::FlushBatch, this)));
 	m_uuid = EQ::Util::UUID::Generate().ToString();
 	m_connection->OnRead(std::bind(&ServertalkServerConnection::OnRead, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
 	m_connection->OnDisconnect(std::bind(&ServertalkServerConnection::OnDisconnect, this, std::placeholders::_1));
@@ -17,10 +21,37 @@ EQ::Net::ServertalkServerConnection::ServertalkServerConnection(std::shared_ptr<
 
 EQ::Net::ServertalkServerConnection::~ServertalkServerConnection()
 {
+	//messages still waiting on the batch timer would otherwise be dropped
+	FlushBatch();
 }
 
 void EQ::Net::ServertalkServerConnection::Send(uint16_t opcode, EQ::Net::Packet & p)
 {
+	auto &stats = m_stats.opcodes[opcode];
+	stats.sent_messages++;
+	stats.sent_bytes += p.Length();
+
+	if (m_shared_memory_active) {
+		//match the encrypted tcp path so handlers see the same payload either way
+		if (p.Length() == 0) {
+			p.PutUInt8(0, 0);
+		}
+
+		m_stats.shared_memory_messages++;
+		if (!m_shared_memory->Send(opcode, p) && m_connection) {
+			m_connection->Disconnect();
+		}
+		return;
+	}
+
+	if (m_batching && !ServertalkPriorityOpcode(opcode) && p.Length() <= ServertalkBatchMaxMessage) {
+		QueueBatch(opcode, p);
+		return;
+	}
+
+	//anything sent directly must not overtake what is already queued
+	FlushBatch();
+
 	EQ::Net::DynamicPacket out;
 #ifdef ENABLE_SECURITY
 	if (m_encrypted) {
@@ -114,6 +145,14 @@ void EQ::Net::ServertalkServerConnection::ProcessReadBuffer()
 			case ServertalkMessage:
 				ProcessMessage(p);
 				break;
+			case ServertalkMessageBatch:
+				ProcessMessageBatch(p);
+				break;
+			case ServertalkSharedMemoryDoorbell:
+				if (m_shared_memory) {
+					m_shared_memory->Wake();
+				}
+				break;
 			}
 		}
 		else {
@@ -133,6 +172,12 @@ void EQ::Net::ServertalkServerConnection::ProcessReadBuffer()
 			case ServertalkMessage:
 				ProcessMessage(p);
 				break;
+			case ServertalkMessageBatch:
+				ProcessMessageBatch(p);
+				break;
+			case ServertalkSharedMemoryAccept:
+				ProcessSharedMemoryAccept(p);
+				break;
 			}
 		}
 
@@ -149,6 +194,8 @@ void EQ::Net::ServertalkServerConnection::ProcessReadBuffer()
 
 void EQ::Net::ServertalkServerConnection::OnDisconnect(TCPConnection *c)
 {
+	m_shared_memory_active = false;
+	m_shared_memory.reset();
 	m_parent->ConnectionDisconnected(this);
 }
 
@@ -234,6 +281,12 @@ void EQ::Net::ServertalkServerConnection::ProcessHandshake(EQ::Net::Packet &p, b
 					return;
 				}
 
+				size_t capabilities = m_identifier.length() + 1 + credentials.length() + 1;
+				if (message_len > capabilities) {
+					EnableBatching(decrypted_text[capabilities]);
+					OfferSharedMemory(decrypted_text[capabilities]);
+				}
+
 				m_parent->ConnectionIdentified(this);
 				(*(uint64_t*)&m_nonce_theirs[0])++;
 			}
@@ -254,6 +307,12 @@ void EQ::Net::ServertalkServerConnection::ProcessHandshake(EQ::Net::Packet &p, b
 				return;
 			}
 
+			size_t capabilities = m_identifier.length() + 1 + credentials.length() + 1;
+			if (p.Length() > capabilities) {
+				EnableBatching(p.GetUInt8(capabilities));
+				OfferSharedMemory(p.GetUInt8(capabilities));
+			}
+
 			m_parent->ConnectionIdentified(this);
 		}
 		catch (std::exception &ex) {
@@ -272,6 +331,12 @@ void EQ::Net::ServertalkServerConnection::ProcessHandshake(EQ::Net::Packet &p, b
 			return;
 		}
 
+		size_t capabilities = m_identifier.length() + 1 + credentials.length() + 1;
+		if (p.Length() > capabilities) {
+			EnableBatching(p.GetUInt8(capabilities));
+			OfferSharedMemory(p.GetUInt8(capabilities));
+		}
+
 		m_parent->ConnectionIdentified(this);
 	}
 	catch (std::exception &ex) {
@@ -304,45 +369,213 @@ void EQ::Net::ServertalkServerConnection::ProcessMessage(EQ::Net::Packet &p)
 
 				(*(uint64_t*)&m_nonce_theirs[0])++;
 
-				auto cb = m_message_callbacks.find(opcode);
-				if (cb != m_message_callbacks.end()) {
-					cb->second(opcode, decrypted_packet);
-				}
-
-				if (m_message_callback) {
-					m_message_callback(opcode, decrypted_packet);
-				}
+				DispatchMessage(opcode, decrypted_packet);
 			}
 			else {
 				size_t message_len = length;
 				EQ::Net::StaticPacket packet(&data[0], message_len);
 
-				auto cb = m_message_callbacks.find(opcode);
-				if (cb != m_message_callbacks.end()) {
-					cb->second(opcode, packet);
-				}
-
-				if (m_message_callback) {
-					m_message_callback(opcode, packet);
-				}
+				DispatchMessage(opcode, packet);
 			}
 
 #else
 			size_t message_len = length;
 			EQ::Net::StaticPacket packet(&data[0], message_len);
 
-			auto cb = m_message_callbacks.find(opcode);
-			if (cb != m_message_callbacks.end()) {
-				cb->second(opcode, packet);
+			DispatchMessage(opcode, packet);
+#endif
+		}
+	}
+	catch (std::exception &ex) {
+		LogError("Error parsing message from client: {0}", ex.what());
+	}
+}
+
+void EQ::Net::ServertalkServerConnection::EnableBatching(uint8_t capabilities)
+{
+	if (!m_parent->m_batching || (capabilities & ServertalkCapabilityBatch) == 0) {
+		return;
+	}
+
+	//tell the client it may batch too, older clients ignore the unknown packet type
+	EQ::Net::DynamicPacket ack;
+	InternalSend(ServertalkMessageBatch, ack);
+	m_batching = true;
+}
+
+void EQ::Net::ServertalkServerConnection::OfferSharedMemory(uint8_t capabilities)
+{
+	if (m_parent->m_shared_memory_directory.empty() || (capabilities & ServertalkCapabilitySharedMemory) == 0 ||
+		!ServertalkLocalPeer(m_connection->LocalIP(), m_connection->RemoteIP())) {
+		return;
+	}
+
+	//the token proves the client mapped our segment and not a stale file with the same name
+	std::random_device rd;
+	uint64_t token = ((uint64_t)rd() << 32) | rd();
+	auto path = m_parent->m_shared_memory_directory + "servertalk_" + m_uuid;
+
+	m_shared_memory = ServertalkSharedMemory::Create(path, m_parent->m_shared_memory_ring_size, token);
+	if (!m_shared_memory) {
+		return;
+	}
+
+	m_shared_memory->OnMessage(std::bind(&ServertalkServerConnection::DispatchMessage, this, std::placeholders::_1, std::placeholders::_2));
+	m_shared_memory->OnDoorbell([this]() {
+		EQ::Net::DynamicPacket doorbell;
+		InternalSend(ServertalkSharedMemoryDoorbell, doorbell);
+	});
+
+	EQ::Net::DynamicPacket offer;
+	offer.PutUInt64(0, token);
+	offer.PutString(8, path);
+	InternalSend(ServertalkSharedMemoryOffer, offer);
+}
+
+void EQ::Net::ServertalkServerConnection::ProcessSharedMemoryAccept(EQ::Net::Packet &p)
+{
+	if (!m_shared_memory) {
+		return;
+	}
+
+	if (p.Length() < 1 || p.GetUInt8(0) == 0) {
+		LogF(Logs::General, Logs::TCPConnection, "{0} at {1}:{2} could not map shared memory, staying on tcp",
+			m_identifier, m_connection->RemoteIP(), m_connection->RemotePort());
+		m_shared_memory.reset();
+		return;
+	}
+
+	//everything the client sent before the accept came over tcp and has been handled, so its ring is next in order.
+	//ours only starts after the active marker so the client drains tcp first too
+	m_shared_memory->Start();
+	FlushBatch();
+
+	EQ::Net::DynamicPacket active;
+	InternalSend(ServertalkSharedMemoryActive, active);
+	m_shared_memory_active = true;
+	m_shared_memory->Unlink();
+
+	LogF(Logs::General, Logs::TCPConnection, "{0} at {1}:{2} switched to shared memory",
+		m_identifier, m_connection->RemoteIP(), m_connection->RemotePort());
+}
+
+void EQ::Net::ServertalkServerConnection::ProcessMessageBatch(EQ::Net::Packet &p)
+{
+	try {
+#ifdef ENABLE_SECURITY
+		if (m_encrypted) {
+			if (p.Length() <= crypto_secretbox_MACBYTES) {
+				LogError("Message batch from client was too short to decrypt");
+				return;
 			}
 
-			if (m_message_callback) {
-				m_message_callback(opcode, packet);
+			size_t message_len = p.Length() - crypto_secretbox_MACBYTES;
+			std::unique_ptr<unsigned char[]> decrypted_text(new unsigned char[message_len]);
+			if (crypto_box_open_easy_afternm(&decrypted_text[0], (unsigned char*)p.Data(), p.Length(), m_nonce_theirs, m_shared_key))
+			{
+				LogError("Error decrypting message batch from client");
+				(*(uint64_t*)&m_nonce_theirs[0])++;
+				return;
 			}
-#endif
+
+			(*(uint64_t*)&m_nonce_theirs[0])++;
+
+			EQ::Net::StaticPacket decrypted_packet(&decrypted_text[0], message_len);
+			DispatchBatch(decrypted_packet);
+			return;
 		}
+#endif
+		DispatchBatch(p);
 	}
 	catch (std::exception &ex) {
-		LogError("Error parsing message from client: {0}", ex.what());
+		LogError("Error parsing message batch from client: {0}", ex.what());
+	}
+}
+
+void EQ::Net::ServertalkServerConnection::DispatchBatch(EQ::Net::Packet &p)
+{
+	//same length/opcode header as a single message, but sealed once for the whole batch
+	size_t idx = 0;
+	while (idx + 6 <= p.Length()) {
+		auto length = p.GetUInt32(idx);
+		auto opcode = p.GetUInt16(idx + 4);
+		if (idx + 6 + length > p.Length()) {
+			LogError("Truncated message {0:#x} in batch from client", opcode);
+			return;
+		}
+
+		if (length > 0) {
+			EQ::Net::StaticPacket packet((char*)p.Data() + idx + 6, length);
+			DispatchMessage(opcode, packet);
+		}
+
+		idx += 6 + length;
+	}
+}
+
+void EQ::Net::ServertalkServerConnection::DispatchMessage(uint16_t opcode, EQ::Net::Packet &p)
+{
+	auto &stats = m_stats.opcodes[opcode];
+	stats.recv_messages++;
+	stats.recv_bytes += p.Length();
+
+	auto cb = m_message_callbacks.find(opcode);
+	if (cb != m_message_callbacks.end()) {
+		cb->second(opcode, p);
 	}
+
+	if (m_message_callback) {
+		m_message_callback(opcode, p);
+	}
+}
+
+void EQ::Net::ServertalkServerConnection::QueueBatch(uint16_t opcode, EQ::Net::Packet &p)
+{
+#ifdef ENABLE_SECURITY
+	//match the single message path so handlers see the same payload either way
+	if (m_encrypted && p.Length() == 0) {
+		p.PutUInt8(0, 0);
+	}
+#endif
+
+	auto idx = m_batch.Length();
+	m_batch.PutUInt32(idx, p.Length());
+	m_batch.PutUInt16(idx + 4, opcode);
+	if (p.Length() > 0) {
+		m_batch.PutPacket(idx + 6, p);
+	}
+
+	m_stats.batched_messages++;
+
+	if (m_batch.Length() >= ServertalkBatchMaxSize) {
+		FlushBatch();
+	}
+	else {
+		m_batch_timer->Start(0, false);
+	}
+}
+
+void EQ::Net::ServertalkServerConnection::FlushBatch()
+{
+	if (m_batch.Length() == 0) {
+		return;
+	}
+
+#ifdef ENABLE_SECURITY
+	if (m_encrypted) {
+		EQ::Net::DynamicPacket out;
+		out.Resize(m_batch.Length() + crypto_secretbox_MACBYTES);
+		crypto_box_easy_afternm((unsigned char*)out.Data(), (unsigned char*)m_batch.Data(), m_batch.Length(), m_nonce_ours, m_shared_key);
+		(*(uint64_t*)&m_nonce_ours[0])++;
+		InternalSend(ServertalkMessageBatch, out);
+	}
+	else {
+		InternalSend(ServertalkMessageBatch, m_batch);
+	}
+#else
+	InternalSend(ServertalkMessageBatch, m_batch);
+#endif
+
+	m_batch.Clear();
+	m_stats.batches_sent++;
 }
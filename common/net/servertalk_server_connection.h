@@ -1,7 +1,9 @@
 #pragma once
 
 #include "tcp_connection.h"
+#include "../event/timer.h"
 #include "servertalk_common.h"
+#include "servertalk_shared_memory.h"
 #include "packet.h"
 #include <vector>
 #ifdef ENABLE_SECURITY
@@ -21,6 +23,7 @@ namespace EQ
 
 			void Send(uint16_t opcode, EQ::Net::Packet &p);
 			void SendPacket(ServerPacket *p);
+			const ServertalkStats &GetStats() const { return m_stats; }
 			void OnMessage(uint16_t opcode, std::function<void(uint16_t, EQ::Net::Packet&)> cb);
 			void OnMessage(std::function<void(uint16_t, EQ::Net::Packet&)> cb);
 
@@ -36,6 +39,14 @@ namespace EQ
 			void ProcessHandshake(EQ::Net::Packet &p) { ProcessHandshake(p, false); }
 			void ProcessHandshake(EQ::Net::Packet &p, bool security_downgrade);
 			void ProcessMessage(EQ::Net::Packet &p);
+			void EnableBatching(uint8_t capabilities);
+			void OfferSharedMemory(uint8_t capabilities);
+			void ProcessSharedMemoryAccept(EQ::Net::Packet &p);
+			void ProcessMessageBatch(EQ::Net::Packet &p);
+			void DispatchBatch(EQ::Net::Packet &p);
+			void DispatchMessage(uint16_t opcode, EQ::Net::Packet &p);
+			void QueueBatch(uint16_t opcode, EQ::Net::Packet &p);
+			void FlushBatch();
 
 			std::shared_ptr<EQ::Net::TCPConnection> m_connection;
 			ServertalkServer *m_parent;
@@ -43,6 +54,16 @@ namespace EQ
 			std::vector<char> m_buffer;
 			std::unordered_map<uint16_t, std::function<void(uint16_t, EQ::Net::Packet&)>> m_message_callbacks;
 			std::function<void(uint16_t, EQ::Net::Packet&)> m_message_callback;
+
+			//small messages queued this tick, sealed and written as one ServertalkMessageBatch
+			bool m_batching;
+			EQ::Net::DynamicPacket m_batch;
+			std::unique_ptr<EQ::Timer> m_batch_timer;
+			ServertalkStats m_stats;
+
+			//same host peers move messages to a mapped ring once the client accepts, tcp stays up for liveness
+			std::unique_ptr<ServertalkSharedMemory> m_shared_memory;
+			bool m_shared_memory_active;
 			std::string m_identifier;
 			std::string m_uuid;
 
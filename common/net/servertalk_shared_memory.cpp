@@ -0,0 +1,364 @@
+#include "servertalk_shared_memory.h"
+#include "../eqemu_logsys.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+
+namespace {
+	const uint32_t ServertalkSharedMemoryMagic = 0x4d535453;
+	const size_t ServertalkSharedMemoryAlign = 64;
+}
+
+EQ::Net::ServertalkSharedMemory::ServertalkSharedMemory(const std::string &path, bool server)
+{
+	m_path = path;
+	m_server = server;
+	m_reading = false;
+	m_unlinked = false;
+	m_overflowed = false;
+	m_header = nullptr;
+	m_out = nullptr;
+	m_in = nullptr;
+	m_out_data = nullptr;
+	m_in_data = nullptr;
+	m_mask = 0;
+	m_poll_ms = ServertalkSharedMemoryMinPollMS;
+	m_poll_scheduled = false;
+}
+
+EQ::Net::ServertalkSharedMemory::~ServertalkSharedMemory()
+{
+	m_timer.reset();
+	m_file.reset();
+
+	if (m_server && !m_unlinked) {
+		std::remove(m_path.c_str());
+	}
+}
+
+std::unique_ptr<EQ::Net::ServertalkSharedMemory> EQ::Net::ServertalkSharedMemory::Create(const std::string &path, uint32_t ring_size, uint64_t token)
+{
+	//indexes are free running uint32s masked into the ring so the size has to be a power of two
+	if (ring_size < 4096 || ring_size > 0x40000000 || (ring_size & (ring_size - 1)) != 0) {
+		LogError("Servertalk shared memory ring size {0} must be a power of two between 4096 and 1GB", ring_size);
+		return nullptr;
+	}
+
+	std::unique_ptr<ServertalkSharedMemory> ret(new ServertalkSharedMemory(path, true));
+	std::unique_ptr<EQ::MemoryMappedFile> file;
+	try {
+		file.reset(new EQ::MemoryMappedFile(path, (uint32)(ServertalkSharedMemoryAlign + sizeof(Header) + 2 * (size_t)ring_size)));
+		file->ZeroFile();
+	}
+	catch (std::exception &ex) {
+		LogError("Could not create servertalk shared memory {0}: {1}", path, ex.what());
+		std::remove(path.c_str());
+		return nullptr;
+	}
+
+	auto base = (uintptr_t)file->Get();
+	auto header = (Header*)((base + ServertalkSharedMemoryAlign - 1) & ~(uintptr_t)(ServertalkSharedMemoryAlign - 1));
+	header->ring_size = ring_size;
+	header->token = token;
+	header->magic = ServertalkSharedMemoryMagic;
+
+	if (!ret->Map(std::move(file))) {
+		return nullptr;
+	}
+
+	return ret;
+}
+
+std::unique_ptr<EQ::Net::ServertalkSharedMemory> EQ::Net::ServertalkSharedMemory::Open(const std::string &path, uint64_t token)
+{
+	std::unique_ptr<ServertalkSharedMemory> ret(new ServertalkSharedMemory(path, false));
+	std::unique_ptr<EQ::MemoryMappedFile> file;
+	try {
+		file.reset(new EQ::MemoryMappedFile(path));
+	}
+	catch (std::exception &ex) {
+		LogError("Could not open servertalk shared memory {0}: {1}", path, ex.what());
+		return nullptr;
+	}
+
+	if (!ret->Map(std::move(file))) {
+		return nullptr;
+	}
+
+	//a stale file or one from another host with the same name will not carry the token we were sent
+	if (ret->m_header->token != token) {
+		LogError("Servertalk shared memory {0} does not belong to this connection", path);
+		return nullptr;
+	}
+
+	return ret;
+}
+
+std::string EQ::Net::ServertalkSharedMemory::Directory(const std::string &fallback)
+{
+	//the rings are rewritten constantly, a file on disk would have its dirty pages written back for nothing
+#ifdef __linux__
+	struct stat st;
+	if (stat("/dev/shm", &st) == 0 && S_ISDIR(st.st_mode)) {
+		return "/dev/shm/";
+	}
+#endif
+	return fallback;
+}
+
+bool EQ::Net::ServertalkSharedMemory::Map(std::unique_ptr<EQ::MemoryMappedFile> file)
+{
+	if (file->Size() < ServertalkSharedMemoryAlign + sizeof(Header)) {
+		LogError("Servertalk shared memory {0} is too small", m_path);
+		return false;
+	}
+
+	auto base = (uintptr_t)file->Get();
+	m_header = (Header*)((base + ServertalkSharedMemoryAlign - 1) & ~(uintptr_t)(ServertalkSharedMemoryAlign - 1));
+
+	auto ring_size = m_header->ring_size;
+	if (m_header->magic != ServertalkSharedMemoryMagic || ring_size == 0 || (ring_size & (ring_size - 1)) != 0 ||
+		file->Size() < ServertalkSharedMemoryAlign + sizeof(Header) + 2 * (size_t)ring_size) {
+		LogError("Servertalk shared memory {0} has an invalid header", m_path);
+		return false;
+	}
+
+	//ring 0 carries server to client, ring 1 client to server
+	auto data = (char*)m_header + sizeof(Header);
+	m_out = &m_header->rings[m_server ? 0 : 1];
+	m_in = &m_header->rings[m_server ? 1 : 0];
+	m_out_data = m_server ? data : data + ring_size;
+	m_in_data = m_server ? data + ring_size : data;
+	m_mask = ring_size - 1;
+	m_file = std::move(file);
+	return true;
+}
+
+bool EQ::Net::ServertalkSharedMemory::Send(uint16_t opcode, EQ::Net::Packet &p)
+{
+	if (m_overflowed) {
+		return false;
+	}
+
+	char header[6];
+	*(uint32_t*)&header[0] = (uint32_t)p.Length();
+	*(uint16_t*)&header[4] = opcode;
+
+	size_t header_written = 0;
+	size_t data_written = 0;
+	if (m_pending.empty()) {
+		header_written = Write(header, 6);
+		if (header_written == 6) {
+			data_written = Write((const char*)p.Data(), p.Length());
+		}
+
+		if (header_written > 0) {
+			RingDoorbell();
+		}
+
+		if (data_written == p.Length() && header_written == 6) {
+			return true;
+		}
+	}
+
+	if (m_pending.size() + 6 + p.Length() > ServertalkSharedMemoryMaxPending) {
+		LogError("Servertalk shared memory {0} peer stopped reading with {1} bytes waiting", m_path, m_pending.size());
+		m_overflowed = true;
+		m_pending.clear();
+		m_pending.shrink_to_fit();
+		return false;
+	}
+
+	//the ring is full, keep the rest in order and let the poll timer drain it as the reader catches up
+	m_pending.insert(m_pending.end(), header + header_written, header + 6);
+	m_pending.insert(m_pending.end(), (const char*)p.Data() + data_written, (const char*)p.Data() + p.Length());
+	m_poll_ms = ServertalkSharedMemoryMinPollMS;
+	SchedulePoll(m_poll_ms);
+	return true;
+}
+
+void EQ::Net::ServertalkSharedMemory::Start()
+{
+	m_reading = true;
+	Drain();
+}
+
+void EQ::Net::ServertalkSharedMemory::Wake()
+{
+	if (m_reading) {
+		Drain();
+	}
+}
+
+void EQ::Net::ServertalkSharedMemory::Unlink()
+{
+	//both ends have it mapped so the name is no longer needed, the memory lives until the last unmap
+	if (!m_unlinked) {
+		std::remove(m_path.c_str());
+		m_unlinked = true;
+	}
+}
+
+void EQ::Net::ServertalkSharedMemory::Poll()
+{
+	m_poll_scheduled = false;
+
+	bool progress = FlushPending();
+	if (progress) {
+		RingDoorbell();
+	}
+
+	if (m_pending.empty()) {
+		return;
+	}
+
+	m_poll_ms = progress ? ServertalkSharedMemoryMinPollMS : std::min(m_poll_ms * 2, (uint32_t)ServertalkSharedMemoryMaxPollMS);
+	SchedulePoll(m_poll_ms);
+}
+
+void EQ::Net::ServertalkSharedMemory::Drain()
+{
+	//the flag is raised before the last look at head and the writer checks it after moving head,
+	//so either we see the new data here or the writer sees the flag and rings
+	for (;;) {
+		Read();
+		m_in->sleeping.store(1, std::memory_order_seq_cst);
+		if (m_in->head.load(std::memory_order_seq_cst) == m_in->tail.load(std::memory_order_relaxed)) {
+			return;
+		}
+
+		m_in->sleeping.store(0, std::memory_order_relaxed);
+	}
+}
+
+void EQ::Net::ServertalkSharedMemory::RingDoorbell()
+{
+	if (m_out->sleeping.load(std::memory_order_seq_cst) != 0 && m_out->sleeping.exchange(0) != 0 && m_doorbell_callback) {
+		m_doorbell_callback();
+	}
+}
+
+void EQ::Net::ServertalkSharedMemory::SchedulePoll(uint32_t delay_ms)
+{
+	if (!m_timer) {
+		m_timer.reset(new EQ::Timer([this](EQ::Timer *t) {
+			Poll();
+		}));
+	}
+
+	if (m_poll_scheduled) {
+		return;
+	}
+
+	m_poll_scheduled = true;
+	m_timer->Start(delay_ms, false);
+}
+
+size_t EQ::Net::ServertalkSharedMemory::Write(const char *data, size_t length)
+{
+	if (length == 0) {
+		return 0;
+	}
+
+	auto head = m_out->head.load(std::memory_order_relaxed);
+	auto tail = m_out->tail.load(std::memory_order_acquire);
+	auto ring_size = m_mask + 1;
+	size_t count = std::min((size_t)(ring_size - (head - tail)), length);
+	if (count == 0) {
+		return 0;
+	}
+
+	auto pos = head & m_mask;
+	auto first = std::min(count, (size_t)(ring_size - pos));
+	memcpy(m_out_data + pos, data, first);
+	if (count > first) {
+		memcpy(m_out_data, data + first, count - first);
+	}
+
+	m_out->head.store(head + (uint32_t)count, std::memory_order_seq_cst);
+	return count;
+}
+
+bool EQ::Net::ServertalkSharedMemory::FlushPending()
+{
+	if (m_pending.empty()) {
+		return false;
+	}
+
+	auto written = Write(&m_pending[0], m_pending.size());
+	m_pending.erase(m_pending.begin(), m_pending.begin() + written);
+	return written > 0;
+}
+
+void EQ::Net::ServertalkSharedMemory::Read()
+{
+	auto head = m_in->head.load(std::memory_order_acquire);
+	auto tail = m_in->tail.load(std::memory_order_relaxed);
+	auto ring_size = m_mask + 1;
+
+	//whole messages that don't straddle the end of the ring are handed out without a copy
+	while (m_buffer.empty() && head - tail >= 6) {
+		auto pos = tail & m_mask;
+		if (pos + 6 > ring_size) {
+			break;
+		}
+
+		auto length = *(uint32_t*)(m_in_data + pos);
+		auto opcode = *(uint16_t*)(m_in_data + pos + 4);
+		if (head - tail < 6 + length || pos + 6 + length > ring_size) {
+			break;
+		}
+
+		if (length > 0 && m_message_callback) {
+			EQ::Net::StaticPacket packet(m_in_data + pos + 6, length);
+			m_message_callback(opcode, packet);
+		}
+
+		tail += 6 + length;
+		m_in->tail.store(tail, std::memory_order_release);
+	}
+
+	if (head == tail) {
+		return;
+	}
+
+	auto count = (size_t)(head - tail);
+	auto pos = tail & m_mask;
+	auto first = std::min(count, (size_t)(ring_size - pos));
+	m_buffer.insert(m_buffer.end(), m_in_data + pos, m_in_data + pos + first);
+	if (count > first) {
+		m_buffer.insert(m_buffer.end(), m_in_data, m_in_data + (count - first));
+	}
+
+	m_in->tail.store(head, std::memory_order_release);
+	ProcessReadBuffer();
+}
+
+void EQ::Net::ServertalkSharedMemory::ProcessReadBuffer()
+{
+	size_t current = 0;
+	size_t total = m_buffer.size();
+
+	while (total - current >= 6) {
+		auto length = *(uint32_t*)&m_buffer[current];
+		auto opcode = *(uint16_t*)&m_buffer[current + 4];
+		if (current + 6 + length > total) {
+			break;
+		}
+
+		if (length > 0 && m_message_callback) {
+			EQ::Net::StaticPacket packet(&m_buffer[current + 6], length);
+			m_message_callback(opcode, packet);
+		}
+
+		current += 6 + length;
+	}
+
+	if (current == total) {
+		m_buffer.clear();
+	}
+	else {
+		m_buffer.erase(m_buffer.begin(), m_buffer.begin() + current);
+	}
+}
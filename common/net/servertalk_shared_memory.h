@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../memory_mapped_file.h"
+#include "../event/timer.h"
+#include "packet.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace EQ
+{
+	namespace Net
+	{
+		enum
+		{
+			ServertalkSharedMemoryRingSize = 4 * 1024 * 1024,
+			//only used while our ring is full and we wait for the peer to make room
+			ServertalkSharedMemoryMinPollMS = 1,
+			ServertalkSharedMemoryMaxPollMS = 16,
+			//a peer this far behind has stopped reading, its connection is dropped rather than buffering forever
+			ServertalkSharedMemoryMaxPending = 64 * 1024 * 1024
+		};
+
+		//Two single producer single consumer byte rings in a mapped file, one per direction.
+		//Messages keep the servertalk length/opcode framing but are neither encrypted nor written to a socket.
+		//A reader that drained its ring raises a flag in it and sleeps, the next write that finds the flag
+		//rings the doorbell callback so the owner can wake the peer through the connection that stays open.
+		class ServertalkSharedMemory
+		{
+		public:
+			~ServertalkSharedMemory();
+
+			//server side, creates and zeroes the segment; nullptr on failure
+			static std::unique_ptr<ServertalkSharedMemory> Create(const std::string &path, uint32_t ring_size, uint64_t token);
+			//client side, maps an existing segment and checks its token; nullptr on failure
+			static std::unique_ptr<ServertalkSharedMemory> Open(const std::string &path, uint64_t token);
+			//a memory backed directory for the segments where the platform has one, otherwise fallback
+			static std::string Directory(const std::string &fallback);
+
+			//false once the peer fell too far behind, the caller should drop the connection
+			bool Send(uint16_t opcode, EQ::Net::Packet &p);
+			void OnMessage(std::function<void(uint16_t, EQ::Net::Packet&)> cb) { m_message_callback = cb; }
+			void OnDoorbell(std::function<void()> cb) { m_doorbell_callback = cb; }
+			void Start();
+			//the peer wrote into a ring we were sleeping on
+			void Wake();
+			void Unlink();
+			const std::string &GetPath() const { return m_path; }
+		private:
+			struct Ring
+			{
+				std::atomic<uint32_t> head;
+				char head_pad[60];
+				std::atomic<uint32_t> tail;
+				std::atomic<uint32_t> sleeping;
+				char tail_pad[56];
+			};
+
+			struct Header
+			{
+				uint32_t magic;
+				uint32_t ring_size;
+				uint64_t token;
+				char pad[48];
+				Ring rings[2];
+			};
+
+			ServertalkSharedMemory(const std::string &path, bool server);
+			bool Map(std::unique_ptr<EQ::MemoryMappedFile> file);
+			void Poll();
+			void Drain();
+			void RingDoorbell();
+			void SchedulePoll(uint32_t delay_ms);
+			size_t Write(const char *data, size_t length);
+			bool FlushPending();
+			void Read();
+			void ProcessReadBuffer();
+
+			std::string m_path;
+			bool m_server;
+			bool m_reading;
+			bool m_unlinked;
+			bool m_overflowed;
+			std::unique_ptr<EQ::MemoryMappedFile> m_file;
+			Header *m_header;
+			Ring *m_out;
+			Ring *m_in;
+			char *m_out_data;
+			char *m_in_data;
+			uint32_t m_mask;
+
+			//bytes that did not fit in the ring yet, written in order before anything newer
+			std::vector<char> m_pending;
+			std::vector<char> m_buffer;
+			std::unique_ptr<EQ::Timer> m_timer;
+			uint32_t m_poll_ms;
+			bool m_poll_scheduled;
+			std::function<void(uint16_t, EQ::Net::Packet&)> m_message_callback;
+			std::function<void()> m_doorbell_callback;
+		};
+	}
+}
@@ -161,6 +161,17 @@ void EQ::Net::WebsocketServer::DispatchEvent(WebsocketSubscriptionEvent evt, Jso
 	}
 }
 
+bool EQ::Net::WebsocketServer::HasSubscribers(WebsocketSubscriptionEvent evt, int required_status) const
+{
+	for (auto c : _impl->subscriptions[evt]) {
+		if (c->GetStatus() >= required_status) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 Json::Value EQ::Net::WebsocketServer::Login(WebsocketServerConnection *connection, const Json::Value &params)
 {
 	Json::Value ret;
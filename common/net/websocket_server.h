@@ -15,6 +15,7 @@ namespace EQ
 		{
 			SubscriptionEventNone,
 			SubscriptionEventLog,
+			SubscriptionEventEntityDelta,
 			SubscriptionEventMax
 		};
 
@@ -53,6 +54,7 @@ namespace EQ
 			void SetMethodHandler(const std::string& method, MethodHandler handler, int required_status);
 			void SetLoginHandler(LoginHandler handler);
 			void DispatchEvent(WebsocketSubscriptionEvent evt, Json::Value data = Json::Value(), int required_status = 0);
+			bool HasSubscribers(WebsocketSubscriptionEvent evt, int required_status = 0) const;
 		private:
 			void ReleaseConnection(WebsocketServerConnection *connection);
 			Json::Value HandleRequest(WebsocketServerConnection *connection, const std::string& method, const Json::Value &params);
@@ -32,6 +32,7 @@
 #include "../inventory_profile.h"
 #include "rof2_structs.h"
 #include "../rulesys.h"
+#include "../serialized_item_cache.h"
 
 #include <iostream>
 #include <sstream>
@@ -45,8 +46,10 @@ namespace RoF2
 	static const char *name = "RoF2";
 	static OpcodeManager *opcodes = nullptr;
 	static Strategy struct_strategy;
+	static EQ::SerializedItemCache item_cache;
 
 	void SerializeItem(EQ::OutBuffer& ob, const EQ::ItemInstance *inst, int16 slot_id, uint8 depth, ItemPacketType packet_type);
+	void SerializeItemBody(EQ::OutBuffer& ob, const EQ::ItemData *item);
 
 	// server to client inventory location converters
 	static inline structs::InventorySlot_Struct ServerToRoF2Slot(uint32 server_slot);
@@ -5346,103 +5349,8 @@ namespace RoF2
 		return NextItemInstSerialNumber;
 	}
 
-	void SerializeItem(EQ::OutBuffer& ob, const EQ::ItemInstance *inst, int16 slot_id_in, uint8 depth, ItemPacketType packet_type)
+	void SerializeItemBody(EQ::OutBuffer& ob, const EQ::ItemData *item)
 	{
-		const EQ::ItemData *item = inst->GetUnscaledItem();
-		
-		RoF2::structs::ItemSerializationHeader hdr;
-
-		//sprintf(hdr.unknown000, "06e0002Y1W00");
-
-		snprintf(hdr.unknown000, sizeof(hdr.unknown000), "%016d", item->ID);
-
-		hdr.stacksize = (inst->IsStackable() ? ((inst->GetCharges() > 1000) ? 0xFFFFFFFF : inst->GetCharges()) : 1);
-		hdr.unknown004 = 0;
-
-		structs::InventorySlot_Struct slot_id;
-		switch (packet_type) {
-		case ItemPacketLoot:
-			slot_id = ServerToRoF2CorpseSlot(slot_id_in);
-			break;
-		default:
-			slot_id = ServerToRoF2Slot(slot_id_in);
-			break;
-		}
-		
-		hdr.slot_type = (inst->GetMerchantSlot() ? invtype::typeMerchant : slot_id.Type);
-		hdr.main_slot = (inst->GetMerchantSlot() ? inst->GetMerchantSlot() : slot_id.Slot);
-		hdr.sub_slot = (inst->GetMerchantSlot() ? 0xffff : slot_id.SubIndex);
-		hdr.aug_slot = (inst->GetMerchantSlot() ? 0xffff : slot_id.AugIndex);
-		hdr.price = inst->GetPrice();
-		hdr.merchant_slot = (inst->GetMerchantSlot() ? inst->GetMerchantCount() : 1);
-		hdr.scaled_value = (inst->IsScaling() ? (inst->GetExp() / 100) : 0);
-		hdr.instance_id = (inst->GetMerchantSlot() ? inst->GetMerchantSlot() : inst->GetSerialNumber());
-		hdr.unknown028 = 0;
-		hdr.last_cast_time = inst->GetRecastTimestamp();
-		hdr.charges = (inst->IsStackable() ? (item->MaxCharges ? 1 : 0) : ((inst->GetCharges() > 254) ? 0xFFFFFFFF : inst->GetCharges()));
-		hdr.inst_nodrop = (inst->IsAttuned() ? 1 : 0);
-		hdr.unknown044 = 0;
-		hdr.unknown048 = 0;
-		hdr.unknown052 = 0;
-		hdr.isEvolving = item->EvolvingItem;
-
-		ob.write((const char*)&hdr, sizeof(RoF2::structs::ItemSerializationHeader));
-
-		if (item->EvolvingItem > 0) {
-			RoF2::structs::EvolvingItem evotop;
-
-			evotop.unknown001 = 0;
-			evotop.unknown002 = 0;
-			evotop.unknown003 = 0;
-			evotop.unknown004 = 0;
-			evotop.evoLevel = item->EvolvingLevel;
-			evotop.progress = 0;
-			evotop.Activated = 1;
-			evotop.evomaxlevel = item->EvolvingMax;
-
-			ob.write((const char*)&evotop, sizeof(RoF2::structs::EvolvingItem));
-		}
-
-		/**
-		 * Ornamentation
-		 */
-		int    ornamentation_augment_type = RuleI(Character, OrnamentationAugmentType);
-		uint32 ornamentation_icon         = (inst->GetOrnamentationIcon() ? inst->GetOrnamentationIcon() : 0);
-		uint32 hero_model                 = 0;
-
-		if (inst->GetOrnamentationIDFile()) {
-			hero_model = inst->GetOrnamentHeroModel(EQ::InventoryProfile::CalcMaterialFromSlot(slot_id_in));
-
-			char tmp[30];
-			memset(tmp, 0x0, 30);
-			sprintf(tmp, "IT%d", inst->GetOrnamentationIDFile());
-
-			//Mainhand
-			ob.write(tmp, strlen(tmp));
-			ob.write("\0", 1);
-
-			//Offhand
-			ob.write(tmp, strlen(tmp));
-			ob.write("\0", 1);
-		}
-		else {
-			ob.write("\0", 1); // no main hand Ornamentation
-			ob.write("\0", 1); // no off hand Ornamentation
-		}
-
-		RoF2::structs::ItemSerializationHeaderFinish hdrf;
-
-		hdrf.ornamentIcon = ornamentation_icon;
-		hdrf.unknowna1 = 0xffffffff;
-		hdrf.ornamentHeroModel = hero_model;
-		hdrf.unknown063 = 0;
-		hdrf.Copied = 0;
-		hdrf.unknowna4 = 0xffffffff;
-		hdrf.unknowna5 = 0;
-		hdrf.ItemClass = item->ItemClass;
-
-		ob.write((const char*)&hdrf, sizeof(RoF2::structs::ItemSerializationHeaderFinish));
-
 		if (strlen(item->Name) > 0)
 			ob.write(item->Name, strlen(item->Name));
 		ob.write("\0", 1);
@@ -5607,7 +5515,7 @@ namespace RoF2
 
 		itbs.potion_belt_enabled = item->PotionBelt;
 		itbs.potion_belt_slots = item->PotionBeltSlots;
-		itbs.stacksize = (inst->IsStackable() ? item->StackSize : 0);
+		itbs.stacksize = (item->Stackable ? item->StackSize : 0);
 		itbs.no_transfer = item->NoTransfer;
 		itbs.expendablearrow = item->ExpendableArrow;
 
@@ -5781,6 +5689,113 @@ namespace RoF2
 		iqbs.unknown39 = 1;
 		
 		ob.write((const char*)&iqbs, sizeof(RoF2::structs::ItemQuaternaryBodyStruct));
+	}
+
+	void SerializeItem(EQ::OutBuffer& ob, const EQ::ItemInstance *inst, int16 slot_id_in, uint8 depth, ItemPacketType packet_type)
+	{
+		const EQ::ItemData *item = inst->GetUnscaledItem();
+		
+		RoF2::structs::ItemSerializationHeader hdr;
+
+		//sprintf(hdr.unknown000, "06e0002Y1W00");
+
+		snprintf(hdr.unknown000, sizeof(hdr.unknown000), "%016d", item->ID);
+
+		hdr.stacksize = (inst->IsStackable() ? ((inst->GetCharges() > 1000) ? 0xFFFFFFFF : inst->GetCharges()) : 1);
+		hdr.unknown004 = 0;
+
+		structs::InventorySlot_Struct slot_id;
+		switch (packet_type) {
+		case ItemPacketLoot:
+			slot_id = ServerToRoF2CorpseSlot(slot_id_in);
+			break;
+		default:
+			slot_id = ServerToRoF2Slot(slot_id_in);
+			break;
+		}
+		
+		hdr.slot_type = (inst->GetMerchantSlot() ? invtype::typeMerchant : slot_id.Type);
+		hdr.main_slot = (inst->GetMerchantSlot() ? inst->GetMerchantSlot() : slot_id.Slot);
+		hdr.sub_slot = (inst->GetMerchantSlot() ? 0xffff : slot_id.SubIndex);
+		hdr.aug_slot = (inst->GetMerchantSlot() ? 0xffff : slot_id.AugIndex);
+		hdr.price = inst->GetPrice();
+		hdr.merchant_slot = (inst->GetMerchantSlot() ? inst->GetMerchantCount() : 1);
+		hdr.scaled_value = (inst->IsScaling() ? (inst->GetExp() / 100) : 0);
+		hdr.instance_id = (inst->GetMerchantSlot() ? inst->GetMerchantSlot() : inst->GetSerialNumber());
+		hdr.unknown028 = 0;
+		hdr.last_cast_time = inst->GetRecastTimestamp();
+		hdr.charges = (inst->IsStackable() ? (item->MaxCharges ? 1 : 0) : ((inst->GetCharges() > 254) ? 0xFFFFFFFF : inst->GetCharges()));
+		hdr.inst_nodrop = (inst->IsAttuned() ? 1 : 0);
+		hdr.unknown044 = 0;
+		hdr.unknown048 = 0;
+		hdr.unknown052 = 0;
+		hdr.isEvolving = item->EvolvingItem;
+
+		ob.write((const char*)&hdr, sizeof(RoF2::structs::ItemSerializationHeader));
+
+		if (item->EvolvingItem > 0) {
+			RoF2::structs::EvolvingItem evotop;
+
+			evotop.unknown001 = 0;
+			evotop.unknown002 = 0;
+			evotop.unknown003 = 0;
+			evotop.unknown004 = 0;
+			evotop.evoLevel = item->EvolvingLevel;
+			evotop.progress = 0;
+			evotop.Activated = 1;
+			evotop.evomaxlevel = item->EvolvingMax;
+
+			ob.write((const char*)&evotop, sizeof(RoF2::structs::EvolvingItem));
+		}
+
+		/**
+		 * Ornamentation
+		 */
+		int    ornamentation_augment_type = RuleI(Character, OrnamentationAugmentType);
+		uint32 ornamentation_icon         = (inst->GetOrnamentationIcon() ? inst->GetOrnamentationIcon() : 0);
+		uint32 hero_model                 = 0;
+
+		if (inst->GetOrnamentationIDFile()) {
+			hero_model = inst->GetOrnamentHeroModel(EQ::InventoryProfile::CalcMaterialFromSlot(slot_id_in));
+
+			char tmp[30];
+			memset(tmp, 0x0, 30);
+			sprintf(tmp, "IT%d", inst->GetOrnamentationIDFile());
+
+			//Mainhand
+			ob.write(tmp, strlen(tmp));
+			ob.write("\0", 1);
+
+			//Offhand
+			ob.write(tmp, strlen(tmp));
+			ob.write("\0", 1);
+		}
+		else {
+			ob.write("\0", 1); // no main hand Ornamentation
+			ob.write("\0", 1); // no off hand Ornamentation
+		}
+
+		RoF2::structs::ItemSerializationHeaderFinish hdrf;
+
+		hdrf.ornamentIcon = ornamentation_icon;
+		hdrf.unknowna1 = 0xffffffff;
+		hdrf.ornamentHeroModel = hero_model;
+		hdrf.unknown063 = 0;
+		hdrf.Copied = 0;
+		hdrf.unknowna4 = 0xffffffff;
+		hdrf.unknowna5 = 0;
+		hdrf.ItemClass = item->ItemClass;
+
+		ob.write((const char*)&hdrf, sizeof(RoF2::structs::ItemSerializationHeaderFinish));
+
+		const std::string *item_body = item_cache.Get(item);
+		if (item_body == nullptr) {
+			EQ::OutBuffer body;
+			SerializeItemBody(body, item);
+			item_body = &item_cache.Set(item, body.str());
+		}
+
+		ob.write(item_body->c_str(), item_body->size());
 
 		EQ::OutBuffer::pos_type count_pos = ob.tellp();
 		uint32 subitem_count = 0;
@@ -32,6 +32,7 @@
 #include "../item_instance.h"
 #include "sod_structs.h"
 #include "../rulesys.h"
+#include "../serialized_item_cache.h"
 
 #include <iostream>
 #include <sstream>
@@ -42,8 +43,10 @@ namespace SoD
 	static const char *name = "SoD";
 	static OpcodeManager *opcodes = nullptr;
 	static Strategy struct_strategy;
+	static EQ::SerializedItemCache item_cache;
 
 	void SerializeItem(EQ::OutBuffer& ob, const EQ::ItemInstance *inst, int16 slot_id, uint8 depth);
+	void SerializeItemBody(EQ::OutBuffer& ob, const EQ::ItemData *item);
 
 	// server to client inventory location converters
 	static inline uint32 ServerToSoDSlot(uint32 server_slot);
@@ -3440,37 +3443,8 @@ namespace SoD
 		return NextItemInstSerialNumber;
 	}
 
-	void SerializeItem(EQ::OutBuffer& ob, const EQ::ItemInstance *inst, int16 slot_id_in, uint8 depth)
+	void SerializeItemBody(EQ::OutBuffer& ob, const EQ::ItemData *item)
 	{
-		const EQ::ItemData *item = inst->GetUnscaledItem();
-		
-		SoD::structs::ItemSerializationHeader hdr;
-
-		hdr.stacksize = (inst->IsStackable() ? ((inst->GetCharges() > 254) ? 0xFFFFFFFF : inst->GetCharges()) : 1);
-		hdr.unknown004 = 0;
-
-		int32 slot_id = ServerToSoDSlot(slot_id_in);
-
-		hdr.slot = (inst->GetMerchantSlot() ? inst->GetMerchantSlot() : slot_id);
-		hdr.price = inst->GetPrice();
-		hdr.merchant_slot = (inst->GetMerchantSlot() ? inst->GetMerchantCount() : 1);
-		hdr.scaled_value = (inst->IsScaling() ? (inst->GetExp() / 100) : 0);
-		hdr.instance_id = (inst->GetMerchantSlot() ? inst->GetMerchantSlot() : inst->GetSerialNumber());
-		hdr.unknown028 = 0;
-		hdr.last_cast_time = inst->GetRecastTimestamp();
-		hdr.charges = (inst->IsStackable() ? (item->MaxCharges ? 1 : 0) : ((inst->GetCharges() > 254) ? 0xFFFFFFFF : inst->GetCharges()));
-		hdr.inst_nodrop = (inst->IsAttuned() ? 1 : 0);
-		hdr.unknown044 = 0;
-		hdr.unknown048 = 0;
-		hdr.unknown052 = 0;
-		hdr.unknown056 = 0;
-		hdr.unknown060 = 0;
-		hdr.unknown061 = 0;
-		hdr.unknown062 = 0;
-		hdr.ItemClass = item->ItemClass;
-
-		ob.write((const char*)&hdr, sizeof(SoD::structs::ItemSerializationHeader));
-
 		if (strlen(item->Name) > 0)
 			ob.write(item->Name, strlen(item->Name));
 		ob.write("\0", 1);
@@ -3627,7 +3601,7 @@ namespace SoD
 
 		itbs.potion_belt_enabled = item->PotionBelt;
 		itbs.potion_belt_slots = item->PotionBeltSlots;
-		itbs.stacksize = (inst->IsStackable() ? item->StackSize : 0);
+		itbs.stacksize = (item->Stackable ? item->StackSize : 0);
 		itbs.no_transfer = item->NoTransfer;
 		itbs.expendablearrow = item->ExpendableArrow;
 
@@ -3756,6 +3730,47 @@ namespace SoD
 		iqbs.Clairvoyance = item->Clairvoyance;
 		
 		ob.write((const char*)&iqbs, sizeof(SoD::structs::ItemQuaternaryBodyStruct));
+	}
+
+	void SerializeItem(EQ::OutBuffer& ob, const EQ::ItemInstance *inst, int16 slot_id_in, uint8 depth)
+	{
+		const EQ::ItemData *item = inst->GetUnscaledItem();
+		
+		SoD::structs::ItemSerializationHeader hdr;
+
+		hdr.stacksize = (inst->IsStackable() ? ((inst->GetCharges() > 254) ? 0xFFFFFFFF : inst->GetCharges()) : 1);
+		hdr.unknown004 = 0;
+
+		int32 slot_id = ServerToSoDSlot(slot_id_in);
+
+		hdr.slot = (inst->GetMerchantSlot() ? inst->GetMerchantSlot() : slot_id);
+		hdr.price = inst->GetPrice();
+		hdr.merchant_slot = (inst->GetMerchantSlot() ? inst->GetMerchantCount() : 1);
+		hdr.scaled_value = (inst->IsScaling() ? (inst->GetExp() / 100) : 0);
+		hdr.instance_id = (inst->GetMerchantSlot() ? inst->GetMerchantSlot() : inst->GetSerialNumber());
+		hdr.unknown028 = 0;
+		hdr.last_cast_time = inst->GetRecastTimestamp();
+		hdr.charges = (inst->IsStackable() ? (item->MaxCharges ? 1 : 0) : ((inst->GetCharges() > 254) ? 0xFFFFFFFF : inst->GetCharges()));
+		hdr.inst_nodrop = (inst->IsAttuned() ? 1 : 0);
+		hdr.unknown044 = 0;
+		hdr.unknown048 = 0;
+		hdr.unknown052 = 0;
+		hdr.unknown056 = 0;
+		hdr.unknown060 = 0;
+		hdr.unknown061 = 0;
+		hdr.unknown062 = 0;
+		hdr.ItemClass = item->ItemClass;
+
+		ob.write((const char*)&hdr, sizeof(SoD::structs::ItemSerializationHeader));
+
+		const std::string *item_body = item_cache.Get(item);
+		if (item_body == nullptr) {
+			EQ::OutBuffer body;
+			SerializeItemBody(body, item);
+			item_body = &item_cache.Set(item, body.str());
+		}
+
+		ob.write(item_body->c_str(), item_body->size());
 
 		EQ::OutBuffer::pos_type count_pos = ob.tellp();
 		uint32 subitem_count = 0;
@@ -32,6 +32,7 @@
 #include "../string_util.h"
 #include "../item_instance.h"
 #include "titanium_structs.h"
+#include "../serialized_item_cache.h"
 
 #include <sstream>
 
@@ -41,8 +42,10 @@ namespace Titanium
 	static const char *name = "Titanium";
 	static OpcodeManager *opcodes = nullptr;
 	static Strategy struct_strategy;
+	static EQ::SerializedItemCache item_cache;
 
 	void SerializeItem(EQ::OutBuffer& ob, const EQ::ItemInstance *inst, int16 slot_id_in, uint8 depth);
+	void SerializeItemBody(EQ::OutBuffer& ob, const EQ::ItemData *item);
 
 	// server to client inventory location converters
 	static inline int16 ServerToTitaniumSlot(uint32 server_slot);
@@ -2273,35 +2276,7 @@ namespace Titanium
 	}
 
 // file scope helper methods
-	void SerializeItem(EQ::OutBuffer& ob, const EQ::ItemInstance *inst, int16 slot_id_in, uint8 depth) {
-		const char *protection      = "\\\\\\\\\\";
-		const EQ::ItemData *item = inst->GetUnscaledItem();
-
-		ob << StringFormat(
-			"%.*s%s",
-			(depth ? (depth - 1) : 0),
-			protection,
-			(depth ? "\"" : "")); // For leading quotes (and protection) if a subitem;
-
-		// Instance data
-		ob << itoa((inst->IsStackable() ? inst->GetCharges() : 0)); // stack count
-		ob << '|' << itoa(0); // unknown
-		ob << '|' << itoa((!inst->GetMerchantSlot() ? slot_id_in : inst->GetMerchantSlot())); // inst slot/merchant slot
-		ob << '|' << itoa(inst->GetPrice()); // merchant price
-		ob << '|' << itoa((!inst->GetMerchantSlot() ? 1 : inst->GetMerchantCount())); // inst count/merchant count
-		ob << '|' << itoa((inst->IsScaling() ? (inst->GetExp() / 100) : 0)); // inst experience
-		ob << '|' << itoa((!inst->GetMerchantSlot() ? inst->GetSerialNumber()
-			: inst->GetMerchantSlot())); // merchant serial number
-		ob << '|' << itoa(inst->GetRecastTimestamp()); // recast timestamp
-		ob << '|' << itoa(((inst->IsStackable() ? ((inst->GetItem()->ItemType == EQ::item::ItemTypePotion) ? 1 : 0)
-			: inst->GetCharges()))); // charge count
-		ob << '|' << itoa((inst->IsAttuned() ? 1 : 0)); // inst attuned
-		ob << '|' << itoa(0); // unknown
-		ob << '|';
-
-		ob << StringFormat("%.*s\"", depth, protection); // Quotes (and protection, if needed) around static data
-
-		// Item data
+	void SerializeItemBody(EQ::OutBuffer& ob, const EQ::ItemData *item) {
 		ob << itoa(item->ItemClass);
 		ob << '|' << item->Name;
 		ob << '|' << item->Lore;
@@ -2498,6 +2473,45 @@ namespace Titanium
 		ob << '|' << itoa(item->Scroll.Level2);
 		ob << '|' << itoa(item->Scroll.Level);
 		ob << '|' << "0"; // Scroll name
+	}
+
+	void SerializeItem(EQ::OutBuffer& ob, const EQ::ItemInstance *inst, int16 slot_id_in, uint8 depth) {
+		const char *protection      = "\\\\\\\\\\";
+		const EQ::ItemData *item = inst->GetUnscaledItem();
+
+		ob << StringFormat(
+			"%.*s%s",
+			(depth ? (depth - 1) : 0),
+			protection,
+			(depth ? "\"" : "")); // For leading quotes (and protection) if a subitem;
+
+		// Instance data
+		ob << itoa((inst->IsStackable() ? inst->GetCharges() : 0)); // stack count
+		ob << '|' << itoa(0); // unknown
+		ob << '|' << itoa((!inst->GetMerchantSlot() ? slot_id_in : inst->GetMerchantSlot())); // inst slot/merchant slot
+		ob << '|' << itoa(inst->GetPrice()); // merchant price
+		ob << '|' << itoa((!inst->GetMerchantSlot() ? 1 : inst->GetMerchantCount())); // inst count/merchant count
+		ob << '|' << itoa((inst->IsScaling() ? (inst->GetExp() / 100) : 0)); // inst experience
+		ob << '|' << itoa((!inst->GetMerchantSlot() ? inst->GetSerialNumber()
+			: inst->GetMerchantSlot())); // merchant serial number
+		ob << '|' << itoa(inst->GetRecastTimestamp()); // recast timestamp
+		ob << '|' << itoa(((inst->IsStackable() ? ((inst->GetItem()->ItemType == EQ::item::ItemTypePotion) ? 1 : 0)
+			: inst->GetCharges()))); // charge count
+		ob << '|' << itoa((inst->IsAttuned() ? 1 : 0)); // inst attuned
+		ob << '|' << itoa(0); // unknown
+		ob << '|';
+
+		ob << StringFormat("%.*s\"", depth, protection); // Quotes (and protection, if needed) around static data
+
+		// Item data
+		const std::string *item_body = item_cache.Get(item);
+		if (item_body == nullptr) {
+			EQ::OutBuffer body;
+			SerializeItemBody(body, item);
+			item_body = &item_cache.Set(item, body.str());
+		}
+
+		ob.write(item_body->c_str(), item_body->size());
 
 		ob << StringFormat("%.*s\"", depth, protection); // Quotes (and protection, if needed) around static data
 
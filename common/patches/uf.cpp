@@ -32,6 +32,7 @@
 #include "../item_instance.h"
 #include "uf_structs.h"
 #include "../rulesys.h"
+#include "../serialized_item_cache.h"
 
 #include <iostream>
 #include <sstream>
@@ -42,8 +43,10 @@ namespace UF
 	static const char *name = "UF";
 	static OpcodeManager *opcodes = nullptr;
 	static Strategy struct_strategy;
+	static EQ::SerializedItemCache item_cache;
 
 	void SerializeItem(EQ::OutBuffer& ob, const EQ::ItemInstance *inst, int16 slot_id, uint8 depth);
+	void SerializeItemBody(EQ::OutBuffer& ob, const EQ::ItemData *item);
 
 	// server to client inventory location converters
 	static inline uint32 ServerToUFSlot(uint32 serverSlot);
@@ -3737,75 +3740,8 @@ namespace UF
 		return NextItemInstSerialNumber;
 	}
 
-	void SerializeItem(EQ::OutBuffer& ob, const EQ::ItemInstance *inst, int16 slot_id_in, uint8 depth)
+	void SerializeItemBody(EQ::OutBuffer& ob, const EQ::ItemData *item)
 	{
-		const EQ::ItemData *item = inst->GetUnscaledItem();
-		
-		UF::structs::ItemSerializationHeader hdr;
-
-		hdr.stacksize = (inst->IsStackable() ? ((inst->GetCharges() > 1000) ? 0xFFFFFFFF : inst->GetCharges()) : 1);
-		hdr.unknown004 = 0;
-
-		int32 slot_id = ServerToUFSlot(slot_id_in);
-
-		hdr.slot = (inst->GetMerchantSlot() ? inst->GetMerchantSlot() : slot_id);
-		hdr.price = inst->GetPrice();
-		hdr.merchant_slot = (inst->GetMerchantSlot() ? inst->GetMerchantCount() : 1);
-		hdr.scaled_value = (inst->IsScaling() ? (inst->GetExp() / 100) : 0);
-		hdr.instance_id = (inst->GetMerchantSlot() ? inst->GetMerchantSlot() : inst->GetSerialNumber());
-		hdr.unknown028 = 0;
-		hdr.last_cast_time = inst->GetRecastTimestamp();
-		hdr.charges = (inst->IsStackable() ? (item->MaxCharges ? 1 : 0) : ((inst->GetCharges() > 254) ? 0xFFFFFFFF : inst->GetCharges()));
-		hdr.inst_nodrop = (inst->IsAttuned() ? 1 : 0);
-		hdr.unknown044 = 0;
-		hdr.unknown048 = 0;
-		hdr.unknown052 = 0;
-		hdr.isEvolving = item->EvolvingItem;
-
-		ob.write((const char*)&hdr, sizeof(UF::structs::ItemSerializationHeader));
-
-		if (item->EvolvingItem > 0) {
-			UF::structs::EvolvingItem evotop;
-
-			evotop.unknown001 = 0;
-			evotop.unknown002 = 0;
-			evotop.unknown003 = 0;
-			evotop.unknown004 = 0;
-			evotop.evoLevel = item->EvolvingLevel;
-			evotop.progress = 0;
-			evotop.Activated = 1;
-			evotop.evomaxlevel = item->EvolvingMax;
-
-			ob.write((const char*)&evotop, sizeof(UF::structs::EvolvingItem));
-		}
-
-		//ORNAMENT IDFILE / ICON -
-		int ornamentationAugtype = RuleI(Character, OrnamentationAugmentType);
-		uint16 ornaIcon = 0;
-		if (inst->GetOrnamentationAug(ornamentationAugtype)) {
-			const EQ::ItemData *aug_weap = inst->GetOrnamentationAug(ornamentationAugtype)->GetItem();
-			ornaIcon = aug_weap->Icon;
-
-			ob.write(aug_weap->IDFile, strlen(aug_weap->IDFile));
-		}
-		else if (inst->GetOrnamentationIDFile() && inst->GetOrnamentationIcon()) {
-			ornaIcon = inst->GetOrnamentationIcon();
-			char tmp[30]; memset(tmp, 0x0, 30); sprintf(tmp, "IT%d", inst->GetOrnamentationIDFile());
-
-			ob.write(tmp, strlen(tmp));
-		}
-		ob.write("\0", 1);
-
-		UF::structs::ItemSerializationHeaderFinish hdrf;
-
-		hdrf.ornamentIcon = ornaIcon;
-		hdrf.unknown060 = 0; //This is Always 0.. or it breaks shit..
-		hdrf.unknown061 = 0; //possibly ornament / special ornament
-		hdrf.isCopied = 0; //Flag for item to be 'Copied'
-		hdrf.ItemClass = item->ItemClass;
-
-		ob.write((const char*)&hdrf, sizeof(UF::structs::ItemSerializationHeaderFinish));
-
 		if (strlen(item->Name) > 0)
 			ob.write(item->Name, strlen(item->Name));
 		ob.write("\0", 1);
@@ -3962,7 +3898,7 @@ namespace UF
 
 		itbs.potion_belt_enabled = item->PotionBelt;
 		itbs.potion_belt_slots = item->PotionBeltSlots;
-		itbs.stacksize = (inst->IsStackable() ? item->StackSize : 0);
+		itbs.stacksize = (item->Stackable ? item->StackSize : 0);
 		itbs.no_transfer = item->NoTransfer;
 		itbs.expendablearrow = item->ExpendableArrow;
 
@@ -4115,6 +4051,85 @@ namespace UF
 		iqbs.SubType = item->SubType;
 
 		ob.write((const char*)&iqbs, sizeof(UF::structs::ItemQuaternaryBodyStruct));
+	}
+
+	void SerializeItem(EQ::OutBuffer& ob, const EQ::ItemInstance *inst, int16 slot_id_in, uint8 depth)
+	{
+		const EQ::ItemData *item = inst->GetUnscaledItem();
+		
+		UF::structs::ItemSerializationHeader hdr;
+
+		hdr.stacksize = (inst->IsStackable() ? ((inst->GetCharges() > 1000) ? 0xFFFFFFFF : inst->GetCharges()) : 1);
+		hdr.unknown004 = 0;
+
+		int32 slot_id = ServerToUFSlot(slot_id_in);
+
+		hdr.slot = (inst->GetMerchantSlot() ? inst->GetMerchantSlot() : slot_id);
+		hdr.price = inst->GetPrice();
+		hdr.merchant_slot = (inst->GetMerchantSlot() ? inst->GetMerchantCount() : 1);
+		hdr.scaled_value = (inst->IsScaling() ? (inst->GetExp() / 100) : 0);
+		hdr.instance_id = (inst->GetMerchantSlot() ? inst->GetMerchantSlot() : inst->GetSerialNumber());
+		hdr.unknown028 = 0;
+		hdr.last_cast_time = inst->GetRecastTimestamp();
+		hdr.charges = (inst->IsStackable() ? (item->MaxCharges ? 1 : 0) : ((inst->GetCharges() > 254) ? 0xFFFFFFFF : inst->GetCharges()));
+		hdr.inst_nodrop = (inst->IsAttuned() ? 1 : 0);
+		hdr.unknown044 = 0;
+		hdr.unknown048 = 0;
+		hdr.unknown052 = 0;
+		hdr.isEvolving = item->EvolvingItem;
+
+		ob.write((const char*)&hdr, sizeof(UF::structs::ItemSerializationHeader));
+
+		if (item->EvolvingItem > 0) {
+			UF::structs::EvolvingItem evotop;
+
+			evotop.unknown001 = 0;
+			evotop.unknown002 = 0;
+			evotop.unknown003 = 0;
+			evotop.unknown004 = 0;
+			evotop.evoLevel = item->EvolvingLevel;
+			evotop.progress = 0;
+			evotop.Activated = 1;
+			evotop.evomaxlevel = item->EvolvingMax;
+
+			ob.write((const char*)&evotop, sizeof(UF::structs::EvolvingItem));
+		}
+
+		//ORNAMENT IDFILE / ICON -
+		int ornamentationAugtype = RuleI(Character, OrnamentationAugmentType);
+		uint16 ornaIcon = 0;
+		if (inst->GetOrnamentationAug(ornamentationAugtype)) {
+			const EQ::ItemData *aug_weap = inst->GetOrnamentationAug(ornamentationAugtype)->GetItem();
+			ornaIcon = aug_weap->Icon;
+
+			ob.write(aug_weap->IDFile, strlen(aug_weap->IDFile));
+		}
+		else if (inst->GetOrnamentationIDFile() && inst->GetOrnamentationIcon()) {
+			ornaIcon = inst->GetOrnamentationIcon();
+			char tmp[30]; memset(tmp, 0x0, 30); sprintf(tmp, "IT%d", inst->GetOrnamentationIDFile());
+
+			ob.write(tmp, strlen(tmp));
+		}
+		ob.write("\0", 1);
+
+		UF::structs::ItemSerializationHeaderFinish hdrf;
+
+		hdrf.ornamentIcon = ornaIcon;
+		hdrf.unknown060 = 0; //This is Always 0.. or it breaks shit..
+		hdrf.unknown061 = 0; //possibly ornament / special ornament
+		hdrf.isCopied = 0; //Flag for item to be 'Copied'
+		hdrf.ItemClass = item->ItemClass;
+
+		ob.write((const char*)&hdrf, sizeof(UF::structs::ItemSerializationHeaderFinish));
+
+		const std::string *item_body = item_cache.Get(item);
+		if (item_body == nullptr) {
+			EQ::OutBuffer body;
+			SerializeItemBody(body, item);
+			item_body = &item_cache.Set(item, body.str());
+		}
+
+		ob.write(item_body->c_str(), item_body->size());
 
 		EQ::OutBuffer::pos_type count_pos = ob.tellp();
 		uint32 subitem_count = 0;
@@ -60,11 +60,43 @@ const RuleManager::RuleInfo RuleManager::s_RuleInfo[_IntRuleCount+_RealRuleCount
 
 RuleManager::RuleManager()
 :	m_activeRuleset(0),
-	m_activeName("default")
+	m_activeName("default"),
+	m_published(nullptr),
+	m_publishHold(0)
 {
 	ResetRules(false);
 }
 
+RuleManager::~RuleManager()
+{
+}
+
+void RuleManager::_PublishRules()
+{
+	if (m_publishHold > 0)
+		return;
+
+	//the previous snapshot is freed here unless a ReadScope still holds it; main thread readers
+	//never keep the raw pointer past the read, and this runs on the main thread
+	std::shared_ptr<const RuleValues> snapshot(new RuleValues(m_working));
+	m_published.store(snapshot.get(), std::memory_order_release);
+	std::atomic_store(&m_current, snapshot);
+}
+
+thread_local const RuleManager::RuleValues *RuleManager::s_pinned = nullptr;
+
+RuleManager::ReadScope::ReadScope()
+:	m_snapshot(std::atomic_load(&RuleManager::Instance()->m_current)),
+	m_previous(s_pinned)
+{
+	s_pinned = m_snapshot.get();
+}
+
+RuleManager::ReadScope::~ReadScope()
+{
+	s_pinned = m_previous;
+}
+
 RuleManager::CategoryType RuleManager::FindCategory(const char *catname) {
 	int i;
 	for (i = 0; i < _CatCount; i++) {
@@ -111,13 +143,13 @@ bool RuleManager::GetRule(const char *rule_name, std::string &return_value) {
 	char tmp[255] = "";
 	switch(type) {
 		case IntRule:
-			sprintf(tmp, "%i", m_RuleIntValues[index]);
+			sprintf(tmp, "%i", m_working.IntValues[index]);
 			break;
 		case RealRule:
-			sprintf(tmp, "%f", m_RuleRealValues[index]);
+			sprintf(tmp, "%f", m_working.RealValues[index]);
 			break;
 		case BoolRule:
-			std::string tmp_val = m_RuleBoolValues[index] ? "true" : "false";
+			std::string tmp_val = m_working.BoolValues[index] ? "true" : "false";
 			sprintf(tmp, "%s", tmp_val.c_str());
 			break;
 	}
@@ -145,23 +177,25 @@ bool RuleManager::SetRule(const char *rule_name, const char *rule_value, Databas
 
 	switch(type) {
 		case IntRule:
-			m_RuleIntValues[index] = atoi(rule_value);
-			LogRules("Set rule [{}] to value [{}]", rule_name, m_RuleIntValues[index]);
+			m_working.IntValues[index] = atoi(rule_value);
+			LogRules("Set rule [{}] to value [{}]", rule_name, m_working.IntValues[index]);
 			break;
 		case RealRule:
-			m_RuleRealValues[index] = atof(rule_value);
-			LogRules("Set rule [{}] to value [{}]", rule_name, m_RuleRealValues[index]);
+			m_working.RealValues[index] = atof(rule_value);
+			LogRules("Set rule [{}] to value [{}]", rule_name, m_working.RealValues[index]);
 			break;
 		case BoolRule:
 			uint32 val = 0;
 			if (!strcasecmp(rule_value, "on") || !strcasecmp(rule_value, "true") || !strcasecmp(rule_value, "yes") || !strcasecmp(rule_value, "enabled") || !strcmp(rule_value, "1"))
 				val = 1;
 
-			m_RuleBoolValues[index] = val;
-			LogRules("Set rule [{}] to value [{}]", rule_name, m_RuleBoolValues[index] == 1 ? "true" : "false");
+			m_working.BoolValues[index] = val;
+			LogRules("Set rule [{}] to value [{}]", rule_name, m_working.BoolValues[index] == 1 ? "true" : "false");
 			break;
 	}
 
+	_PublishRules();
+
 	if(db_save)
 		_SaveRule(database, type, index);
 
@@ -178,13 +212,15 @@ void RuleManager::ResetRules(bool reload) {
 		GetRule("World:UseClientBasedExpansionSettings", expansion2);
 	}
 
+	++m_publishHold;
+
 	Log(Logs::Detail, Logs::Rules, "Resetting running rules to default values");
 	#define RULE_INT(cat, rule, default_value, notes) \
-		m_RuleIntValues[ Int__##rule ] = default_value;
+		m_working.IntValues[ Int__##rule ] = default_value;
 	#define RULE_REAL(cat, rule, default_value, notes) \
-		m_RuleRealValues[ Real__##rule ] = default_value;
+		m_working.RealValues[ Real__##rule ] = default_value;
 	#define RULE_BOOL(cat, rule, default_value, notes) \
-		m_RuleBoolValues[ Bool__##rule ] = default_value;
+		m_working.BoolValues[ Bool__##rule ] = default_value;
 	#include "ruletypes.h"
 
 	// restore these rules to their pre-reset values
@@ -192,6 +228,9 @@ void RuleManager::ResetRules(bool reload) {
 		SetRule("World:ExpansionSettings", expansion1.c_str(), nullptr, false, false);
 		SetRule("World:UseClientBasedExpansionSettings", expansion2.c_str(), nullptr, false, false);
 	}
+
+	--m_publishHold;
+	_PublishRules();
 }
 
 bool RuleManager::_FindRule(const char *rule_name, RuleType &type_into, uint16 &index_into) {
@@ -245,6 +284,17 @@ const std::string &RuleManager::_GetRuleNotes(RuleType type, uint16 index) {
 }
 
 bool RuleManager::LoadRules(Database *database, const char *ruleset_name, bool reload) {
+	++m_publishHold;
+	bool loaded = _LoadRules(database, ruleset_name, reload);
+	--m_publishHold;
+
+	// publish even a partial load, the working copy already holds whatever was applied
+	_PublishRules();
+
+	return loaded;
+}
+
+bool RuleManager::_LoadRules(Database *database, const char *ruleset_name, bool reload) {
 
 	int ruleset_id = this->GetRulesetID(database, ruleset_name);
 	if (ruleset_id < 0) {
@@ -350,13 +400,13 @@ void RuleManager::_SaveRule(Database *database, RuleType type, uint16 index) {
 	
 	switch (type) {
 		case IntRule:
-			sprintf(value_string, "%d", m_RuleIntValues[index]);
+			sprintf(value_string, "%d", m_working.IntValues[index]);
 			break;
 		case RealRule:
-			sprintf(value_string, "%.13f", m_RuleRealValues[index]);
+			sprintf(value_string, "%.13f", m_working.RealValues[index]);
 			break;
 		case BoolRule:
-			sprintf(value_string, "%s", m_RuleBoolValues[index] ? "true" : "false");
+			sprintf(value_string, "%s", m_working.BoolValues[index] ? "true" : "false");
 			break;
 	}
 
@@ -411,17 +461,17 @@ bool RuleManager::UpdateInjectedRules(Database *db, const char *ruleset_name, bo
 
 		switch (ri_iter.type) {
 		case IntRule:
-			sprintf(buffer, "%d", m_RuleIntValues[ri_iter.rule_index]);
+			sprintf(buffer, "%d", m_working.IntValues[ri_iter.rule_index]);
 			rule_data[ri_iter.name].first = buffer;
 			rule_data[ri_iter.name].second = &ri_iter.notes;
 			break;
 		case RealRule:
-			sprintf(buffer, "%.13f", m_RuleRealValues[ri_iter.rule_index]);
+			sprintf(buffer, "%.13f", m_working.RealValues[ri_iter.rule_index]);
 			rule_data[ri_iter.name].first = buffer;
 			rule_data[ri_iter.name].second = &ri_iter.notes;
 			break;
 		case BoolRule:
-			sprintf(buffer, "%s", (m_RuleBoolValues[ri_iter.rule_index] ? "true" : "false"));
+			sprintf(buffer, "%s", (m_working.BoolValues[ri_iter.rule_index] ? "true" : "false"));
 			rule_data[ri_iter.name].first = buffer;
 			rule_data[ri_iter.name].second = &ri_iter.notes;
 			break;
@@ -666,18 +716,3 @@ bool RuleManager::ListRulesets(Database *database, std::map<int, std::string> &i
 	return true;
 }
 
-int32 RuleManager::GetIntRule(RuleManager::IntType t) const
-{
-	return (m_RuleIntValues[t]);
-}
-
-float RuleManager::GetRealRule(RuleManager::RealType t) const
-{
-	return (m_RuleRealValues[t]);
-}
-
-bool RuleManager::GetBoolRule(RuleManager::BoolType t) const
-{
-	return (m_RuleBoolValues[t] == 1);
-}
-
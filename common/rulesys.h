@@ -24,6 +24,13 @@
 * - RuleR(category, rule) -> fetch a real (float) rule's value
 * - RuleB(category, rule) -> fetch a boolean/flag rule's value
 *
+* Values are read from an immutable snapshot published through an atomic pointer.
+* SetRule/LoadRules/ResetRules modify a private working copy and publish a new
+* snapshot when they are done, so a reader never sees a half applied reload.
+* Publishing happens on the main thread, which is the only thread that may read
+* rules without pinning. Work running on any other thread wraps each unit of work
+* in a RuleManager::ReadScope, which keeps the snapshot it saw alive until it ends.
+*
 */
 
 //note, these macros assume there is always a RuleManager *rules in scope,
@@ -40,6 +47,8 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <atomic>
+#include <memory>
 
 #include "types.h"
 
@@ -88,10 +97,35 @@ public:
 
 	static const uint32 _RulesCount = _IntRuleCount+_RealRuleCount+_BoolRuleCount;
 
+	//one published set of rule values, never modified once published
+	struct RuleValues {
+#ifdef WIN64
+		uint32	IntValues [_IntRuleCount ];
+#else
+		int IntValues [_IntRuleCount ];
+#endif
+		float	RealValues[_RealRuleCount];
+		uint32	BoolValues[_BoolRuleCount];
+	};
+
 	//fetch routines, you should generally use the Rule* macros instead of this
-	int32 GetIntRule (IntType t) const;
-	float GetRealRule(RealType t) const;
-	bool GetBoolRule(BoolType t) const;
+	int32 GetIntRule (IntType t) const { return (_Values()->IntValues[t]); }
+	float GetRealRule(RealType t) const { return (_Values()->RealValues[t]); }
+	bool GetBoolRule(BoolType t) const { return (_Values()->BoolValues[t] == 1); }
+
+	//pins the current snapshot for the calling thread until destroyed, so Rule* reads made off the
+	//main thread stay valid across a reload; scopes nest, and each unit of work should open its own
+	class ReadScope {
+	public:
+		ReadScope();
+		~ReadScope();
+	private:
+		ReadScope(const ReadScope&);
+		const ReadScope& operator=(const ReadScope&);
+
+		std::shared_ptr<const RuleValues> m_snapshot;
+		const RuleValues *m_previous;
+	};
 
 	//management routines
 	static const char *GetRuleName(IntType t) { return(s_RuleInfo[t].name); }
@@ -122,18 +156,24 @@ public:
 
 private:
 	RuleManager();
+	~RuleManager();
 	RuleManager(const RuleManager&);
 	const RuleManager& operator=(const RuleManager&);
 
+	//the snapshot a ReadScope pinned on this thread, or m_published on the main thread
+	const RuleValues *_Values() const {
+		const RuleValues *pinned = s_pinned;
+		return pinned ? pinned : m_published.load(std::memory_order_acquire);
+	}
+
 	int	m_activeRuleset;
 	std::string m_activeName;
-#ifdef WIN64
-	uint32	m_RuleIntValues [_IntRuleCount ];
-#else
-	int m_RuleIntValues [_IntRuleCount ];
-#endif
-	float	m_RuleRealValues[_RealRuleCount];
-	uint32	m_RuleBoolValues[_BoolRuleCount];
+	RuleValues m_working;
+	std::shared_ptr<const RuleValues> m_current;
+	std::atomic<const RuleValues *> m_published;
+	int m_publishHold;
+
+	static thread_local const RuleValues *s_pinned;
 
 	typedef enum {
 		IntRule,
@@ -146,6 +186,8 @@ private:
 	static const std::string &_GetRuleNotes(RuleType type, uint16 index);
 	static int _FindOrCreateRuleset(Database *db, const char *ruleset);
 	void _SaveRule(Database *db, RuleType type, uint16 index);
+	bool _LoadRules(Database *db, const char *ruleset, bool reload);
+	void _PublishRules();
 	
 	static const char *s_categoryNames[];
 	typedef struct {
@@ -281,6 +281,8 @@ RULE_BOOL(Zone, EnableZoneControllerGlobals, false, "Enables the ability to use
 RULE_INT(Zone, GlobalLootMultiplier, 1, "Sets Global Loot drop multiplier for database based drops, useful for double, triple loot etc")
 RULE_BOOL(Zone, KillProcessOnDynamicShutdown, true, "When process has booted a zone and has hit its zone shut down timer, it will hard kill the process to free memory back to the OS")
 RULE_INT(Zone, SecondsBeforeIdle, 60, "Seconds before IDLE_WHEN_EMPTY define kicks in")
+RULE_INT(Zone, ApiEntityDeltaMS, 250, "How often entity changes are pushed to websocket API subscribers, in milliseconds")
+RULE_REAL(Zone, ApiEntityDeltaMoveThreshold, 5.0, "Distance a mob has to move since its last pushed position before websocket API subscribers are told")
 RULE_CATEGORY_END()
 
 RULE_CATEGORY(Map)
@@ -706,6 +708,12 @@ RULE_INT(Network, ResendDelayMinMS, 300, "")
 RULE_INT(Network, ResendDelayMaxMS, 5000, "")
 RULE_REAL(Network, ClientDataRate, 0.0, "KB / sec, 0.0 disabled")
 RULE_BOOL(Network, CompressZoneStream, true, "")
+RULE_INT(Network, CompressionLevel, 1, "zlib level used for compressed client streams, 1 (fastest) to 9 (smallest)")
+RULE_INT(Network, CompressionMinSize, 30, "Client packets with payloads this size or smaller are sent uncompressed")
+RULE_BOOL(Network, CongestionControl, false, "Pace client sends with an adaptive AIMD window and RTT based resend delays. ClientDataRate becomes a cap instead of a budget that drops packets")
+RULE_INT(Network, CongestionWindowMax, 262144, "Largest congestion window in bytes when CongestionControl is on")
+RULE_BOOL(Network, ServertalkBatching, true, "Let zones coalesce small world messages sent in the same tick into one encrypted frame")
+RULE_BOOL(Network, ServertalkSharedMemory, true, "Move servertalk traffic from zones on the same host as world onto a shared memory ring instead of loopback tcp")
 RULE_CATEGORY_END()
 
 RULE_CATEGORY(QueryServ)
@@ -773,6 +781,7 @@ RULE_CATEGORY(HotReload)
 RULE_BOOL(HotReload, QuestsRepopWithReload, true, "When a hot reload is triggered, the zone will repop")
 RULE_BOOL(HotReload, QuestsRepopWhenPlayersNotInCombat, true, "When a hot reload is triggered, the zone will repop when no clients are in combat")
 RULE_BOOL(HotReload, QuestsResetTimersWithReload, true, "When a hot reload is triggered, quest timers will be reset")
+RULE_BOOL(HotReload, QuestsWatchFiles, false, "Watch the zone's quest, plugin and module directories and reload only the scripts whose files changed, along with the scripts that depend on them")
 RULE_CATEGORY_END()
 
 RULE_CATEGORY(Instances)
@@ -781,6 +790,14 @@ RULE_BOOL(Instances, RecycleInstanceIds, true, "Will recycle free instance ids i
 RULE_INT(Instances, GuildHallExpirationDays, 90, "Amount of days before a Guild Hall instance expires")
 RULE_CATEGORY_END()
 
+RULE_CATEGORY(Quest)
+RULE_BOOL(Quest, PerlLazyExport, false, "Perl mob and zone event variables are computed when a script first reads them. Takes effect on quest reload")
+RULE_INT(Quest, ParallelEncounterThreads, 2, "Worker threads that run parallel Lua encounters, read when the first one loads")
+RULE_INT(Quest, ParallelEncounterTickMS, 250, "How often parallel Lua encounters tick, in milliseconds")
+RULE_INT(Quest, ParallelEncounterInstructionLimit, 10000000, "Lua instructions one call into a parallel encounter may run before it is stopped with an error")
+RULE_INT(Quest, ParallelEncounterTickTimeoutMS, 100, "How long the zone waits on a parallel encounter's tick before abandoning that encounter")
+RULE_CATEGORY_END()
+
 #undef RULE_CATEGORY
 #undef RULE_INT
 #undef RULE_REAL
@@ -0,0 +1,67 @@
+/*	EQEMu: Everquest Server Emulator
+	
+	Copyright (C) 2001-2020 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+	
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+	
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "serialized_item_cache.h"
+#include "item_data.h"
+
+
+uint32 EQ::SerializedItemCache::s_generation = 0;
+
+EQ::SerializedItemCache::SerializedItemCache() : m_generation(s_generation)
+{
+}
+
+const std::string *EQ::SerializedItemCache::Get(const ItemData *item)
+{
+	if (!item)
+		return nullptr;
+
+	if (m_generation != s_generation) {
+		Clear();
+		return nullptr;
+	}
+
+	auto iter = m_entries.find(item->ID);
+	if (iter == m_entries.end())
+		return nullptr;
+
+	return &iter->second;
+}
+
+const std::string &EQ::SerializedItemCache::Set(const ItemData *item, const std::string &data)
+{
+	if (m_generation != s_generation)
+		Clear();
+
+	std::string &entry = m_entries[item->ID];
+	entry = data;
+
+	return entry;
+}
+
+void EQ::SerializedItemCache::Clear()
+{
+	m_entries.clear();
+	m_generation = s_generation;
+}
+
+void EQ::SerializedItemCache::InvalidateAll()
+{
+	++s_generation;
+}
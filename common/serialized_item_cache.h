@@ -0,0 +1,58 @@
+/*	EQEMu: Everquest Server Emulator
+	
+	Copyright (C) 2001-2020 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+	
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+	
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef COMMON_SERIALIZED_ITEM_CACHE_H
+#define COMMON_SERIALIZED_ITEM_CACHE_H
+
+#include "types.h"
+
+#include <string>
+#include <unordered_map>
+
+
+namespace EQ
+{
+	struct ItemData;
+
+	// Holds the client-specific serialization of the static ItemData portion of an item packet.
+	// Each patch owns one of these, so entries are effectively keyed by (item id, client version).
+	// The per-instance header and bag contents are never cached.
+	class SerializedItemCache {
+	public:
+		SerializedItemCache();
+
+		const std::string *Get(const ItemData *item);
+		const std::string &Set(const ItemData *item, const std::string &data);
+
+		void Clear();
+		size_t Size() const { return m_entries.size(); }
+
+		// invalidates every cache instance, called whenever the item shared memory is (re)loaded
+		static void InvalidateAll();
+
+	private:
+		std::unordered_map<uint32, std::string> m_entries;
+		uint32 m_generation;
+
+		static uint32 s_generation;
+	};
+
+} /*EQEmu*/
+
+#endif /*COMMON_SERIALIZED_ITEM_CACHE_H*/
@@ -35,6 +35,7 @@
 #include "memory_mapped_file.h"
 #include "mysql.h"
 #include "rulesys.h"
+#include "serialized_item_cache.h"
 #include "shareddb.h"
 #include "string_util.h"
 #include "eqemu_config.h"
@@ -920,6 +921,7 @@ bool SharedDatabase::LoadItems(const std::string &prefix) {
 		items_mmf = std::unique_ptr<EQ::MemoryMappedFile>(new EQ::MemoryMappedFile(file_name));
 		items_hash = std::unique_ptr<EQ::FixedMemoryHashSet<EQ::ItemData>>(new EQ::FixedMemoryHashSet<EQ::ItemData>(reinterpret_cast<uint8*>(items_mmf->Get()), items_mmf->Size()));
 		mutex.Unlock();
+		EQ::SerializedItemCache::InvalidateAll();
 	} catch(std::exception& ex) {
 		LogError("Error Loading Items: {}", ex.what());
 		return false;
@@ -1195,15 +1197,11 @@ const EQ::ItemData *SharedDatabase::GetItem(uint32 id)
 		return nullptr;
 	}
 
-	if (!items_hash || id > items_hash->max_key()) {
+	if (!items_hash) {
 		return nullptr;
 	}
 
-	if (items_hash->exists(id)) {
-		return &(items_hash->at(id));
-	}
-
-	return nullptr;
+	return items_hash->find(id);
 }
 
 const EQ::ItemData* SharedDatabase::IterateItems(uint32* id) {
@@ -1216,10 +1214,9 @@ const EQ::ItemData* SharedDatabase::IterateItems(uint32* id) {
 			break;
 		}
 
-		if(items_hash->exists(*id)) {
-			return &(items_hash->at((*id)++));
-		} else {
-			++(*id);
+		const EQ::ItemData *item = items_hash->find((*id)++);
+		if(item) {
+			return item;
 		}
 	}
 
@@ -1276,11 +1273,7 @@ const NPCFactionList* SharedDatabase::GetNPCFactionEntry(uint32 id) {
 		return nullptr;
 	}
 
-	if(faction_hash->exists(id)) {
-		return &(faction_hash->at(id));
-	}
-
-	return nullptr;
+	return faction_hash->find(id);
 }
 
 void SharedDatabase::LoadNPCFactionLists(void *data, uint32 size, uint32 list_count, uint32 max_lists) {
@@ -0,0 +1,136 @@
+#include "behavior.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+	const float WanderRadius = 50.0f;
+	const float WanderStep = 8.0f;
+	const uint32_t ChatChannelSay = 8;
+
+	const char *ChatLines[] = {
+		"Hail",
+		"Anyone up for a group?",
+		"LFG",
+		"Selling rusty daggers cheap",
+		"Train to zone!"
+	};
+}
+
+Behavior::Behavior() : m_random(std::random_device()())
+{
+}
+
+uint32_t Behavior::PickSpawn(const EverQuest &eq, bool npc)
+{
+	std::vector<uint32_t> candidates;
+	for (auto &s : eq.GetSpawns()) {
+		if (s.first != eq.GetSpawnId() && s.second.npc == npc) {
+			candidates.push_back(s.first);
+		}
+	}
+
+	if (candidates.empty()) {
+		return 0;
+	}
+
+	return candidates[Roll((int)candidates.size() - 1)];
+}
+
+int Behavior::Roll(int max)
+{
+	return std::uniform_int_distribution<int>(0, max)(m_random);
+}
+
+WanderBehavior::WanderBehavior()
+{
+	m_anchored = false;
+	m_x = 0.0f;
+	m_y = 0.0f;
+	m_z = 0.0f;
+	m_heading = 0.0f;
+}
+
+void WanderBehavior::Tick(EverQuest &eq)
+{
+	//random walk around the zone safe point so thousands of clients spread out without a map
+	if (!m_anchored) {
+		m_x = eq.GetSafeX();
+		m_y = eq.GetSafeY();
+		m_z = eq.GetSafeZ();
+		m_anchored = true;
+	}
+
+	m_heading = (float)Roll(511);
+	auto radians = m_heading * 3.14159265f / 256.0f;
+	auto x = m_x + std::sin(radians) * WanderStep;
+	auto y = m_y + std::cos(radians) * WanderStep;
+
+	if (std::hypot(x - eq.GetSafeX(), y - eq.GetSafeY()) <= WanderRadius) {
+		m_x = x;
+		m_y = y;
+	}
+
+	eq.ZoneSendPosition(m_x, m_y, m_z, m_heading);
+}
+
+FightBehavior::FightBehavior()
+{
+	m_target = 0;
+}
+
+void FightBehavior::Tick(EverQuest &eq)
+{
+	auto &spawns = eq.GetSpawns();
+	if (m_target != 0 && spawns.find(m_target) != spawns.end() && Roll(9) != 0) {
+		return;
+	}
+
+	m_target = PickSpawn(eq, true);
+	if (m_target != 0) {
+		eq.ZoneSendTarget(m_target);
+		eq.ZoneSendAutoAttack(true);
+	}
+	else {
+		eq.ZoneSendAutoAttack(false);
+	}
+}
+
+void ChatBehavior::Tick(EverQuest &eq)
+{
+	if (Roll(9) != 0) {
+		return;
+	}
+
+	eq.ZoneSendChannelMessage(ChatChannelSay, ChatLines[Roll(sizeof(ChatLines) / sizeof(ChatLines[0]) - 1)]);
+}
+
+void TradeBehavior::Tick(EverQuest &eq)
+{
+	if (Roll(29) != 0) {
+		return;
+	}
+
+	auto target = PickSpawn(eq, false);
+	if (target != 0) {
+		eq.ZoneSendTarget(target);
+		eq.ZoneSendTradeRequest(target);
+	}
+}
+
+std::unique_ptr<Behavior> CreateBehavior(const std::string &name)
+{
+	if (name.compare("wander") == 0) {
+		return std::unique_ptr<Behavior>(new WanderBehavior());
+	}
+	else if (name.compare("fight") == 0) {
+		return std::unique_ptr<Behavior>(new FightBehavior());
+	}
+	else if (name.compare("chat") == 0) {
+		return std::unique_ptr<Behavior>(new ChatBehavior());
+	}
+	else if (name.compare("trade") == 0) {
+		return std::unique_ptr<Behavior>(new TradeBehavior());
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "eq.h"
+#include <memory>
+#include <random>
+#include <string>
+
+//Something a zoned in client does once per swarm tick
+class Behavior
+{
+public:
+	Behavior();
+	virtual ~Behavior() { }
+
+	virtual void Tick(EverQuest &eq) = 0;
+protected:
+	uint32_t PickSpawn(const EverQuest &eq, bool npc);
+	int Roll(int max);
+
+	std::mt19937 m_random;
+};
+
+class WanderBehavior : public Behavior
+{
+public:
+	WanderBehavior();
+	virtual void Tick(EverQuest &eq);
+private:
+	bool m_anchored;
+	float m_x;
+	float m_y;
+	float m_z;
+	float m_heading;
+};
+
+class FightBehavior : public Behavior
+{
+public:
+	FightBehavior();
+	virtual void Tick(EverQuest &eq);
+private:
+	uint32_t m_target;
+};
+
+class ChatBehavior : public Behavior
+{
+public:
+	virtual void Tick(EverQuest &eq);
+};
+
+class TradeBehavior : public Behavior
+{
+public:
+	virtual void Tick(EverQuest &eq);
+};
+
+//wander, fight, chat or trade; nullptr for anything else
+std::unique_ptr<Behavior> CreateBehavior(const std::string &name);
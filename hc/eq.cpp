@@ -25,6 +25,12 @@ EverQuest::EverQuest(const std::string &host, int port, const std::string &user,
 	m_server = server;
 	m_character = character;
 	m_dbid = 0;
+	m_spawn_id = 0;
+	m_position_sequence = 0;
+	m_zoned_in = false;
+	m_safe_x = 0.0f;
+	m_safe_y = 0.0f;
+	m_safe_z = 0.0f;
 
 	EQ::Net::DNSLookup(m_host, port, false, [&](const std::string &addr) {
 		if (addr.empty()) {
@@ -58,6 +64,10 @@ void EverQuest::LoginOnStatusChangeReconnectEnabled(std::shared_ptr<EQ::Net::Day
 {
 	if (to == EQ::Net::StatusConnected) {
 		Log.OutF(Logs::General, Logs::Headless_Client, "Login connected.");
+		if (m_on_login_connected) {
+			m_on_login_connected();
+		}
+
 		LoginSendSessionReady();
 	}
 
@@ -292,6 +302,9 @@ void EverQuest::WorldOnPacketRecv(std::shared_ptr<EQ::Net::DaybreakConnection> c
 	case 0x00d2:
 		WorldProcessCharacterSelect(p);
 		break;
+	case 0x4c44: //OP_ZoneServerInfo
+		WorldProcessZoneServerInfo(p);
+		break;
 	default:
 		Log.OutF(Logs::General, Logs::Headless_Client, "Unhandled opcode: {0:#x}", opcode);
 		break;
@@ -347,4 +360,262 @@ void EverQuest::WorldProcessCharacterSelect(const EQ::Net::Packet &p)
 
 	Log.OutF(Logs::General, Logs::Headless_Client, "Could not find {0}, cannot continue to login.", m_character);
 }
- 
\ No newline at end of file
+ 
+void EverQuest::WorldProcessZoneServerInfo(const EQ::Net::Packet &p)
+{
+	if (p.Length() < 2 + 128 + 2) {
+		Log.OutF(Logs::General, Logs::Headless_Client, "Zone server info was too short ({0} bytes), cannot continue to zone.", p.Length());
+		return;
+	}
+
+	auto host = p.GetCString(2);
+	auto port = p.GetUInt16(2 + 128);
+
+	//world reports its own view of the zone address, fall back to the host we reached login on
+	if (host.empty() || host.compare("0.0.0.0") == 0) {
+		host = m_host;
+	}
+
+	Log.OutF(Logs::General, Logs::Headless_Client, "Zoning to {0}:{1}", host, port);
+	WorldDisableReconnect();
+	ConnectToZone(host, port);
+}
+
+void EverQuest::WorldDisableReconnect()
+{
+	m_world_connection_manager->OnConnectionStateChange(std::bind(&EverQuest::WorldOnStatusChangeReconnectDisabled, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+	if (m_world_connection) {
+		m_world_connection->Close();
+	}
+}
+
+void EverQuest::ConnectToZone(const std::string &host, int port)
+{
+	m_spawn_id = 0;
+	m_zoned_in = false;
+	m_spawns.clear();
+
+	m_zone_connection_manager.reset(new EQ::Net::DaybreakConnectionManager());
+	m_zone_connection_manager->OnNewConnection(std::bind(&EverQuest::ZoneOnNewConnection, this, std::placeholders::_1));
+	m_zone_connection_manager->OnConnectionStateChange(std::bind(&EverQuest::ZoneOnStatusChange, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+	m_zone_connection_manager->OnPacketRecv(std::bind(&EverQuest::ZoneOnPacketRecv, this, std::placeholders::_1, std::placeholders::_2));
+	m_zone_connection_manager->Connect(host, port);
+}
+
+void EverQuest::ZoneOnNewConnection(std::shared_ptr<EQ::Net::DaybreakConnection> connection)
+{
+	m_zone_connection = connection;
+	Log.OutF(Logs::General, Logs::Headless_Client, "Connecting to zone...");
+}
+
+void EverQuest::ZoneOnStatusChange(std::shared_ptr<EQ::Net::DaybreakConnection> conn, EQ::Net::DbProtocolStatus from, EQ::Net::DbProtocolStatus to)
+{
+	if (to == EQ::Net::StatusConnected) {
+		Log.OutF(Logs::General, Logs::Headless_Client, "Zone connected.");
+		if (m_on_zone_connected) {
+			m_on_zone_connected(conn);
+		}
+		else {
+			ZoneSendZoneEntry();
+		}
+	}
+
+	if (to == EQ::Net::StatusDisconnected) {
+		Log.OutF(Logs::General, Logs::Headless_Client, "Zone connection lost.");
+		m_zone_connection.reset();
+		m_zoned_in = false;
+		m_spawns.clear();
+
+		if (m_on_zone_disconnected) {
+			m_on_zone_disconnected();
+		}
+	}
+}
+
+void EverQuest::ZoneOnPacketRecv(std::shared_ptr<EQ::Net::DaybreakConnection> conn, const EQ::Net::Packet &p)
+{
+	if (m_on_zone_packet_recv) {
+		m_on_zone_packet_recv(p);
+	}
+
+	auto opcode = p.GetUInt16(0);
+	switch (opcode) {
+	case 0x5089: //OP_ZoneEntry, RoF2 sends every spawn with this opcode
+		ZoneProcessSpawn(p);
+		break;
+	case 0x1795: //OP_NewZone
+		ZoneProcessNewZone(p);
+		break;
+	case 0x7280: //OP_DeleteSpawn
+		ZoneProcessDeleteSpawn(p);
+		break;
+	case 0x5f8e: //OP_SendExpZonein
+		ZoneProcessExpZonein();
+		break;
+	}
+}
+
+void EverQuest::ZoneSendZoneEntry()
+{
+	EQ::Net::DynamicPacket p;
+	p.Resize(2 + 76);
+	p.PutUInt16(0, 0x5089); //OP_ZoneEntry
+	p.PutString(2 + 4, m_character);
+
+	m_zone_connection->QueuePacket(p);
+}
+
+void EverQuest::ZoneSendEmpty(uint16_t opcode)
+{
+	EQ::Net::DynamicPacket p;
+	p.PutUInt16(0, opcode);
+
+	m_zone_connection->QueuePacket(p);
+}
+
+void EverQuest::ZoneProcessSpawn(const EQ::Net::Packet &p)
+{
+	//name, spawn id, level, eye height, npc flag
+	auto name = p.GetCString(2);
+	auto idx = 2 + name.length() + 1;
+	if (p.Length() < idx + 10) {
+		return;
+	}
+
+	auto spawn_id = p.GetUInt32(idx);
+	ZoneSpawn spawn;
+	spawn.name = name;
+	spawn.npc = p.GetUInt8(idx + 9) != 0;
+	m_spawns[spawn_id] = spawn;
+
+	//our own spawn arrives first and is our cue to continue zoning in, replays drive the sequence themselves
+	if (m_spawn_id == 0 && name.compare(m_character) == 0) {
+		m_spawn_id = spawn_id;
+		if (!m_on_zone_connected) {
+			ZoneSendEmpty(0x7887); //OP_ReqNewZone
+		}
+	}
+}
+
+void EverQuest::ZoneProcessNewZone(const EQ::Net::Packet &p)
+{
+	if (p.Length() < 2 + 600) {
+		return;
+	}
+
+	m_safe_y = p.GetFloat(2 + 588);
+	m_safe_x = p.GetFloat(2 + 592);
+	m_safe_z = p.GetFloat(2 + 596);
+
+	if (!m_on_zone_connected) {
+		ZoneSendEmpty(0x35fa); //OP_ReqClientSpawn
+	}
+}
+
+void EverQuest::ZoneProcessDeleteSpawn(const EQ::Net::Packet &p)
+{
+	if (p.Length() < 2 + 4) {
+		return;
+	}
+
+	m_spawns.erase(p.GetUInt32(2));
+}
+
+void EverQuest::ZoneProcessExpZonein()
+{
+	if (m_zoned_in || m_on_zone_connected) {
+		return;
+	}
+
+	ZoneSendEmpty(0x5ae2); //OP_WorldObjectsSent
+	ZoneSendEmpty(0x345d); //OP_ClientReady
+	m_zoned_in = true;
+
+	Log.OutF(Logs::General, Logs::Headless_Client, "{0} zoned in with spawn id {1}", m_character, m_spawn_id);
+	if (m_on_zoned_in) {
+		m_on_zoned_in();
+	}
+}
+
+void EverQuest::ZoneSendPosition(float x, float y, float z, float heading)
+{
+	if (!m_zoned_in) {
+		return;
+	}
+
+	EQ::Net::DynamicPacket p;
+	p.Resize(2 + 46);
+	p.PutUInt16(0, 0x7dfc); //OP_ClientUpdate
+	p.PutUInt16(2, m_position_sequence++);
+	p.PutUInt16(4, (uint16_t)m_spawn_id);
+	p.PutUInt32(16, (uint32_t)(heading * 4096.0f / 512.0f) & 0xfff);
+	p.PutFloat(20, x);
+	p.PutFloat(28, z);
+	p.PutFloat(32, y);
+
+	m_zone_connection->QueuePacket(p);
+}
+
+void EverQuest::ZoneSendChannelMessage(uint32_t channel, const std::string &message)
+{
+	if (!m_zoned_in) {
+		return;
+	}
+
+	//sender, target, 4 unknown, language, channel, 5 unknown, skill, message
+	EQ::Net::DynamicPacket p;
+	size_t idx = 2;
+	p.PutUInt16(0, 0x2b2d); //OP_ChannelMessage
+	p.PutCString(idx, m_character.c_str());
+	idx += m_character.length() + 1;
+	p.PutUInt8(idx, 0);
+	idx += 1 + 4;
+	p.PutUInt32(idx, 0);
+	p.PutUInt32(idx + 4, channel);
+	idx += 8 + 5;
+	p.PutUInt32(idx, 100);
+	idx += 4;
+	p.PutCString(idx, message.c_str());
+
+	m_zone_connection->QueuePacket(p);
+}
+
+void EverQuest::ZoneSendTarget(uint32_t spawn_id)
+{
+	if (!m_zoned_in) {
+		return;
+	}
+
+	EQ::Net::DynamicPacket p;
+	p.PutUInt16(0, 0x075d); //OP_TargetMouse
+	p.PutUInt32(2, spawn_id);
+
+	m_zone_connection->QueuePacket(p);
+}
+
+void EverQuest::ZoneSendAutoAttack(bool enabled)
+{
+	if (!m_zoned_in) {
+		return;
+	}
+
+	EQ::Net::DynamicPacket p;
+	p.PutUInt16(0, 0x109d); //OP_AutoAttack
+	p.PutUInt32(2, enabled ? 1 : 0);
+
+	m_zone_connection->QueuePacket(p);
+}
+
+void EverQuest::ZoneSendTradeRequest(uint32_t spawn_id)
+{
+	if (!m_zoned_in) {
+		return;
+	}
+
+	EQ::Net::DynamicPacket p;
+	p.PutUInt16(0, 0x77b5); //OP_TradeRequest
+	p.PutUInt32(2, spawn_id);
+	p.PutUInt32(6, m_spawn_id);
+
+	m_zone_connection->QueuePacket(p);
+}
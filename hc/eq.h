@@ -7,6 +7,12 @@
 #include <string>
 #include <map>
 
+struct ZoneSpawn
+{
+	std::string name;
+	bool npc;
+};
+
 struct WorldServer
 {
 	std::string long_name;
@@ -24,6 +30,29 @@ public:
 	EverQuest(const std::string &host, int port, const std::string &user, const std::string &pass, const std::string &server, const std::string &character);
 	~EverQuest();
 
+	//When set the zone entry sequence is left to the callback instead of sending OP_ZoneEntry ourselves
+	void OnZoneConnected(std::function<void(std::shared_ptr<EQ::Net::DaybreakConnection>)> cb) { m_on_zone_connected = cb; }
+	void OnZonePacketRecv(std::function<void(const EQ::Net::Packet&)> cb) { m_on_zone_packet_recv = cb; }
+	void OnZoneDisconnected(std::function<void()> cb) { m_on_zone_disconnected = cb; }
+	const std::string &GetCharacter() const { return m_character; }
+
+	void OnLoginConnected(std::function<void()> cb) { m_on_login_connected = cb; }
+	void OnZonedIn(std::function<void()> cb) { m_on_zoned_in = cb; }
+
+	bool IsZonedIn() const { return m_zoned_in; }
+	uint32_t GetSpawnId() const { return m_spawn_id; }
+	float GetSafeX() const { return m_safe_x; }
+	float GetSafeY() const { return m_safe_y; }
+	float GetSafeZ() const { return m_safe_z; }
+	const std::map<uint32_t, ZoneSpawn> &GetSpawns() const { return m_spawns; }
+	std::shared_ptr<EQ::Net::DaybreakConnection> GetZoneConnection() const { return m_zone_connection; }
+
+	void ZoneSendPosition(float x, float y, float z, float heading);
+	void ZoneSendChannelMessage(uint32_t channel, const std::string &message);
+	void ZoneSendTarget(uint32_t spawn_id);
+	void ZoneSendAutoAttack(bool enabled);
+	void ZoneSendTradeRequest(uint32_t spawn_id);
+
 private:
 	//Login
 	void LoginOnNewConnection(std::shared_ptr<EQ::Net::DaybreakConnection> connection);
@@ -57,10 +86,42 @@ private:
 	void WorldSendEnterWorld(const std::string &character);
 
 	void WorldProcessCharacterSelect(const EQ::Net::Packet &p);
+	void WorldProcessZoneServerInfo(const EQ::Net::Packet &p);
+
+	void WorldDisableReconnect();
 
 	std::unique_ptr<EQ::Net::DaybreakConnectionManager> m_world_connection_manager;
 	std::shared_ptr<EQ::Net::DaybreakConnection> m_world_connection;
 
+	//Zone
+	void ConnectToZone(const std::string &host, int port);
+
+	void ZoneOnNewConnection(std::shared_ptr<EQ::Net::DaybreakConnection> connection);
+	void ZoneOnStatusChange(std::shared_ptr<EQ::Net::DaybreakConnection> conn, EQ::Net::DbProtocolStatus from, EQ::Net::DbProtocolStatus to);
+	void ZoneOnPacketRecv(std::shared_ptr<EQ::Net::DaybreakConnection> conn, const EQ::Net::Packet &p);
+
+	void ZoneSendZoneEntry();
+	void ZoneSendEmpty(uint16_t opcode);
+	void ZoneProcessSpawn(const EQ::Net::Packet &p);
+	void ZoneProcessNewZone(const EQ::Net::Packet &p);
+	void ZoneProcessDeleteSpawn(const EQ::Net::Packet &p);
+	void ZoneProcessExpZonein();
+
+	std::unique_ptr<EQ::Net::DaybreakConnectionManager> m_zone_connection_manager;
+	std::shared_ptr<EQ::Net::DaybreakConnection> m_zone_connection;
+	std::function<void(std::shared_ptr<EQ::Net::DaybreakConnection>)> m_on_zone_connected;
+	std::function<void(const EQ::Net::Packet&)> m_on_zone_packet_recv;
+	std::function<void()> m_on_zone_disconnected;
+	std::function<void()> m_on_login_connected;
+	std::function<void()> m_on_zoned_in;
+	std::map<uint32_t, ZoneSpawn> m_spawns;
+	uint32_t m_spawn_id;
+	uint16_t m_position_sequence;
+	bool m_zoned_in;
+	float m_safe_x;
+	float m_safe_y;
+	float m_safe_z;
+
 	//Variables
 	std::string m_host;
 	int m_port;
@@ -3,38 +3,32 @@
 #include "../common/crash.h"
 #include "../common/platform.h"
 #include "../common/json_config.h"
-#include <thread>
 
 #include "eq.h"
+#include "replay.h"
+#include "swarm.h"
 
 EQEmuLogSys Log;
 
-int main() {
+int main(int argc, char **argv) {
 	RegisterExecutablePlatform(ExePlatformHC);
 	Log.LoadLogSettingsDefaults();
 	set_exception_handler();
 
 	Log.OutF(Logs::General, Logs::Headless_Client, "Starting EQEmu Headless Client.");
 
-	auto config = EQ::JsonConfigFile::Load("hc.json");
-	auto config_handle = config.RawHandle();
+	//hc replay [config]: replay zone packet captures through synthetic clients
+	if (argc > 1 && strcmp(argv[1], "replay") == 0) {
+		return RunReplay(argc > 2 ? argv[2] : "hc_replay.json");
+	}
 
-	std::vector<std::unique_ptr<EverQuest>> eq_list;
+	Swarm swarm;
 
 	try {
-		for (int i = 0; i < config_handle.size(); ++i) {
-			auto c = config_handle[i];
-
-			auto host = c["host"].asString();
-			auto port = c["port"].asInt();
-			auto user = c["user"].asString();
-			auto pass = c["pass"].asString();
-			auto server = c["server"].asString();
-			auto character = c["character"].asString();
-			
-			Log.OutF(Logs::General, Logs::Headless_Client, "Connecting to {0}:{1} as Account '{2}' to Server '{3}' under Character '{4}'", host, port, user, server, character);
-
-			eq_list.push_back(std::unique_ptr<EverQuest>(new EverQuest(host, port, user, pass, server, character)));
+		auto config = EQ::JsonConfigFile::Load("hc.json");
+		if (!swarm.Load(config.RawHandle())) {
+			Log.OutF(Logs::General, Logs::Headless_Client, "No clients configured in hc.json");
+			return 0;
 		}
 	}
 	catch (std::exception &ex) {
@@ -42,10 +36,8 @@ int main() {
 		return 0;
 	}
 
-	for (;;) {
-		EQ::EventLoop::Get().Process();
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
-	}
-	
+	swarm.Start();
+	EQ::EventLoop::Get().Run();
+
 	return 0;
 }
@@ -0,0 +1,263 @@
+#include "replay.h"
+#include "../common/event/event_loop.h"
+#include "../common/json_config.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+	const uint16_t ReplayZoneEntryOpcode = 0x5089;
+	const size_t ReplayZoneEntryNameOffset = 2 + 4;
+	const size_t ReplayZoneEntryNameLength = 64;
+	const size_t ReplayMaxAwaiting = 1024;
+
+	double Percentile(const std::vector<double> &sorted, double pct)
+	{
+		auto idx = static_cast<size_t>(pct * (sorted.size() - 1) + 0.5);
+		return sorted[std::min(idx, sorted.size() - 1)];
+	}
+}
+
+bool ReplayCapture::Load(const std::string &capture_path)
+{
+	path = capture_path;
+	inbound.clear();
+	replies.clear();
+
+	EQ::Net::PacketCaptureReader reader;
+	if (!reader.Open(capture_path)) {
+		Log.OutF(Logs::General, Logs::Headless_Client, "Could not open capture {0}", capture_path);
+		return false;
+	}
+
+	//hc only speaks the RoF2 wire protocol so captures from other clients cannot be replayed as-is
+	if (reader.OpcodeSize() != 2) {
+		Log.OutF(Logs::General, Logs::Headless_Client, "Capture {0} uses {1} byte opcodes, only 2 byte opcodes are supported", capture_path, reader.OpcodeSize());
+		return false;
+	}
+
+	EQ::Net::PacketCaptureRecord record;
+	std::string client_version;
+	while (reader.Next(record)) {
+		if (record.type == EQ::Net::PacketCaptureClientVersion) {
+			client_version = record.client_version;
+		}
+		else if (record.type == EQ::Net::PacketCaptureInbound && record.data.size() >= 2) {
+			inbound.push_back(record);
+			replies.push_back(0);
+		}
+		else if (record.type == EQ::Net::PacketCaptureOutbound && record.data.size() >= 2 && !replies.empty() && replies.back() == 0) {
+			replies.back() = ReplayReadOpcode(&record.data[0]);
+		}
+	}
+
+	if (client_version.compare("RoF2") != 0) {
+		Log.OutF(Logs::General, Logs::Headless_Client, "Capture {0} was recorded from client '{1}', replaying it as RoF2 may not be meaningful", capture_path, client_version);
+	}
+
+	Log.OutF(Logs::General, Logs::Headless_Client, "Loaded {0} client packets from {1}", inbound.size(), capture_path);
+	return !inbound.empty();
+}
+
+void ReplayLatency::Record(uint16_t opcode, double latency_ms)
+{
+	m_samples[opcode].push_back(latency_ms);
+}
+
+void ReplayLatency::Report() const
+{
+	Log.OutF(Logs::General, Logs::Headless_Client, "{0:>8} {1:>8} {2:>10} {3:>10} {4:>10} {5:>10}", "opcode", "count", "avg ms", "p50 ms", "p95 ms", "max ms");
+	for (auto &s : m_samples) {
+		auto sorted = s.second;
+		std::sort(sorted.begin(), sorted.end());
+
+		double total = 0.0;
+		for (auto v : sorted) {
+			total += v;
+		}
+
+		Log.OutF(Logs::General, Logs::Headless_Client, "{0:>#8x} {1:>8} {2:>10.2f} {3:>10.2f} {4:>10.2f} {5:>10.2f}",
+			s.first, sorted.size(), total / sorted.size(), Percentile(sorted, 0.5), Percentile(sorted, 0.95), sorted.back());
+	}
+}
+
+ReplaySession::ReplaySession(const ReplayCapture &capture, ReplayLatency &latency, double speed,
+	const std::string &host, int port, const std::string &user, const std::string &pass, const std::string &server, const std::string &character,
+	int timeout_seconds)
+	: m_capture(capture), m_latency(latency), m_progress(capture.inbound.size())
+{
+	m_speed = speed > 0.0 ? speed : 1.0;
+	m_eq.reset(new EverQuest(host, port, user, pass, server, character));
+	m_eq->OnZoneConnected(std::bind(&ReplaySession::OnZoneConnected, this, std::placeholders::_1));
+	m_eq->OnZonePacketRecv(std::bind(&ReplaySession::OnZonePacketRecv, this, std::placeholders::_1));
+	m_eq->OnZoneDisconnected(std::bind(&ReplaySession::OnZoneDisconnected, this));
+	m_timer.reset(new EQ::Timer([this](EQ::Timer *t) {
+		SendDue();
+	}));
+
+	//login, world or zone may never answer, give up on this client rather than waiting forever
+	m_timeout.reset(new EQ::Timer(static_cast<uint64_t>(std::max(1, timeout_seconds)) * 1000, false, [this, character](EQ::Timer *t) {
+		if (!m_progress.IsConnected() && !m_progress.Finished()) {
+			Log.OutF(Logs::General, Logs::Headless_Client, "{0} did not get into the zone in time, giving up", character);
+			m_progress.TimedOut();
+		}
+	}));
+}
+
+void ReplaySession::OnZoneConnected(std::shared_ptr<EQ::Net::DaybreakConnection> connection)
+{
+	m_connection = connection;
+	m_progress.Connected();
+	m_awaiting.clear();
+	m_start = std::chrono::steady_clock::now();
+	SendDue();
+}
+
+void ReplaySession::OnZonePacketRecv(const EQ::Net::Packet &p)
+{
+	if (p.Length() < 2) {
+		return;
+	}
+
+	//the oldest request still waiting on this opcode is the one it answers
+	auto opcode = p.GetUInt16(0);
+	auto iter = std::find_if(m_awaiting.begin(), m_awaiting.end(), [opcode](const Awaiting &a) { return a.reply == opcode; });
+	if (iter == m_awaiting.end()) {
+		return;
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	m_latency.Record(iter->opcode, std::chrono::duration<double, std::milli>(now - iter->sent).count());
+	m_awaiting.erase(iter);
+}
+
+void ReplaySession::OnZoneDisconnected()
+{
+	if (!m_progress.Finished()) {
+		Log.OutF(Logs::General, Logs::Headless_Client, "{0} lost the zone after {1} of {2} packets, giving up", m_eq->GetCharacter(), m_progress.Next(), m_capture.inbound.size());
+	}
+
+	m_progress.Disconnected();
+	m_connection.reset();
+	m_awaiting.clear();
+}
+
+void ReplaySession::SendDue()
+{
+	if (!m_connection || m_connection->GetStatus() != EQ::Net::StatusConnected || m_progress.Finished()) {
+		return;
+	}
+
+	auto &inbound = m_capture.inbound;
+	auto base = inbound.front().offset_ms;
+	auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+
+	while (!m_progress.Finished()) {
+		auto &record = inbound[m_progress.Next()];
+		auto due = (record.offset_ms - base) / m_speed;
+		if (due > elapsed) {
+			m_timer->Start(static_cast<uint64_t>(due - elapsed) + 1, false);
+			return;
+		}
+
+		EQ::Net::DynamicPacket p;
+		p.PutData(0, (void*)&record.data[0], record.data.size());
+
+		auto opcode = p.GetUInt16(0);
+		if (opcode == ReplayZoneEntryOpcode && p.Length() >= ReplayZoneEntryNameOffset + ReplayZoneEntryNameLength) {
+			//the zone authenticates the entering character against world so the captured name has to be ours
+			memset((char*)p.Data() + ReplayZoneEntryNameOffset, 0, ReplayZoneEntryNameLength);
+			p.PutString(ReplayZoneEntryNameOffset, m_eq->GetCharacter().substr(0, ReplayZoneEntryNameLength - 1));
+		}
+
+		m_connection->QueuePacket(p);
+
+		//packets the server never answered in the capture are sent but not timed
+		auto reply = m_capture.replies[m_progress.Next()];
+		if (reply != 0) {
+			if (m_awaiting.size() >= ReplayMaxAwaiting) {
+				m_awaiting.pop_front();
+			}
+
+			m_awaiting.push_back({ opcode, reply, std::chrono::steady_clock::now() });
+		}
+		m_progress.Sent();
+	}
+
+	Log.OutF(Logs::General, Logs::Headless_Client, "{0} finished replaying {1}", m_eq->GetCharacter(), m_capture.path);
+}
+
+int RunReplay(const std::string &config_file)
+{
+	std::vector<std::unique_ptr<ReplayCapture>> captures;
+	std::vector<std::unique_ptr<ReplaySession>> sessions;
+	ReplayLatency latency;
+
+	try {
+		auto config = EQ::JsonConfigFile::Load(config_file);
+		auto c = config.RawHandle();
+
+		auto host = c["host"].asString();
+		auto port = c["port"].asInt();
+		auto server = c["server"].asString();
+		auto speed = c.get("speed", 1.0).asDouble();
+		auto timeout = c.get("timeout", 60).asInt();
+		auto &accounts = c["accounts"];
+		auto clients = c.get("clients", accounts.size()).asUInt();
+
+		for (auto &path : c["captures"]) {
+			std::unique_ptr<ReplayCapture> capture(new ReplayCapture());
+			if (capture->Load(path.asString())) {
+				captures.push_back(std::move(capture));
+			}
+		}
+
+		if (captures.empty()) {
+			Log.OutF(Logs::General, Logs::Headless_Client, "No usable captures in {0}", config_file);
+			return 0;
+		}
+
+		if (clients > accounts.size()) {
+			Log.OutF(Logs::General, Logs::Headless_Client, "Asked for {0} clients but only {1} accounts are configured", clients, accounts.size());
+			clients = accounts.size();
+		}
+
+		for (unsigned int i = 0; i < clients; ++i) {
+			auto &a = accounts[i];
+			auto &capture = *captures[i % captures.size()];
+
+			Log.OutF(Logs::General, Logs::Headless_Client, "Replaying {0} as '{1}' at {2}x", capture.path, a["character"].asString(), speed);
+			sessions.push_back(std::unique_ptr<ReplaySession>(new ReplaySession(capture, latency, speed,
+				host, port, a["user"].asString(), a["pass"].asString(), server, a["character"].asString(), timeout)));
+		}
+	}
+	catch (std::exception &ex) {
+		Log.OutF(Logs::General, Logs::Headless_Client, "Error parsing replay config file: {0}", ex.what());
+		return 0;
+	}
+
+	EQ::Timer report(30000, true, [&](EQ::Timer *t) {
+		latency.Report();
+	});
+
+	//keep pumping briefly once every client is done so the last packets still get their responses measured
+	std::chrono::steady_clock::time_point done_at;
+	bool done = false;
+	for (;;) {
+		EQ::EventLoop::Get().Process();
+
+		if (!done) {
+			done = std::all_of(sessions.begin(), sessions.end(), [](const std::unique_ptr<ReplaySession> &s) { return s->Finished(); });
+			done_at = std::chrono::steady_clock::now();
+		}
+		else if (std::chrono::steady_clock::now() - done_at > std::chrono::seconds(2)) {
+			break;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	auto failed = std::count_if(sessions.begin(), sessions.end(), [](const std::unique_ptr<ReplaySession> &s) { return s->Failed(); });
+	Log.OutF(Logs::General, Logs::Headless_Client, "Replay complete, {0} of {1} clients never reached the zone.", failed, sessions.size());
+	latency.Report();
+	return 0;
+}
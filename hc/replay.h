@@ -0,0 +1,67 @@
+#pragma once
+
+#include "eq.h"
+#include "replay_state.h"
+#include "../common/net/packet_capture.h"
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct ReplayCapture
+{
+	std::string path;
+	std::vector<EQ::Net::PacketCaptureRecord> inbound;
+	//opcode of the first server packet recorded after each inbound one and before the next, 0 if there was none
+	std::vector<uint16_t> replies;
+
+	bool Load(const std::string &capture_path);
+};
+
+//Time from a replayed client packet to the zone packet the capture shows answering it, bucketed by wire opcode
+class ReplayLatency
+{
+public:
+	void Record(uint16_t opcode, double latency_ms);
+	void Report() const;
+private:
+	std::map<uint16_t, std::vector<double>> m_samples;
+};
+
+class ReplaySession
+{
+public:
+	ReplaySession(const ReplayCapture &capture, ReplayLatency &latency, double speed,
+		const std::string &host, int port, const std::string &user, const std::string &pass, const std::string &server, const std::string &character,
+		int timeout_seconds);
+
+	bool Finished() const { return m_progress.Finished(); }
+	bool Failed() const { return m_progress.Failed(); }
+private:
+	struct Awaiting
+	{
+		uint16_t opcode;
+		uint16_t reply;
+		std::chrono::steady_clock::time_point sent;
+	};
+
+	void OnZoneConnected(std::shared_ptr<EQ::Net::DaybreakConnection> connection);
+	void OnZonePacketRecv(const EQ::Net::Packet &p);
+	void OnZoneDisconnected();
+	void SendDue();
+
+	const ReplayCapture &m_capture;
+	ReplayLatency &m_latency;
+	double m_speed;
+	ReplayProgress m_progress;
+	std::unique_ptr<EverQuest> m_eq;
+	std::shared_ptr<EQ::Net::DaybreakConnection> m_connection;
+	std::unique_ptr<EQ::Timer> m_timer;
+	std::unique_ptr<EQ::Timer> m_timeout;
+	std::chrono::steady_clock::time_point m_start;
+	std::deque<Awaiting> m_awaiting;
+};
+
+int RunReplay(const std::string &config_file);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+//captures store wire opcodes little endian and records are not aligned
+inline uint16_t ReplayReadOpcode(const char *data)
+{
+	return static_cast<uint16_t>(static_cast<uint8_t>(data[0]) | (static_cast<uint8_t>(data[1]) << 8));
+}
+
+//Where one replayed client is: waiting on the zone, sending, done, or given up on.
+//Kept free of networking so the session's end conditions can be tested on their own.
+class ReplayProgress
+{
+public:
+	ReplayProgress(size_t packets) : m_packets(packets), m_sent(0), m_connected(false), m_failed(false) { }
+
+	//a fresh zone connection starts the capture over
+	void Connected() { m_connected = true; m_sent = 0; }
+
+	//nothing reconnects a replay client to its zone, so losing it before the end fails the session
+	void Disconnected()
+	{
+		if (m_sent < m_packets) {
+			m_failed = true;
+		}
+
+		m_connected = false;
+	}
+
+	void TimedOut()
+	{
+		if (!m_connected && m_sent < m_packets) {
+			m_failed = true;
+		}
+	}
+
+	void Sent() { ++m_sent; }
+
+	size_t Next() const { return m_sent; }
+	bool IsConnected() const { return m_connected; }
+	bool Failed() const { return m_failed; }
+	bool Finished() const { return m_failed || m_sent >= m_packets; }
+private:
+	size_t m_packets;
+	size_t m_sent;
+	bool m_connected;
+	bool m_failed;
+};
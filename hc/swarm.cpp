@@ -0,0 +1,260 @@
+#include "swarm.h"
+#include <algorithm>
+#include <fmt/format.h>
+
+namespace {
+	const double HistogramBounds[] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 30000, 60000 };
+	const size_t HistogramBoundCount = sizeof(HistogramBounds) / sizeof(HistogramBounds[0]);
+
+	//character names may only contain letters so generated clients are numbered a, b, ... z, ba, bb ...
+	std::string IndexToLetters(unsigned int index)
+	{
+		std::string ret;
+		do {
+			ret.insert(ret.begin(), (char)('a' + index % 26));
+			index /= 26;
+		} while (index > 0);
+
+		return ret;
+	}
+
+	double Elapsed(std::chrono::steady_clock::time_point since)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+	}
+}
+
+SwarmHistogram::SwarmHistogram()
+{
+	m_buckets.resize(HistogramBoundCount + 1, 0);
+	m_count = 0;
+	m_total = 0.0;
+	m_min = 0.0;
+	m_max = 0.0;
+}
+
+void SwarmHistogram::Add(double ms)
+{
+	auto bucket = std::lower_bound(HistogramBounds, HistogramBounds + HistogramBoundCount, ms) - HistogramBounds;
+	m_buckets[bucket]++;
+
+	m_min = m_count == 0 ? ms : std::min(m_min, ms);
+	m_max = m_count == 0 ? ms : std::max(m_max, ms);
+	m_total += ms;
+	m_count++;
+}
+
+//upper bound of the bucket holding the percentile, or the observed max for the overflow bucket
+double SwarmHistogram::Percentile(double pct) const
+{
+	auto wanted = (uint64_t)(pct * m_count + 0.5);
+	uint64_t seen = 0;
+	for (size_t i = 0; i < HistogramBoundCount; ++i) {
+		seen += m_buckets[i];
+		if (seen >= wanted) {
+			return std::min(HistogramBounds[i], m_max);
+		}
+	}
+
+	return m_max;
+}
+
+void SwarmHistogram::Report(const std::string &name) const
+{
+	if (m_count == 0) {
+		Log.OutF(Logs::General, Logs::Headless_Client, "{0}: no samples", name);
+		return;
+	}
+
+	Log.OutF(Logs::General, Logs::Headless_Client, "{0}: count {1} min {2:.1f} avg {3:.1f} p50 <={4:.0f} p95 <={5:.0f} p99 <={6:.0f} max {7:.1f} ms",
+		name, m_count, m_min, m_total / m_count, Percentile(0.5), Percentile(0.95), Percentile(0.99), m_max);
+
+	std::string buckets;
+	for (size_t i = 0; i <= HistogramBoundCount; ++i) {
+		if (m_buckets[i] == 0) {
+			continue;
+		}
+
+		if (i < HistogramBoundCount) {
+			buckets += fmt::format(" <={0}:{1}", HistogramBounds[i], m_buckets[i]);
+		}
+		else {
+			buckets += fmt::format(" >{0}:{1}", HistogramBounds[HistogramBoundCount - 1], m_buckets[i]);
+		}
+	}
+
+	Log.OutF(Logs::General, Logs::Headless_Client, "{0}:{1}", name, buckets);
+}
+
+SwarmClient::SwarmClient(const SwarmClientConfig &config, const std::string &host, int port, const std::string &server,
+	SwarmHistogram &connect_time, SwarmHistogram &zone_in_time)
+{
+	m_started = std::chrono::steady_clock::now();
+	m_last_sent = 0;
+
+	for (auto &name : config.behaviors) {
+		auto behavior = CreateBehavior(name);
+		if (behavior) {
+			m_behaviors.push_back(std::move(behavior));
+		}
+		else {
+			Log.OutF(Logs::General, Logs::Headless_Client, "Unknown behavior '{0}' for {1}", name, config.character);
+		}
+	}
+
+	m_eq.reset(new EverQuest(host, port, config.user, config.pass, server, config.character));
+	m_eq->OnLoginConnected([this, &connect_time]() {
+		connect_time.Add(Elapsed(m_started));
+	});
+
+	m_eq->OnZonedIn([this, &zone_in_time]() {
+		zone_in_time.Add(Elapsed(m_started));
+	});
+}
+
+void SwarmClient::Tick(SwarmHistogram &rtt)
+{
+	if (!m_eq->IsZonedIn()) {
+		return;
+	}
+
+	for (auto &behavior : m_behaviors) {
+		behavior->Tick(*m_eq);
+	}
+
+	//last_ping only moves when a reliable packet is acked so only sample when something new was sent
+	auto connection = m_eq->GetZoneConnection();
+	if (connection) {
+		auto stats = connection->GetStats();
+		if (stats.sent_packets != m_last_sent && stats.last_ping > 0) {
+			rtt.Add((double)stats.last_ping);
+			m_last_sent = stats.sent_packets;
+		}
+	}
+}
+
+Swarm::Swarm()
+{
+	m_port = 5998;
+	m_ramp_per_second = 20;
+	m_tick_ms = 1000;
+	m_report_seconds = 30;
+}
+
+bool Swarm::Load(const Json::Value &root)
+{
+	m_configs.clear();
+
+	//the original hc.json format: an array of fully specified clients with no behaviors
+	if (root.isArray()) {
+		for (auto &c : root) {
+			m_host = c["host"].asString();
+			m_port = c["port"].asInt();
+			m_server = c["server"].asString();
+
+			SwarmClientConfig config;
+			config.user = c["user"].asString();
+			config.pass = c["pass"].asString();
+			config.character = c["character"].asString();
+			m_configs.push_back(config);
+		}
+
+		return !m_configs.empty();
+	}
+
+	m_host = root["host"].asString();
+	m_port = root.get("port", 5998).asInt();
+	m_server = root["server"].asString();
+	m_ramp_per_second = std::max(1, root.get("ramp_per_second", 20).asInt());
+	m_tick_ms = std::max(50, root.get("tick_ms", 1000).asInt());
+	m_report_seconds = std::max(1, root.get("report_seconds", 30).asInt());
+
+	std::vector<std::string> behaviors;
+	for (auto &b : root["behaviors"]) {
+		behaviors.push_back(b.asString());
+	}
+
+	for (auto &c : root["clients"]) {
+		SwarmClientConfig config;
+		config.user = c["user"].asString();
+		config.pass = c["pass"].asString();
+		config.character = c["character"].asString();
+		config.behaviors = behaviors;
+		for (auto &b : c["behaviors"]) {
+			config.behaviors.push_back(b.asString());
+		}
+
+		m_configs.push_back(config);
+	}
+
+	//"generate": {"count": 1000, "start": 0, "user": "load{0}", "pass": "pass", "character": "Swarm{0}"}
+	auto &generate = root["generate"];
+	if (generate.isObject()) {
+		auto count = generate.get("count", 0).asUInt();
+		auto start = generate.get("start", 0).asUInt();
+		auto user = generate.get("user", "swarm{0}").asString();
+		auto pass = generate.get("pass", "swarm").asString();
+		auto character = generate.get("character", "Swarm{0}").asString();
+
+		for (unsigned int i = start; i < start + count; ++i) {
+			auto suffix = IndexToLetters(i);
+
+			SwarmClientConfig config;
+			config.user = fmt::format(user, suffix);
+			config.pass = fmt::format(pass, suffix);
+			config.character = fmt::format(character, suffix);
+			config.behaviors = behaviors;
+			m_configs.push_back(config);
+		}
+	}
+
+	return !m_configs.empty();
+}
+
+void Swarm::Start()
+{
+	Log.OutF(Logs::General, Logs::Headless_Client, "Starting swarm of {0} clients against {1}:{2} at {3} per second", m_configs.size(), m_host, m_port, m_ramp_per_second);
+
+	//spawn in small batches so thousands of logins don't all hit the login server in the same millisecond
+	m_spawn_timer.reset(new EQ::Timer(100, true, [this](EQ::Timer *t) {
+		SpawnClients();
+	}));
+
+	m_tick_timer.reset(new EQ::Timer(m_tick_ms, true, [this](EQ::Timer *t) {
+		Tick();
+	}));
+
+	m_report_timer.reset(new EQ::Timer(m_report_seconds * 1000, true, [this](EQ::Timer *t) {
+		Report();
+	}));
+}
+
+void Swarm::SpawnClients()
+{
+	auto batch = std::max(1, m_ramp_per_second / 10);
+	for (int i = 0; i < batch && m_clients.size() < m_configs.size(); ++i) {
+		auto &config = m_configs[m_clients.size()];
+		m_clients.push_back(std::unique_ptr<SwarmClient>(new SwarmClient(config, m_host, m_port, m_server, m_connect_time, m_zone_in_time)));
+	}
+
+	if (m_clients.size() >= m_configs.size()) {
+		m_spawn_timer->Stop();
+	}
+}
+
+void Swarm::Tick()
+{
+	for (auto &client : m_clients) {
+		client->Tick(m_rtt);
+	}
+}
+
+void Swarm::Report()
+{
+	auto zoned_in = std::count_if(m_clients.begin(), m_clients.end(), [](const std::unique_ptr<SwarmClient> &c) { return c->IsZonedIn(); });
+
+	Log.OutF(Logs::General, Logs::Headless_Client, "Swarm: {0} of {1} clients started, {2} zoned in", m_clients.size(), m_configs.size(), zoned_in);
+	m_connect_time.Report("connect time");
+	m_zone_in_time.Report("zone-in time");
+	m_rtt.Report("zone rtt");
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "eq.h"
+#include "behavior.h"
+#include "../common/json/json.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+//Fixed log-ish bucket histogram, cheap enough to feed from thousands of clients
+class SwarmHistogram
+{
+public:
+	SwarmHistogram();
+
+	void Add(double ms);
+	void Report(const std::string &name) const;
+private:
+	double Percentile(double pct) const;
+
+	std::vector<uint64_t> m_buckets;
+	uint64_t m_count;
+	double m_total;
+	double m_min;
+	double m_max;
+};
+
+struct SwarmClientConfig
+{
+	std::string user;
+	std::string pass;
+	std::string character;
+	std::vector<std::string> behaviors;
+};
+
+class SwarmClient
+{
+public:
+	SwarmClient(const SwarmClientConfig &config, const std::string &host, int port, const std::string &server,
+		SwarmHistogram &connect_time, SwarmHistogram &zone_in_time);
+
+	void Tick(SwarmHistogram &rtt);
+	bool IsZonedIn() const { return m_eq->IsZonedIn(); }
+private:
+	std::unique_ptr<EverQuest> m_eq;
+	std::vector<std::unique_ptr<Behavior>> m_behaviors;
+	std::chrono::steady_clock::time_point m_started;
+	uint64_t m_last_sent;
+};
+
+class Swarm
+{
+public:
+	Swarm();
+
+	bool Load(const Json::Value &root);
+	void Start();
+private:
+	void SpawnClients();
+	void Tick();
+	void Report();
+
+	std::string m_host;
+	int m_port;
+	std::string m_server;
+	int m_ramp_per_second;
+	int m_tick_ms;
+	int m_report_seconds;
+	std::vector<SwarmClientConfig> m_configs;
+	std::vector<std::unique_ptr<SwarmClient>> m_clients;
+
+	SwarmHistogram m_connect_time;
+	SwarmHistogram m_zone_in_time;
+	SwarmHistogram m_rtt;
+
+	std::unique_ptr<EQ::Timer> m_spawn_timer;
+	std::unique_ptr<EQ::Timer> m_tick_timer;
+	std::unique_ptr<EQ::Timer> m_report_timer;
+};
@@ -0,0 +1,18 @@
+#include <iostream>
+#include <memory>
+#include "fixed_memory_hash_benchmark.h"
+#include "../common/eqemu_config.h"
+
+const EQEmuConfig *Config;
+
+int main() {
+	try {
+		std::unique_ptr<Test::Output> output(new Test::TextOutput(Test::TextOutput::Terse, std::cout));
+		Test::Suite benchmarks;
+		benchmarks.add(new FixedMemoryHashBenchmark());
+		benchmarks.run(*output, true);
+	} catch(...) {
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,145 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2013 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_FIXED_MEMORY_DENSE_H
+#define __EQEMU_TESTS_FIXED_MEMORY_DENSE_H
+
+#include "cppunit/cpptest.h"
+#include "../common/fixed_memory_hash_set.h"
+#include "../common/faction.h"
+
+class FixedMemoryDenseHashTest : public Test::Suite {
+	typedef void(FixedMemoryDenseHashTest::*TestFunction)(void);
+public:
+	FixedMemoryDenseHashTest() {
+		size_ = EQ::FixedMemoryHashSet<NPCFactionList>::estimated_size(900, 1000, EQ::FixedMemoryHashSetLayout::Dense);
+		data_ = new uint8[size_];
+		memset(data_, 0, size_);
+		TEST_ADD(FixedMemoryDenseHashTest::LayoutSelectTest);
+		TEST_ADD(FixedMemoryDenseHashTest::InitTest);
+		TEST_ADD(FixedMemoryDenseHashTest::InsertTest);
+		TEST_ADD(FixedMemoryDenseHashTest::RetrieveTest);
+		TEST_ADD(FixedMemoryDenseHashTest::OverwriteTest);
+		TEST_ADD(FixedMemoryDenseHashTest::BoundsTest);
+		TEST_ADD(FixedMemoryDenseHashTest::CapacityTest);
+	}
+	~FixedMemoryDenseHashTest() {
+		delete[] data_;
+	}
+
+	private:
+	void LayoutSelectTest() {
+		TEST_ASSERT(EQ::FixedMemoryHashSet<uint32>::resolve_layout(900, 1000) == EQ::FixedMemoryHashSetLayout::Dense);
+		TEST_ASSERT(EQ::FixedMemoryHashSet<NPCFactionList>::resolve_layout(900, 1000) == EQ::FixedMemoryHashSetLayout::Offsets);
+		TEST_ASSERT(EQ::FixedMemoryHashSet<NPCFactionList>::resolve_layout(1000, 1000) == EQ::FixedMemoryHashSetLayout::Dense);
+		TEST_ASSERT(EQ::FixedMemoryHashSet<NPCFactionList>::resolve_layout(72000, 190000) == EQ::FixedMemoryHashSetLayout::Offsets);
+		TEST_ASSERT(EQ::FixedMemoryHashSet<NPCFactionList>::resolve_layout(72000, 190000, EQ::FixedMemoryHashSetLayout::Dense) == EQ::FixedMemoryHashSetLayout::Dense);
+		TEST_ASSERT(EQ::FixedMemoryHashSet<NPCFactionList>::resolve_layout(900, 1000, EQ::FixedMemoryHashSetLayout::Offsets) == EQ::FixedMemoryHashSetLayout::Offsets);
+	}
+
+	void InitTest() {
+		EQ::FixedMemoryHashSet<NPCFactionList> hash(data_, size_, 900, 1000, EQ::FixedMemoryHashSetLayout::Dense);
+		TEST_ASSERT(hash.layout() == EQ::FixedMemoryHashSetLayout::Dense);
+		TEST_ASSERT(!hash.exists(10));
+		TEST_ASSERT(hash.find(10) == nullptr);
+		TEST_ASSERT(hash.size() == 0);
+		TEST_ASSERT(hash.max_size() == 900);
+		TEST_ASSERT(hash.max_key() == 1000);
+		TEST_ASSERT(hash.empty());
+	}
+
+	void InsertTest() {
+		EQ::FixedMemoryHashSet<NPCFactionList> hash(data_, size_);
+		TEST_ASSERT(hash.layout() == EQ::FixedMemoryHashSetLayout::Dense);
+
+		NPCFactionList faction;
+		memset(&faction, 0, sizeof(faction));
+		faction.id = 10;
+		faction.primaryfaction = 255;
+		hash.insert(10, faction);
+
+		faction.id = 0;
+		faction.primaryfaction = 1;
+		hash.insert(0, faction);
+
+		faction.id = 1000;
+		faction.primaryfaction = 2;
+		hash.insert(1000, faction);
+
+		TEST_ASSERT(hash.exists(0));
+		TEST_ASSERT(hash.exists(10));
+		TEST_ASSERT(hash.exists(1000));
+		TEST_ASSERT(!hash.exists(11));
+		TEST_ASSERT(hash.size() == 3);
+		TEST_ASSERT(!hash.empty());
+	}
+
+	void RetrieveTest() {
+		EQ::FixedMemoryHashSet<NPCFactionList> hash(data_, size_);
+		TEST_ASSERT(hash.size() == 3);
+
+		NPCFactionList *faction = hash.find(10);
+		TEST_ASSERT(faction != nullptr);
+		TEST_ASSERT(faction->id == 10);
+		TEST_ASSERT(faction->primaryfaction == 255);
+
+		TEST_ASSERT(hash[0].primaryfaction == 1);
+		TEST_ASSERT(hash.at(1000).primaryfaction == 2);
+		TEST_ASSERT(hash.find(11) == nullptr);
+	}
+
+	void OverwriteTest() {
+		EQ::FixedMemoryHashSet<NPCFactionList> hash(data_, size_);
+		NPCFactionList faction;
+		memset(&faction, 0, sizeof(faction));
+		faction.id = 10;
+		faction.primaryfaction = 42;
+		hash.insert(10, faction);
+
+		TEST_ASSERT(hash.size() == 3);
+		TEST_ASSERT(hash.find(10)->primaryfaction == 42);
+	}
+
+	void BoundsTest() {
+		EQ::FixedMemoryHashSet<NPCFactionList> hash(data_, size_);
+		TEST_ASSERT(!hash.exists(1001));
+		TEST_ASSERT(hash.find(1001) == nullptr);
+		TEST_THROWS(hash.at(1001), EQ::Exception);
+		TEST_THROWS(hash.at(11), EQ::Exception);
+	}
+
+	void CapacityTest() {
+		uint32 size = EQ::FixedMemoryHashSet<NPCFactionList>::estimated_size(2, 3, EQ::FixedMemoryHashSetLayout::Dense);
+		uint8 *data = new uint8[size];
+		EQ::FixedMemoryHashSet<NPCFactionList> hash(data, size, 2, 3, EQ::FixedMemoryHashSetLayout::Dense);
+		TEST_ASSERT(hash.layout() == EQ::FixedMemoryHashSetLayout::Dense);
+
+		NPCFactionList faction;
+		memset(&faction, 0, sizeof(faction));
+		hash.insert(1, faction);
+		hash.insert(2, faction);
+		TEST_THROWS(hash.insert(3, faction), EQ::Exception);
+		TEST_ASSERT(hash.size() == 2);
+		delete[] data;
+	}
+
+	uint8 *data_;
+	size_t size_;
+};
+
+#endif
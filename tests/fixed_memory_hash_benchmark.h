@@ -0,0 +1,104 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2013 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_FIXED_MEMORY_HASH_BENCHMARK_H
+#define __EQEMU_TESTS_FIXED_MEMORY_HASH_BENCHMARK_H
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include "cppunit/cpptest.h"
+#include "../common/fixed_memory_hash_set.h"
+#include "../common/faction.h"
+
+/*
+	Compares lookup cost of the Offsets and Dense layouts over the same compact key set.
+	Timings go to stdout, the assertions only check both layouts agree. Built as the opt-in
+	benchmarks target (EQEMU_BUILD_BENCHMARKS) so regular test runs stay quiet and write nothing.
+*/
+class FixedMemoryHashBenchmark : public Test::Suite {
+	typedef void(FixedMemoryHashBenchmark::*TestFunction)(void);
+public:
+	FixedMemoryHashBenchmark() {
+		TEST_ADD(FixedMemoryHashBenchmark::LookupBenchmark);
+	}
+	~FixedMemoryHashBenchmark() {
+	}
+
+	private:
+	template<class T>
+	double TimeLookups(EQ::FixedMemoryHashSet<T> &hash, const std::vector<uint32> &keys, uint64 &checksum) {
+		auto start = std::chrono::steady_clock::now();
+		for (int pass = 0; pass < passes; ++pass) {
+			for (auto key : keys) {
+				const T *v = hash.find(key);
+				if (v) {
+					checksum += v->primaryfaction;
+				}
+			}
+		}
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		return elapsed.count() / (static_cast<double>(keys.size()) * passes);
+	}
+
+	void LookupBenchmark() {
+		const uint32 max_id = 20000;
+		const uint32 count = 16000;
+
+		size_t offsets_size = EQ::FixedMemoryHashSet<NPCFactionList>::estimated_size(count, max_id, EQ::FixedMemoryHashSetLayout::Offsets);
+		size_t dense_size = EQ::FixedMemoryHashSet<NPCFactionList>::estimated_size(count, max_id, EQ::FixedMemoryHashSetLayout::Dense);
+		std::vector<uint8> offsets_data(offsets_size);
+		std::vector<uint8> dense_data(dense_size);
+
+		EQ::FixedMemoryHashSet<NPCFactionList> offsets(&offsets_data[0], offsets_size, count, max_id, EQ::FixedMemoryHashSetLayout::Offsets);
+		EQ::FixedMemoryHashSet<NPCFactionList> dense(&dense_data[0], dense_size, count, max_id, EQ::FixedMemoryHashSetLayout::Dense);
+
+		NPCFactionList faction;
+		memset(&faction, 0, sizeof(faction));
+		for (uint32 i = 0, id = 1; i < count; ++i, id += (i % 4 == 0) ? 2 : 1) {
+			faction.id = id;
+			faction.primaryfaction = id * 7;
+			offsets.insert(id, faction);
+			dense.insert(id, faction);
+		}
+
+		// scrambled probe order so neither layout gets a free ride from the prefetcher
+		std::vector<uint32> keys;
+		keys.reserve(max_id + 1);
+		for (uint32 i = 0; i <= max_id; ++i) {
+			keys.push_back((i * 7919) % (max_id + 1));
+		}
+
+		uint64 offsets_sum = 0;
+		uint64 dense_sum = 0;
+		double offsets_ns = TimeLookups(offsets, keys, offsets_sum);
+		double dense_ns = TimeLookups(dense, keys, dense_sum);
+
+		TEST_ASSERT(offsets.size() == dense.size());
+		TEST_ASSERT(offsets_sum == dense_sum);
+
+		std::ostream &out = std::cout;
+		out << "FixedMemoryHashSet<NPCFactionList> " << count << " keys over " << (max_id + 1) << " ids" << std::endl;
+		out << "  offsets: " << offsets_ns << " ns/lookup, " << offsets_size << " bytes" << std::endl;
+		out << "  dense:   " << dense_ns << " ns/lookup, " << dense_size << " bytes" << std::endl;
+	}
+
+	static const int passes = 50;
+};
+
+#endif
@@ -24,11 +24,15 @@
 #include "ipc_mutex_test.h"
 #include "fixed_memory_test.h"
 #include "fixed_memory_variable_test.h"
+#include "fixed_memory_dense_test.h"
 #include "atobool_test.h"
 #include "hextoi_32_64_test.h"
 #include "string_util_test.h"
 #include "data_verification_test.h"
 #include "skills_util_test.h"
+#include "replay_state_test.h"
+#include "quest_timer_queue_test.h"
+#include "sequence_buffer_test.h"
 #include "../common/eqemu_config.h"
 
 const EQEmuConfig *Config;
@@ -44,11 +48,15 @@ int main() {
 		tests.add(new IPCMutexTest());
 		tests.add(new FixedMemoryHashTest());
 		tests.add(new FixedMemoryVariableHashTest());
+		tests.add(new FixedMemoryDenseHashTest());
 		tests.add(new atoboolTest());
 		tests.add(new hextoi_32_64_Test());
 		tests.add(new StringUtilTest());
 		tests.add(new DataVerificationTest());
 		tests.add(new SkillsUtilsTest());
+		tests.add(new ReplayStateTest());
+		tests.add(new QuestTimerQueueTest());
+		tests.add(new SequenceBufferTest());
 		tests.run(*output, true);
 	} catch(...) {
 		return -1;
@@ -0,0 +1,178 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2013 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_QUEST_TIMER_QUEUE_H
+#define __EQEMU_TESTS_QUEST_TIMER_QUEUE_H
+
+#include "cppunit/cpptest.h"
+#include "../zone/quest_timer_queue.h"
+
+extern uint32 current_time;
+
+class QuestTimerQueueTest : public Test::Suite {
+	typedef void(QuestTimerQueueTest::*TestFunction)(void);
+public:
+	QuestTimerQueueTest() {
+		TEST_ADD(QuestTimerQueueTest::RepeatTest);
+		TEST_ADD(QuestTimerQueueTest::RestartTest);
+		TEST_ADD(QuestTimerQueueTest::RestartZeroTest);
+		TEST_ADD(QuestTimerQueueTest::StopTest);
+		TEST_ADD(QuestTimerQueueTest::StopAllTest);
+		TEST_ADD(QuestTimerQueueTest::StopFromHandlerTest);
+	}
+
+	~QuestTimerQueueTest() {
+	}
+
+	private:
+	// the queue only uses mobs as keys, they are never dereferenced
+	Mob *FakeMob(int n) {
+		return reinterpret_cast<Mob *>(static_cast<uintptr_t>(0x1000 + n * 16));
+	}
+
+	bool Expires(QuestTimerQueue &queue, Mob *mob, const std::string &name) {
+		QuestTimerQueue::Expired expired;
+		if (!queue.PopExpired(expired))
+			return false;
+
+		return expired.mob == mob && expired.name == name;
+	}
+
+	bool Idle(QuestTimerQueue &queue) {
+		QuestTimerQueue::Expired expired;
+		return !queue.PopExpired(expired);
+	}
+
+	void RepeatTest() {
+		QuestTimerQueue queue;
+		Mob *mob = FakeMob(1);
+		queue.Start(mob, "repeat", 100);
+
+		current_time += 100;
+		TEST_ASSERT(Idle(queue));
+		current_time += 1;
+		TEST_ASSERT(Expires(queue, mob, "repeat"));
+		TEST_ASSERT(Idle(queue));
+
+		// rearmed from the time it fired
+		current_time += 100;
+		TEST_ASSERT(Idle(queue));
+		current_time += 1;
+		TEST_ASSERT(Expires(queue, mob, "repeat"));
+		TEST_ASSERT(queue.Has(mob, "repeat"));
+	}
+
+	void RestartTest() {
+		QuestTimerQueue queue;
+		Mob *mob = FakeMob(1);
+		queue.Start(mob, "restart", 100);
+
+		current_time += 50;
+		queue.Start(mob, "restart", 30);
+		TEST_ASSERT(queue.Size() == 1);
+		TEST_ASSERT(queue.GetRemainingTime(mob, "restart") == 30);
+
+		current_time += 30;
+		TEST_ASSERT(Idle(queue));
+		current_time += 1;
+		TEST_ASSERT(Expires(queue, mob, "restart"));
+
+		// a restart does not change the interval used once the timer fires
+		current_time += 100;
+		TEST_ASSERT(Idle(queue));
+		current_time += 1;
+		TEST_ASSERT(Expires(queue, mob, "restart"));
+	}
+
+	void RestartZeroTest() {
+		QuestTimerQueue queue;
+		Mob *mob = FakeMob(1);
+		queue.Start(mob, "zero", 100);
+
+		current_time += 50;
+		queue.Start(mob, "zero", 0);
+		TEST_ASSERT(queue.GetRemainingTime(mob, "zero") == 100);
+
+		current_time += 100;
+		TEST_ASSERT(Idle(queue));
+		current_time += 1;
+		TEST_ASSERT(Expires(queue, mob, "zero"));
+	}
+
+	void StopTest() {
+		QuestTimerQueue queue;
+		Mob *mob = FakeMob(1);
+		queue.Start(mob, "stopped", 10);
+		queue.Start(mob, "running", 20);
+
+		TEST_ASSERT(queue.Stop(mob, "stopped"));
+		TEST_ASSERT(!queue.Stop(mob, "stopped"));
+		TEST_ASSERT(!queue.Stop(FakeMob(2), "running"));
+		TEST_ASSERT(!queue.Has(mob, "stopped"));
+		TEST_ASSERT(queue.GetRemainingTime(mob, "stopped") == 0);
+
+		current_time += 21;
+		TEST_ASSERT(Expires(queue, mob, "running"));
+		TEST_ASSERT(Idle(queue));
+		queue.Stop(mob, "running");
+
+		// stopping and starting again leaves no stale node to fire early
+		queue.Start(mob, "stopped", 10);
+		queue.Stop(mob, "stopped");
+		queue.Start(mob, "stopped", 50);
+		current_time += 11;
+		TEST_ASSERT(Idle(queue));
+		current_time += 40;
+		TEST_ASSERT(Expires(queue, mob, "stopped"));
+	}
+
+	void StopAllTest() {
+		QuestTimerQueue queue;
+		Mob *first = FakeMob(1);
+		Mob *second = FakeMob(2);
+		queue.Start(first, "a", 10);
+		queue.Start(first, "b", 10);
+		queue.Start(second, "a", 20);
+
+		queue.StopAll(first);
+		TEST_ASSERT(queue.Size() == 1);
+		TEST_ASSERT(!queue.Has(first, "a"));
+		TEST_ASSERT(!queue.Has(first, "b"));
+
+		current_time += 21;
+		TEST_ASSERT(Expires(queue, second, "a"));
+		TEST_ASSERT(Idle(queue));
+	}
+
+	void StopFromHandlerTest() {
+		QuestTimerQueue queue;
+		Mob *mob = FakeMob(1);
+		queue.Start(mob, "once", 10);
+
+		current_time += 11;
+		QuestTimerQueue::Expired expired;
+		TEST_ASSERT(queue.PopExpired(expired));
+		TEST_ASSERT(queue.Stop(expired.mob, expired.name));
+		TEST_ASSERT(queue.Size() == 0);
+
+		current_time += 100;
+		TEST_ASSERT(Idle(queue));
+	}
+};
+
+#endif
@@ -0,0 +1,100 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2013 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_REPLAY_STATE_H
+#define __EQEMU_TESTS_REPLAY_STATE_H
+
+#include "cppunit/cpptest.h"
+#include "../hc/replay_state.h"
+
+class ReplayStateTest : public Test::Suite {
+	typedef void(ReplayStateTest::*TestFunction)(void);
+public:
+	ReplayStateTest() {
+		TEST_ADD(ReplayStateTest::CompleteTest);
+		TEST_ADD(ReplayStateTest::DisconnectMidReplayTest);
+		TEST_ADD(ReplayStateTest::DisconnectAfterReplayTest);
+		TEST_ADD(ReplayStateTest::TimeoutTest);
+		TEST_ADD(ReplayStateTest::ReconnectTest);
+		TEST_ADD(ReplayStateTest::ReadOpcodeTest);
+	}
+
+	~ReplayStateTest() {
+	}
+
+	private:
+	void CompleteTest() {
+		ReplayProgress progress(2);
+		TEST_ASSERT(!progress.Finished());
+		progress.Connected();
+		progress.Sent();
+		TEST_ASSERT(!progress.Finished());
+		progress.Sent();
+		TEST_ASSERT(progress.Finished());
+		TEST_ASSERT(!progress.Failed());
+	}
+
+	void DisconnectMidReplayTest() {
+		ReplayProgress progress(3);
+		progress.Connected();
+		progress.Sent();
+		progress.Disconnected();
+		TEST_ASSERT(progress.Failed());
+		TEST_ASSERT(progress.Finished());
+		TEST_ASSERT(!progress.IsConnected());
+	}
+
+	void DisconnectAfterReplayTest() {
+		ReplayProgress progress(1);
+		progress.Connected();
+		progress.Sent();
+		progress.Disconnected();
+		TEST_ASSERT(progress.Finished());
+		TEST_ASSERT(!progress.Failed());
+	}
+
+	void TimeoutTest() {
+		ReplayProgress waiting(1);
+		waiting.TimedOut();
+		TEST_ASSERT(waiting.Failed());
+		TEST_ASSERT(waiting.Finished());
+
+		ReplayProgress connected(1);
+		connected.Connected();
+		connected.TimedOut();
+		TEST_ASSERT(!connected.Failed());
+		TEST_ASSERT(!connected.Finished());
+	}
+
+	void ReconnectTest() {
+		ReplayProgress progress(2);
+		progress.Connected();
+		progress.Sent();
+		progress.Connected();
+		TEST_ASSERT(progress.Next() == 0);
+		TEST_ASSERT(!progress.Finished());
+	}
+
+	void ReadOpcodeTest() {
+		char data[3] = { 0x00, (char)0x89, 0x50 };
+		TEST_ASSERT(ReplayReadOpcode(&data[1]) == 0x5089);
+		TEST_ASSERT(ReplayReadOpcode(&data[0]) == 0x8900);
+	}
+};
+
+#endif
@@ -0,0 +1,172 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2013 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_SEQUENCE_BUFFER_H
+#define __EQEMU_TESTS_SEQUENCE_BUFFER_H
+
+#include "cppunit/cpptest.h"
+#include "../common/net/sequence_buffer.h"
+
+#include <map>
+#include <string>
+
+class SequenceBufferTest : public Test::Suite {
+	typedef void(SequenceBufferTest::*TestFunction)(void);
+public:
+	SequenceBufferTest() {
+		TEST_ADD(SequenceBufferTest::InsertFindTest);
+		TEST_ADD(SequenceBufferTest::WraparoundTest);
+		TEST_ADD(SequenceBufferTest::OutOfOrderTest);
+		TEST_ADD(SequenceBufferTest::SharedSlotTest);
+		TEST_ADD(SequenceBufferTest::EraseTest);
+		TEST_ADD(SequenceBufferTest::SlotReuseTest);
+		TEST_ADD(SequenceBufferTest::ClearTest);
+	}
+
+	~SequenceBufferTest() {
+	}
+
+	private:
+	void InsertFindTest() {
+		EQ::Net::SequenceBuffer<int> buffer;
+		TEST_ASSERT(buffer.Empty());
+		TEST_ASSERT(buffer.Find(0) == nullptr);
+		TEST_ASSERT(!buffer.Erase(0));
+
+		buffer.Insert(10) = 100;
+		buffer.Insert(11) = 110;
+		TEST_ASSERT(buffer.Size() == 2);
+		TEST_ASSERT(buffer.Find(10) != nullptr && *buffer.Find(10) == 100);
+		TEST_ASSERT(buffer.Find(11) != nullptr && *buffer.Find(11) == 110);
+		TEST_ASSERT(buffer.Find(12) == nullptr);
+
+		// inserting a live sequence again hands back the same value
+		TEST_ASSERT(buffer.Insert(10) == 100);
+		TEST_ASSERT(buffer.Size() == 2);
+	}
+
+	void WraparoundTest() {
+		EQ::Net::SequenceBuffer<int> buffer;
+		for (int i = 0; i < 16; ++i) {
+			uint16_t seq = static_cast<uint16_t>(65530 + i);
+			buffer.Insert(seq) = seq;
+		}
+
+		TEST_ASSERT(buffer.Size() == 16);
+		for (int i = 0; i < 16; ++i) {
+			uint16_t seq = static_cast<uint16_t>(65530 + i);
+			TEST_ASSERT(buffer.Find(seq) != nullptr && *buffer.Find(seq) == seq);
+		}
+
+		TEST_ASSERT(buffer.Find(65535) != nullptr);
+		TEST_ASSERT(buffer.Find(0) != nullptr && *buffer.Find(0) == 0);
+		TEST_ASSERT(buffer.Find(9) != nullptr && *buffer.Find(9) == 9);
+		TEST_ASSERT(buffer.Find(10) == nullptr);
+	}
+
+	void OutOfOrderTest() {
+		EQ::Net::SequenceBuffer<int> buffer;
+		uint16_t order[] = { 7, 3, 65535, 1, 0, 5, 2, 65534, 6, 4 };
+		for (auto seq : order) {
+			buffer.Insert(seq) = seq + 1;
+		}
+
+		TEST_ASSERT(buffer.Size() == 10);
+		for (auto seq : order) {
+			TEST_ASSERT(buffer.Find(seq) != nullptr && *buffer.Find(seq) == seq + 1);
+		}
+
+		std::map<uint16_t, int> seen;
+		buffer.ForEach([&](uint16_t seq, int &value) { seen[seq] = value; });
+		TEST_ASSERT(seen.size() == 10);
+		for (auto seq : order) {
+			TEST_ASSERT(seen[seq] == seq + 1);
+		}
+	}
+
+	void SharedSlotTest() {
+		EQ::Net::SequenceBuffer<int> buffer;
+
+		// sequences sharing low bits must both stay live, the ring grows instead of dropping one
+		buffer.Insert(1) = 1;
+		buffer.Insert(65) = 65;
+		buffer.Insert(129) = 129;
+		buffer.Insert(1 + 32768) = 32769;
+		TEST_ASSERT(buffer.Size() == 4);
+		TEST_ASSERT(buffer.Find(1) != nullptr && *buffer.Find(1) == 1);
+		TEST_ASSERT(buffer.Find(65) != nullptr && *buffer.Find(65) == 65);
+		TEST_ASSERT(buffer.Find(129) != nullptr && *buffer.Find(129) == 129);
+		TEST_ASSERT(buffer.Find(32769) != nullptr && *buffer.Find(32769) == 32769);
+
+		// a sequence that only shares a slot with a live one is not found
+		TEST_ASSERT(buffer.Find(193) == nullptr);
+		TEST_ASSERT(!buffer.Erase(193));
+		TEST_ASSERT(buffer.Size() == 4);
+	}
+
+	void EraseTest() {
+		EQ::Net::SequenceBuffer<int> buffer;
+		for (int i = 0; i < 100; ++i) {
+			buffer.Insert(static_cast<uint16_t>(i)) = i;
+		}
+
+		for (int i = 0; i < 100; i += 2) {
+			TEST_ASSERT(buffer.Erase(static_cast<uint16_t>(i)));
+		}
+
+		TEST_ASSERT(buffer.Size() == 50);
+		TEST_ASSERT(!buffer.Erase(0));
+		for (int i = 0; i < 100; ++i) {
+			bool found = buffer.Find(static_cast<uint16_t>(i)) != nullptr;
+			TEST_ASSERT(found == (i % 2 == 1));
+		}
+	}
+
+	void SlotReuseTest() {
+		EQ::Net::SequenceBuffer<std::string> buffer;
+		buffer.Insert(3) = "first";
+		TEST_ASSERT(buffer.Erase(3));
+		TEST_ASSERT(buffer.Find(3) == nullptr);
+
+		// the next sequence in that slot gets the old storage back, callers overwrite it
+		std::string &value = buffer.Insert(67);
+		TEST_ASSERT(value == "first");
+		value = "second";
+		TEST_ASSERT(buffer.Find(67) != nullptr && *buffer.Find(67) == "second");
+		TEST_ASSERT(buffer.Find(3) == nullptr);
+		TEST_ASSERT(buffer.Size() == 1);
+	}
+
+	void ClearTest() {
+		EQ::Net::SequenceBuffer<int> buffer;
+		for (int i = 0; i < 10; ++i) {
+			buffer.Insert(static_cast<uint16_t>(i * 64)) = i;
+		}
+
+		buffer.Clear();
+		TEST_ASSERT(buffer.Empty());
+		for (int i = 0; i < 10; ++i) {
+			TEST_ASSERT(buffer.Find(static_cast<uint16_t>(i * 64)) == nullptr);
+		}
+
+		buffer.Insert(5) = 5;
+		TEST_ASSERT(buffer.Size() == 1);
+	}
+};
+
+#endif
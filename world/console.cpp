@@ -31,6 +31,7 @@
 #include "../common/md5.h"
 #include "eqemu_api_world_data_service.h"
 #include <fmt/format.h>
+#include <algorithm>
 
 extern ClientList      client_list;
 extern ZSList          zoneserver_list;
@@ -883,6 +884,71 @@ void ConsoleReloadZoneQuests(
 	safe_delete(pack);
 }
 
+/**
+ * @param connection
+ * @param command
+ * @param args
+ */
+void ConsoleServertalkStats(
+	EQ::Net::ConsoleServerConnection *connection,
+	const std::string &command,
+	const std::vector<std::string> &args
+)
+{
+	size_t limit = 20;
+	if (!args.empty() && StringIsNumber(args[0])) {
+		limit = std::max(1, atoi(args[0].c_str()));
+	}
+
+	std::map<uint16, EQ::Net::ServertalkOpcodeStats> totals;
+	uint64 batches_sent     = 0;
+	uint64 batched_messages = 0;
+	uint64 shared_memory    = 0;
+
+	for (auto &zone_server : zoneserver_list.getZoneServerList()) {
+		auto &stats = zone_server->GetServertalkStats();
+		batches_sent += stats.batches_sent;
+		batched_messages += stats.batched_messages;
+		shared_memory += stats.shared_memory_messages;
+
+		for (auto &op : stats.opcodes) {
+			auto &total = totals[op.first];
+			total.sent_messages += op.second.sent_messages;
+			total.sent_bytes += op.second.sent_bytes;
+			total.recv_messages += op.second.recv_messages;
+			total.recv_bytes += op.second.recv_bytes;
+		}
+	}
+
+	std::vector<std::pair<uint16, EQ::Net::ServertalkOpcodeStats>> sorted(totals.begin(), totals.end());
+	std::sort(
+		sorted.begin(), sorted.end(), [](
+			const std::pair<uint16, EQ::Net::ServertalkOpcodeStats> &a,
+			const std::pair<uint16, EQ::Net::ServertalkOpcodeStats> &b
+		) {
+			return a.second.sent_bytes + a.second.recv_bytes > b.second.sent_bytes + b.second.recv_bytes;
+		}
+	);
+
+	connection->SendLine(fmt::format("World -> zone batches sent [{}] carrying [{}] messages", batches_sent, batched_messages));
+	connection->SendLine(fmt::format("World -> zone messages sent over shared memory [{}]", shared_memory));
+	connection->SendLine(fmt::format("{:>8} {:>12} {:>14} {:>12} {:>14}", "opcode", "sent msgs", "sent bytes", "recv msgs", "recv bytes"));
+
+	for (size_t i = 0; i < sorted.size() && i < limit; ++i) {
+		auto &op = sorted[i];
+		connection->SendLine(
+			fmt::format(
+				"{:>#8x} {:>12} {:>14} {:>12} {:>14}",
+				op.first,
+				op.second.sent_messages,
+				op.second.sent_bytes,
+				op.second.recv_messages,
+				op.second.recv_bytes
+			)
+		);
+	}
+}
+
 /**
  * @param connection
  * @param command
@@ -921,6 +987,7 @@ void RegisterConsoleFunctions(std::unique_ptr<EQ::Net::ConsoleServer>& console)
 	console->RegisterCall("ooc", 50, "ooc [message]", std::bind(ConsoleOOC, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
 	console->RegisterCall("reloadworld", 200, "reloadworld", std::bind(ConsoleReloadWorld, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
 	console->RegisterCall("reloadzonequests", 200, "reloadzonequests [zone_short_name]", std::bind(ConsoleReloadZoneQuests, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+	console->RegisterCall("servertalkstats", 150, "servertalkstats [count]", std::bind(ConsoleServertalkStats, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
 	console->RegisterCall("setpass", 200, "setpass [account_name] [new_password]", std::bind(ConsoleSetPass, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
 	console->RegisterCall("signalcharbyname", 50, "signalcharbyname charname ID", std::bind(ConsoleSignalCharByName, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
 	console->RegisterCall("tell", 50, "tell [name] [message]", std::bind(ConsoleTell, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
@@ -423,6 +423,10 @@ int main(int argc, char** argv) {
 	server_opts.port = Config->WorldTCPPort;
 	server_opts.ipv6 = false;
 	server_opts.credentials = Config->SharedKey;
+	server_opts.batching = RuleB(Network, ServertalkBatching);
+	if (RuleB(Network, ServertalkSharedMemory)) {
+		server_opts.shared_memory_directory = EQ::Net::ServertalkSharedMemory::Directory(Config->SharedMemDir);
+	}
 	server_connection->Listen(server_opts);
 	LogInfo("Server (TCP) listener started");
 
@@ -510,6 +514,10 @@ int main(int argc, char** argv) {
 	opts.daybreak_options.resend_delay_min = RuleI(Network, ResendDelayMinMS);
 	opts.daybreak_options.resend_delay_max = RuleI(Network, ResendDelayMaxMS);
 	opts.daybreak_options.outgoing_data_rate = RuleR(Network, ClientDataRate);
+	opts.daybreak_options.compression_level = RuleI(Network, CompressionLevel);
+	opts.daybreak_options.compression_min_size = RuleI(Network, CompressionMinSize);
+	opts.daybreak_options.congestion_control = RuleB(Network, CongestionControl);
+	opts.daybreak_options.congestion_window_max = RuleI(Network, CongestionWindowMax);
 
 	EQ::Net::EQStreamManager eqsm(opts);
 
@@ -531,6 +539,17 @@ int main(int argc, char** argv) {
 		LogInfo("New connection from IP {0}:{1}", stream->GetRemoteIP(), ntohs(stream->GetRemotePort()));
 	});
 
+	//identify streams from their first packet rather than polling every pending stream each loop
+	eqsm.OnPacketRecv([&stream_identifier](std::shared_ptr<EQ::Net::EQStream> stream) {
+		stream_identifier.PacketReceived(stream.get());
+	});
+
+	eqsm.OnConnectionStateChange([&stream_identifier](std::shared_ptr<EQ::Net::EQStream> stream, EQ::Net::DbProtocolStatus from, EQ::Net::DbProtocolStatus to) {
+		if (to == EQ::Net::StatusDisconnecting || to == EQ::Net::StatusDisconnected) {
+			stream_identifier.StreamClosed(stream.get());
+		}
+	});
+
 	while (RunLoops) {
 		Timer::SetCurrentTime();
 		eqs = nullptr;
@@ -72,6 +72,7 @@ public:
 	inline const char * GetLaunchName() const { return(launcher_name.c_str()); }
 	inline const char * GetLaunchedName() const { return(launched_name.c_str()); }
 	std::string         GetUUID() const { return tcpc->GetUUID(); }
+	const EQ::Net::ServertalkStats &GetServertalkStats() const { return tcpc->GetStats(); }
 
 	inline uint32		GetInstanceID() { return instance_id; }
 	inline void			SetInstanceID(uint32 i) { instance_id = i; }
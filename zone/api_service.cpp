@@ -30,7 +30,11 @@
 #include "object.h"
 #include "zone.h"
 #include "doors.h"
+#include "quest_parser_collection.h"
+#include "../common/event/timer.h"
+#include <algorithm>
 #include <iostream>
+#include <unordered_map>
 
 extern Zone *zone;
 
@@ -886,6 +890,270 @@ Json::Value ApiSetLoggingLevel(EQ::Net::WebsocketServerConnection *connection, J
 	return response;
 }
 
+Json::Value ApiGetQuestProfile(EQ::Net::WebsocketServerConnection *connection, Json::Value params)
+{
+	if (zone->GetZoneID() == 0) {
+		throw EQ::Net::WebsocketException("Zone must be loaded to invoke this call");
+	}
+
+	size_t count = 25;
+	if (params.isArray() && params.size() > 0 && params[0].isNumeric()) {
+		count = params[0].asUInt();
+	}
+
+	Json::Value response;
+	for (auto &entry : parse->GetProfiler().GetTop(count)) {
+		Json::Value row;
+
+		row["script"]        = entry.script;
+		row["filename"]      = entry.filename;
+		row["event_id"]      = entry.event;
+		row["calls"]         = static_cast<Json::UInt64>(entry.calls);
+		row["total_time_us"] = static_cast<Json::UInt64>(entry.total_time);
+		row["max_time_us"]   = static_cast<Json::UInt64>(entry.max_time);
+		row["db_time_us"]    = static_cast<Json::UInt64>(entry.db_time);
+
+		response.append(row);
+	}
+
+	return response;
+}
+
+Json::Value ApiResetQuestProfile(EQ::Net::WebsocketServerConnection *connection, Json::Value params)
+{
+	if (zone->GetZoneID() == 0) {
+		throw EQ::Net::WebsocketException("Zone must be loaded to invoke this call");
+	}
+
+	parse->GetProfiler().Reset();
+
+	Json::Value response;
+	response["status"] = "Quest profile reset";
+	return response;
+}
+
+/**
+ * Last state pushed to entity delta subscribers for one entity
+ */
+struct ApiEntityState {
+	std::string name;
+	std::string type;
+	float       x;
+	float       y;
+	float       z;
+	float       heading;
+	int32       hp;
+	int32       max_hp;
+	uint64      seen;
+};
+
+/**
+ * Diffs the mob list against what subscribers were last sent and pushes one shared event per tick,
+ * so dashboards no longer need to poll the full detail dumps
+ */
+class ApiEntityDeltas {
+public:
+	ApiEntityDeltas(std::unique_ptr<EQ::Net::WebsocketServer> &server) : m_server(server)
+	{
+		m_sequence   = 0;
+		m_tick       = 0;
+		m_subscribed = false;
+		m_interval = std::max(50, RuleI(Zone, ApiEntityDeltaMS));
+		m_timer.reset(
+			new EQ::Timer(
+				m_interval, true, [this](EQ::Timer *t) {
+					Tick();
+				}
+			)
+		);
+	}
+
+	/**
+	 * Subscribers call this once and apply every delta with a later sequence on top of it
+	 *
+	 * @return
+	 */
+	Json::Value Snapshot()
+	{
+		Update();
+
+		Json::Value response;
+		response["sequence"] = (Json::UInt64) m_sequence;
+		response["entities"] = Json::Value(Json::arrayValue);
+		for (auto &iter : m_states) {
+			response["entities"].append(Row(iter.first, iter.second));
+		}
+
+		return response;
+	}
+
+private:
+	void Tick()
+	{
+		//pick up rule reloads without restarting the zone
+		auto interval = std::max(50, RuleI(Zone, ApiEntityDeltaMS));
+		if (interval != m_interval) {
+			m_interval = interval;
+			m_timer->Start(m_interval, true);
+		}
+
+		//only connections that may receive the event count, same status DispatchEvent sends with
+		if (!m_server->HasSubscribers(EQ::Net::SubscriptionEventEntityDelta, 50)) {
+			//forget everything once the last subscriber leaves so the next snapshot starts clean, but
+			//keep a snapshot taken before subscribing so its despawns still go out once they subscribe
+			if (m_subscribed) {
+				m_states.clear();
+				m_subscribed = false;
+			}
+
+			return;
+		}
+
+		m_subscribed = true;
+		Update();
+	}
+
+	void Update()
+	{
+		if (!zone) {
+			return;
+		}
+
+		m_tick++;
+
+		auto threshold = RuleR(Zone, ApiEntityDeltaMoveThreshold);
+		threshold *= threshold;
+
+		Json::Value spawned(Json::arrayValue);
+		Json::Value despawned(Json::arrayValue);
+		Json::Value moved(Json::arrayValue);
+		Json::Value hp(Json::arrayValue);
+
+		for (auto &iter : entity_list.GetMobList()) {
+			auto mob   = iter.second;
+			auto state = m_states.find(iter.first);
+
+			//entity ids are reused, a different name means the old one left and a new one arrived
+			if (state != m_states.end() && state->second.name != mob->GetCleanName()) {
+				despawned.append(iter.first);
+				m_states.erase(state);
+				state = m_states.end();
+			}
+
+			if (state == m_states.end()) {
+				auto &s = m_states[iter.first];
+				s.name    = mob->GetCleanName();
+				s.type    = mob->IsClient() ? "client" : (mob->IsNPC() ? "npc" : (mob->IsCorpse() ? "corpse" : "mob"));
+				s.x       = mob->GetX();
+				s.y       = mob->GetY();
+				s.z       = mob->GetZ();
+				s.heading = mob->GetHeading();
+				s.hp      = mob->GetHP();
+				s.max_hp  = mob->GetMaxHP();
+				s.seen    = m_tick;
+				spawned.append(Row(iter.first, s));
+				continue;
+			}
+
+			auto &s = state->second;
+			s.seen = m_tick;
+
+			auto dx = mob->GetX() - s.x;
+			auto dy = mob->GetY() - s.y;
+			auto dz = mob->GetZ() - s.z;
+			if (dx * dx + dy * dy + dz * dz > threshold) {
+				s.x       = mob->GetX();
+				s.y       = mob->GetY();
+				s.z       = mob->GetZ();
+				s.heading = mob->GetHeading();
+
+				Json::Value row;
+				row["id"]      = iter.first;
+				row["x"]       = s.x;
+				row["y"]       = s.y;
+				row["z"]       = s.z;
+				row["heading"] = s.heading;
+				moved.append(row);
+			}
+
+			if (mob->GetHP() != s.hp || mob->GetMaxHP() != s.max_hp) {
+				s.hp     = mob->GetHP();
+				s.max_hp = mob->GetMaxHP();
+
+				Json::Value row;
+				row["id"]     = iter.first;
+				row["hp"]     = s.hp;
+				row["max_hp"] = s.max_hp;
+				hp.append(row);
+			}
+		}
+
+		auto iter = m_states.begin();
+		while (iter != m_states.end()) {
+			if (iter->second.seen != m_tick) {
+				despawned.append(iter->first);
+				iter = m_states.erase(iter);
+				continue;
+			}
+
+			++iter;
+		}
+
+		if (spawned.empty() && despawned.empty() && moved.empty() && hp.empty()) {
+			return;
+		}
+
+		//encoded once by DispatchEvent and shared by every subscriber, clients apply despawned before spawned
+		Json::Value data;
+		data["sequence"]  = (Json::UInt64) ++m_sequence;
+		data["spawned"]   = spawned;
+		data["despawned"] = despawned;
+		data["moved"]     = moved;
+		data["hp"]        = hp;
+		m_server->DispatchEvent(EQ::Net::SubscriptionEventEntityDelta, data, 50);
+	}
+
+	static Json::Value Row(uint16 id, const ApiEntityState &s)
+	{
+		Json::Value row;
+		row["id"]      = id;
+		row["name"]    = s.name;
+		row["type"]    = s.type;
+		row["x"]       = s.x;
+		row["y"]       = s.y;
+		row["z"]       = s.z;
+		row["heading"] = s.heading;
+		row["hp"]      = s.hp;
+		row["max_hp"]  = s.max_hp;
+		return row;
+	}
+
+	std::unique_ptr<EQ::Net::WebsocketServer>    &m_server;
+	std::unique_ptr<EQ::Timer>                   m_timer;
+	std::unordered_map<uint16, ApiEntityState>   m_states;
+	uint64                                       m_sequence;
+	uint64                                       m_tick;
+	int                                          m_interval;
+	bool                                         m_subscribed;
+};
+
+void RegisterApiEntityDeltaEvent(std::unique_ptr<EQ::Net::WebsocketServer> &server)
+{
+	//owned by the snapshot handler so the timer goes away with the server
+	auto deltas = std::make_shared<ApiEntityDeltas>(server);
+	server->SetMethodHandler(
+		"get_entity_snapshot",
+		[deltas](EQ::Net::WebsocketServerConnection *connection, const Json::Value &params) -> Json::Value {
+			if (zone->GetZoneID() == 0) {
+				throw EQ::Net::WebsocketException("Zone must be loaded to invoke this call");
+			}
+
+			return deltas->Snapshot();
+		},
+		50
+	);
+}
+
 void RegisterApiLogEvent(std::unique_ptr<EQ::Net::WebsocketServer> &server)
 {
 	LogSys.SetConsoleHandler(
@@ -913,6 +1181,9 @@ void RegisterApiService(std::unique_ptr<EQ::Net::WebsocketServer> &server)
 	server->SetMethodHandler("get_zone_attributes", &ApiGetZoneAttributes, 50);
 	server->SetMethodHandler("get_logsys_categories", &ApiGetLogsysCategories, 50);
 	server->SetMethodHandler("set_logging_level", &ApiSetLoggingLevel, 50);
+	server->SetMethodHandler("get_quest_profile", &ApiGetQuestProfile, 50);
+	server->SetMethodHandler("reset_quest_profile", &ApiResetQuestProfile, 50);
 
 	RegisterApiLogEvent(server);
+	RegisterApiEntityDeltaEvent(server);
 }
@@ -7775,6 +7775,7 @@ FACTION_VALUE Client::GetReverseFactionCon(Mob* iOther) {
 
 bool Client::ReloadCharacterFaction(Client *c, uint32 facid, uint32 charid)
 {
+	InvalidateFactionLevelCache();
 	if (database.SetCharacterFactionLevel(charid, facid, 0, 0, factionvalues))
 		return true;
 	else
@@ -7792,8 +7793,6 @@ FACTION_VALUE Client::GetFactionLevel(uint32 char_id, uint32 npc_id, uint32 p_ra
 	if (pFaction < 0)
 		return GetSpecialFactionCon(tnpc);
 	FACTION_VALUE fac = FACTION_INDIFFERENT;
-	int32 tmpFactionValue;
-	FactionMods fmods;
 
 	// few optimizations
 	if (GetFeigned())
@@ -7815,17 +7814,7 @@ FACTION_VALUE Client::GetFactionLevel(uint32 char_id, uint32 npc_id, uint32 p_ra
 	//First get the NPC's Primary faction
 	if(pFaction > 0)
 	{
-		//Get the faction data from the database
-		if(database.GetFactionData(&fmods, p_class, p_race, p_deity, pFaction))
-		{
-			//Get the players current faction with pFaction
-			tmpFactionValue = GetCharacterFactionLevel(pFaction);
-			//Tack on any bonuses from Alliance type spell effects
-			tmpFactionValue += GetFactionBonus(pFaction);
-			tmpFactionValue += GetItemFactionBonus(pFaction);
-			//Return the faction to the client
-			fac = CalculateFaction(&fmods, tmpFactionValue);
-		}
+		fac = GetBaseFactionLevel(p_race, p_class, p_deity, pFaction);
 	}
 	else
 	{
@@ -7842,6 +7831,41 @@ FACTION_VALUE Client::GetFactionLevel(uint32 char_id, uint32 npc_id, uint32 p_ra
 	return fac;
 }
 
+// Standing with a primary faction before any per-NPC adjustments (merchants, aggro, pets).
+// Aggro scans ask for this constantly, so the result is cached until the personal faction value
+// or a faction bonus changes; race/class/deity are checked on lookup so illusions just miss.
+FACTION_VALUE Client::GetBaseFactionLevel(uint32 p_race, uint32 p_class, uint32 p_deity, int32 pFaction)
+{
+	auto iter = faction_level_cache.find(pFaction);
+	if (iter != faction_level_cache.end() && iter->second.race == p_race &&
+		iter->second.class_ == p_class && iter->second.deity == p_deity)
+		return iter->second.value;
+
+	FACTION_VALUE fac = FACTION_INDIFFERENT;
+	int32 tmpFactionValue;
+	FactionMods fmods;
+
+	//Get the faction data from the database
+	if(database.GetFactionData(&fmods, p_class, p_race, p_deity, pFaction))
+	{
+		//Get the players current faction with pFaction
+		tmpFactionValue = GetCharacterFactionLevel(pFaction);
+		//Tack on any bonuses from Alliance type spell effects
+		tmpFactionValue += GetFactionBonus(pFaction);
+		tmpFactionValue += GetItemFactionBonus(pFaction);
+		//Return the faction to the client
+		fac = CalculateFaction(&fmods, tmpFactionValue);
+	}
+
+	FactionLevelCacheEntry &entry = faction_level_cache[pFaction];
+	entry.value = fac;
+	entry.race = p_race;
+	entry.class_ = p_class;
+	entry.deity = p_deity;
+
+	return fac;
+}
+
 //Sets the characters faction standing with the specified NPC.
 void Client::SetFactionLevel(uint32 char_id, uint32 npc_id, uint8 char_class, uint8 char_race, uint8 char_deity, bool quest)
 {
@@ -8009,6 +8033,7 @@ void Client::UpdatePersonalFaction(int32 char_id, int32 npc_value, int32 faction
 			*current_value = this_faction_min;
 
 		database.SetCharacterFactionLevel(char_id, faction_id, *current_value, temp, factionvalues);
+		InvalidateFactionLevelCache();
 	}
 
 return;
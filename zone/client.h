@@ -71,6 +71,7 @@ namespace EQ
 #include <algorithm>
 #include <memory>
 #include <deque>
+#include <unordered_map>
 
 
 #define CLIENT_TIMEOUT 90000
@@ -651,6 +652,8 @@ public:
 
 	FACTION_VALUE GetReverseFactionCon(Mob* iOther);
 	FACTION_VALUE GetFactionLevel(uint32 char_id, uint32 npc_id, uint32 p_race, uint32 p_class, uint32 p_deity, int32 pFaction, Mob* tnpc);
+	FACTION_VALUE GetBaseFactionLevel(uint32 p_race, uint32 p_class, uint32 p_deity, int32 pFaction);
+	void InvalidateFactionLevelCache() { faction_level_cache.clear(); }
 	bool ReloadCharacterFaction(Client *c, uint32 facid, uint32 charid);
 	int32 GetCharacterFactionLevel(int32 faction_id);
 	int32 GetModCharacterFactionLevel(int32 faction_id);
@@ -1547,6 +1550,15 @@ private:
 
 	faction_map factionvalues;
 
+	// resolved standing per primary faction, only valid for the race/class/deity it was computed with
+	struct FactionLevelCacheEntry {
+		FACTION_VALUE value;
+		uint32 race;
+		uint32 class_;
+		uint32 deity;
+	};
+	std::unordered_map<int32, FactionLevelCacheEntry> faction_level_cache;
+
 	uint32 tribute_master_id;
 
 	bool npcflag;
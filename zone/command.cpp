@@ -328,6 +328,7 @@ int command_init(void)
 		command_add("pvp", "[on/off] - Set your or your player target's PVP status", 100, command_pvp) ||
 		command_add("qglobal", "[on/off/view] - Toggles qglobal functionality on an NPC", 100, command_qglobal) ||
 		command_add("questerrors", "Shows quest errors.", 100, command_questerrors) ||
+		command_add("questprofile", "[count|reset] - Shows the quest script events with the most total time", 100, command_questprofile) ||
 		command_add("race", "[racenum] - Change your or your target's race. Use racenum 0 to return to normal", 50, command_race) ||
 		command_add("raidloot", "LEADER|GROUPLEADER|SELECTED|ALL - Sets your raid loot settings if you have permission to do so.", 0, command_raidloot) ||
 		command_add("randomfeatures", "- Temporarily randomizes the Facial Features of your target", 80, command_randomfeatures) ||
@@ -10407,7 +10408,11 @@ void command_netstats(Client *c, const Seperator *sep)
 		c->Message(Chat::White, "Resent Non-Fragments: %u (%.2f/sec)", stats.resent_full, stats.resent_full / sec_since_stats_reset);
 		c->Message(Chat::White, "Dropped Datarate Packets: %u (%.2f/sec)", stats.dropped_datarate_packets, stats.dropped_datarate_packets / sec_since_stats_reset);
 
-		if (opts.daybreak_options.outgoing_data_rate > 0.0) {
+		if (opts.daybreak_options.congestion_control) {
+			c->Message(Chat::White, "Congestion Window: %u bytes, In Flight: %u bytes", stats.congestion_window, stats.bytes_in_flight);
+			c->Message(Chat::White, "Smoothed RTT: %u ms, Pacing Rate: %.2fkb/sec", stats.smoothed_rtt, stats.pacing_rate);
+		}
+		else if (opts.daybreak_options.outgoing_data_rate > 0.0) {
 			c->Message(Chat::White, "Outgoing Link Saturation %.2f%% (%.2fkb/sec)", 100.0 * (1.0 - ((opts.daybreak_options.outgoing_data_rate - stats.datarate_remaining) / opts.daybreak_options.outgoing_data_rate)), opts.daybreak_options.outgoing_data_rate);
 		}
 
@@ -12277,6 +12282,44 @@ void command_questerrors(Client *c, const Seperator *sep)
 	}
 }
 
+void command_questprofile(Client *c, const Seperator *sep)
+{
+	if (!strcasecmp(sep->arg[1], "reset")) {
+		parse->GetProfiler().Reset();
+		c->Message(Chat::White, "Quest profile reset.");
+		return;
+	}
+
+	size_t count = 10;
+	if (sep->IsNumber(1)) {
+		count = std::max(1, atoi(sep->arg[1]));
+	}
+
+	auto entries = parse->GetProfiler().GetTop(count);
+	if (entries.empty()) {
+		c->Message(Chat::White, "No quest events have been profiled.");
+		return;
+	}
+
+	c->Message(Chat::White, "Quest events by total time (ms):");
+	for (auto &entry : entries) {
+		c->Message(
+			Chat::White,
+			fmt::format(
+				"{} event {} - calls [{}] total [{:.2f}] avg [{:.3f}] max [{:.2f}] db [{:.2f}] {}",
+				entry.script,
+				entry.event,
+				entry.calls,
+				entry.total_time / 1000.0,
+				entry.total_time / 1000.0 / entry.calls,
+				entry.max_time / 1000.0,
+				entry.db_time / 1000.0,
+				entry.filename
+			).c_str()
+		);
+	}
+}
+
 void command_enablerecipe(Client *c, const Seperator *sep)
 {
 	uint32 recipe_id = 0;
@@ -13229,6 +13272,10 @@ void command_network(Client *c, const Seperator *sep)
 			c->Message(Chat::White, "connection_close_time: %llu", (uint64_t)opts.daybreak_options.connection_close_time);
 			c->Message(Chat::White, "encode_passes[0]: %llu", (uint64_t)opts.daybreak_options.encode_passes[0]);
 			c->Message(Chat::White, "encode_passes[1]: %llu", (uint64_t)opts.daybreak_options.encode_passes[1]);
+			c->Message(Chat::White, "compression_level: %d", opts.daybreak_options.compression_level);
+			c->Message(Chat::White, "compression_min_size: %llu", (uint64_t)opts.daybreak_options.compression_min_size);
+			c->Message(Chat::White, "congestion_control: %s", opts.daybreak_options.congestion_control ? "true" : "false");
+			c->Message(Chat::White, "congestion_window_max: %llu", (uint64_t)opts.daybreak_options.congestion_window_max);
 			c->Message(Chat::White, "port: %llu", (uint64_t)opts.daybreak_options.port);
 		}
 		else {
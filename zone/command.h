@@ -228,6 +228,7 @@ void command_pvp(Client *c, const Seperator *sep);
 void command_qglobal(Client *c, const Seperator *sep);
 void command_qtest(Client *c, const Seperator *sep);
 void command_questerrors(Client *c, const Seperator *sep);
+void command_questprofile(Client *c, const Seperator *sep);
 void command_race(Client *c, const Seperator *sep);
 void command_raidloot(Client* c, const Seperator *sep);
 void command_randomfeatures(Client *c, const Seperator *sep);
@@ -13,7 +13,11 @@
  * @param expires_time
  */
 void DataBucket::SetData(std::string bucket_key, std::string bucket_value, std::string expires_time) {
-	uint64 bucket_id = DataBucket::DoesBucketExist(bucket_key);
+	SetData(database, bucket_key, bucket_value, expires_time);
+}
+
+void DataBucket::SetData(Database &db, std::string bucket_key, std::string bucket_value, std::string expires_time) {
+	uint64 bucket_id = DataBucket::DoesBucketExist(db, bucket_key);
 
 	std::string query;
 	long long expires_time_unix = 0;
@@ -48,7 +52,7 @@ void DataBucket::SetData(std::string bucket_key, std::string bucket_value, std::
 		);
 	}
 
-	database.QueryDatabase(query);
+	db.QueryDatabase(query);
 }
 
 /**
@@ -57,13 +61,17 @@ void DataBucket::SetData(std::string bucket_key, std::string bucket_value, std::
  * @return
  */
 std::string DataBucket::GetData(std::string bucket_key) {
+	return GetData(database, bucket_key);
+}
+
+std::string DataBucket::GetData(Database &db, std::string bucket_key) {
 	std::string query = StringFormat(
 			"SELECT `value` from `data_buckets` WHERE `key` = '%s' AND (`expires` > %lld OR `expires` = 0)  LIMIT 1",
 			bucket_key.c_str(),
 			(long long) std::time(nullptr)
 	);
 
-	auto results = database.QueryDatabase(query);
+	auto results = db.QueryDatabase(query);
 	if (!results.Success()) {
 		return std::string();
 	}
@@ -82,13 +90,17 @@ std::string DataBucket::GetData(std::string bucket_key) {
  * @return
  */
 std::string DataBucket::GetDataExpires(std::string bucket_key) {
+	return GetDataExpires(database, bucket_key);
+}
+
+std::string DataBucket::GetDataExpires(Database &db, std::string bucket_key) {
 	std::string query = StringFormat(
 			"SELECT `expires` from `data_buckets` WHERE `key` = '%s' AND (`expires` > %lld OR `expires` = 0)  LIMIT 1",
 			bucket_key.c_str(),
 			(long long) std::time(nullptr)
 	);
 
-	auto results = database.QueryDatabase(query);
+	auto results = db.QueryDatabase(query);
 	if (!results.Success()) {
 		return std::string();
 	}
@@ -106,14 +118,14 @@ std::string DataBucket::GetDataExpires(std::string bucket_key) {
  * @param bucket_key
  * @return
  */
-uint64 DataBucket::DoesBucketExist(std::string bucket_key) {
+uint64 DataBucket::DoesBucketExist(Database &db, std::string bucket_key) {
 	std::string query = StringFormat(
 			"SELECT `id` from `data_buckets` WHERE `key` = '%s' AND (`expires` > %lld OR `expires` = 0) LIMIT 1",
 			EscapeString(bucket_key).c_str(),
 			(long long) std::time(nullptr)
 	);
 
-	auto results = database.QueryDatabase(query);
+	auto results = db.QueryDatabase(query);
 	if (!results.Success()) {
 		return 0;
 	}
@@ -131,12 +143,16 @@ uint64 DataBucket::DoesBucketExist(std::string bucket_key) {
  * @return
  */
 bool DataBucket::DeleteData(std::string bucket_key) {
+	return DeleteData(database, bucket_key);
+}
+
+bool DataBucket::DeleteData(Database &db, std::string bucket_key) {
 	std::string query = StringFormat(
 			"DELETE FROM `data_buckets` WHERE `key` = '%s'",
 			EscapeString(bucket_key).c_str()
 	);
 
-	auto results = database.QueryDatabase(query);
+	auto results = db.QueryDatabase(query);
 
 	return results.Success();
 }
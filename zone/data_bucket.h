@@ -9,14 +9,22 @@
 #include <string>
 #include "../common/types.h"
 
+class Database;
+
 class DataBucket {
 public:
 	static void SetData(std::string bucket_key, std::string bucket_value, std::string expires_time = "");
 	static bool DeleteData(std::string bucket_key);
 	static std::string GetData(std::string bucket_key);
 	static std::string GetDataExpires(std::string bucket_key);
+
+	// same as above against a connection other than the zone's, for use off the zone thread
+	static void SetData(Database &db, std::string bucket_key, std::string bucket_value, std::string expires_time = "");
+	static bool DeleteData(Database &db, std::string bucket_key);
+	static std::string GetData(Database &db, std::string bucket_key);
+	static std::string GetDataExpires(Database &db, std::string bucket_key);
 private:
-	static uint64 DoesBucketExist(std::string bucket_key);
+	static uint64 DoesBucketExist(Database &db, std::string bucket_key);
 	static uint32 ParseStringTimeToInt(std::string time_string);
 };
 
@@ -122,7 +122,20 @@ const char *QuestEventSubroutines[_LargestEventID] = {
 	"EVENT_BOT_COMMAND"
 };
 
-PerlembParser::PerlembParser() : perl(nullptr)
+static int LazyVarGet(pTHX_ SV *sv, MAGIC *mg)
+{
+	auto var = reinterpret_cast<PerlembParser::LazyVar *>(mg->mg_ptr);
+	if (var->pending) {
+		var->pending = false;
+		var->get(sv);
+	}
+
+	return 0;
+}
+
+static MGVTBL lazy_var_vtbl = { LazyVarGet };
+
+PerlembParser::PerlembParser() : perl(nullptr), lazy_export_(false)
 {
 	global_npc_quest_status_    = questUnloaded;
 	player_quest_status_        = questUnloaded;
@@ -155,6 +168,10 @@ void PerlembParser::ReloadQuests()
 		throw e.what();
 	}
 
+	//the interpreter that owned the magic scalars is gone
+	lazy_vars_.clear();
+	lazy_export_ = RuleB(Quest, PerlLazyExport);
+
 	errors_.clear();
 	npc_quest_status_.clear();
 	global_npc_quest_status_    = questUnloaded;
@@ -162,6 +179,57 @@ void PerlembParser::ReloadQuests()
 	global_player_quest_status_ = questUnloaded;
 	item_quest_status_.clear();
 	spell_quest_status_.clear();
+	loaded_packages_.clear();
+}
+
+bool PerlembParser::UnloadScript(std::string filename)
+{
+	if (!perl) {
+		return false;
+	}
+
+	auto iter = loaded_packages_.find(filename);
+	if (iter == loaded_packages_.end()) {
+		return true;
+	}
+
+	for (auto &loaded : iter->second) {
+		try {
+			perl->unload_file(loaded.package_name.c_str(), filename.c_str());
+		}
+		catch (std::string e) {
+			AddError(fmt::format("Error Unloading Quest File [{}] Package [{}] Error [{}]", filename, loaded.package_name, e));
+			return false;
+		}
+
+		//the magic scalars went away with the package
+		std::string prefix = loaded.package_name + "::";
+		for (auto var = lazy_vars_.begin(); var != lazy_vars_.end();) {
+			var = var->first.compare(0, prefix.length(), prefix) == 0 ? lazy_vars_.erase(var) : std::next(var);
+		}
+
+		if (loaded.status_map) {
+			loaded.status_map->erase(loaded.id);
+		}
+		else {
+			*loaded.status = questUnloaded;
+		}
+	}
+
+	loaded_packages_.erase(iter);
+	return true;
+}
+
+void PerlembParser::TrackPackage(
+	const std::string &filename,
+	const std::string &package_name,
+	PerlQuestStatus *status,
+	std::map<uint32, PerlQuestStatus> *status_map,
+	uint32 id
+)
+{
+	LoadedPackage loaded = { package_name, status, status_map, id };
+	loaded_packages_[filename].push_back(loaded);
 }
 
 int PerlembParser::EventCommon(
@@ -217,7 +285,10 @@ int PerlembParser::EventCommon(
 	}
 
 	/* Check for Mob export event enable */
-	if (parse->perl_event_export_settings[event].mob) {
+	if (parse->perl_event_export_settings[event].mob && lazy_export_) {
+		ExportMobVariablesLazy(isPlayerQuest, isGlobalPlayerQuest, isItemQuest, isSpellQuest, package_name, mob, npcmob);
+	}
+	else if (parse->perl_event_export_settings[event].mob) {
 		ExportMobVariables(
 			isPlayerQuest,
 			isGlobalPlayerQuest,
@@ -231,7 +302,10 @@ int PerlembParser::EventCommon(
 	}
 
 	/* Check for Zone export event enable */
-	if (parse->perl_event_export_settings[event].zone) {
+	if (parse->perl_event_export_settings[event].zone && lazy_export_) {
+		ExportZoneVariablesLazy(package_name);
+	}
+	else if (parse->perl_event_export_settings[event].zone) {
 		ExportZoneVariables(package_name);
 	}
 
@@ -471,10 +545,12 @@ void PerlembParser::LoadNPCScript(std::string filename, int npc_id)
 		);
 
 		npc_quest_status_[npc_id] = questFailedToLoad;
+		TrackPackage(filename, package_name.str(), nullptr, &npc_quest_status_, npc_id);
 		return;
 	}
 
 	npc_quest_status_[npc_id] = questLoaded;
+	TrackPackage(filename, package_name.str(), nullptr, &npc_quest_status_, npc_id);
 }
 
 void PerlembParser::LoadGlobalNPCScript(std::string filename)
@@ -500,10 +576,12 @@ void PerlembParser::LoadGlobalNPCScript(std::string filename)
 		);
 
 		global_npc_quest_status_ = questFailedToLoad;
+		TrackPackage(filename, "qst_global_npc", &global_npc_quest_status_);
 		return;
 	}
 
 	global_npc_quest_status_ = questLoaded;
+	TrackPackage(filename, "qst_global_npc", &global_npc_quest_status_);
 }
 
 void PerlembParser::LoadPlayerScript(std::string filename)
@@ -529,10 +607,12 @@ void PerlembParser::LoadPlayerScript(std::string filename)
 		);
 
 		player_quest_status_ = questFailedToLoad;
+		TrackPackage(filename, "qst_player", &player_quest_status_);
 		return;
 	}
 
 	player_quest_status_ = questLoaded;
+	TrackPackage(filename, "qst_player", &player_quest_status_);
 }
 
 void PerlembParser::LoadGlobalPlayerScript(std::string filename)
@@ -558,10 +638,12 @@ void PerlembParser::LoadGlobalPlayerScript(std::string filename)
 		);
 
 		global_player_quest_status_ = questFailedToLoad;
+		TrackPackage(filename, "qst_global_player", &global_player_quest_status_);
 		return;
 	}
 
 	global_player_quest_status_ = questLoaded;
+	TrackPackage(filename, "qst_global_player", &global_player_quest_status_);
 }
 
 void PerlembParser::LoadItemScript(std::string filename, EQ::ItemInstance *item)
@@ -596,10 +678,12 @@ void PerlembParser::LoadItemScript(std::string filename, EQ::ItemInstance *item)
 		);
 
 		item_quest_status_[item->GetID()] = questFailedToLoad;
+		TrackPackage(filename, package_name.str(), nullptr, &item_quest_status_, item->GetID());
 		return;
 	}
 
 	item_quest_status_[item->GetID()] = questLoaded;
+	TrackPackage(filename, package_name.str(), nullptr, &item_quest_status_, item->GetID());
 }
 
 void PerlembParser::LoadSpellScript(std::string filename, uint32 spell_id)
@@ -630,10 +714,12 @@ void PerlembParser::LoadSpellScript(std::string filename, uint32 spell_id)
 		);
 
 		spell_quest_status_[spell_id] = questFailedToLoad;
+		TrackPackage(filename, package_name.str(), nullptr, &spell_quest_status_, spell_id);
 		return;
 	}
 
 	spell_quest_status_[spell_id] = questLoaded;
+	TrackPackage(filename, package_name.str(), nullptr, &spell_quest_status_, spell_id);
 }
 
 void PerlembParser::AddVar(std::string name, std::string val)
@@ -770,6 +856,24 @@ void PerlembParser::ExportVar(const char *pkgprefix, const char *varname, const
 	}
 }
 
+void PerlembParser::ExportLazyVar(const std::string &package_name, const char *varname, std::function<void(SV *sv)> get)
+{
+	if (!perl) {
+		return;
+	}
+
+	std::string full_name = package_name + "::" + varname;
+	auto &var = lazy_vars_[full_name];
+	if (!var) {
+		var.reset(new LazyVar);
+		SV *sv = get_sv(full_name.c_str(), true);
+		sv_magicext(sv, nullptr, PERL_MAGIC_ext, &lazy_var_vtbl, reinterpret_cast<const char *>(var.get()), 0);
+	}
+
+	var->get     = std::move(get);
+	var->pending = true;
+}
+
 int PerlembParser::SendCommands(
 	const char *pkgprefix,
 	const char *event,
@@ -1255,36 +1359,251 @@ void PerlembParser::ExportZoneVariables(std::string &package_name)
 	}
 }
 
-void PerlembParser::ExportItemVariables(std::string &package_name, Mob *mob)
+/*
+ * Same variables as ExportMobVariables, but nothing is computed until the script reads it.
+ * The entities are looked up again by id at that point since a read can come after the event.
+ */
+void PerlembParser::ExportMobVariablesLazy(
+	bool isPlayerQuest, bool isGlobalPlayerQuest, bool isItemQuest, bool isSpellQuest,
+	std::string &package_name, Mob *mob, NPC *npcmob
+)
 {
+	uint16 mob_id = mob ? mob->GetID() : 0;
+	uint16 npc_id = npcmob ? npcmob->GetID() : 0;
+
 	if (mob && mob->IsClient()) {
-		std::string hashname = package_name + std::string("::hasitem");
-
-		//start with an empty hash
-		perl->eval(std::string("%").append(hashname).append(" = ();").c_str());
-
-		for (int slot = EQ::invslot::EQUIPMENT_BEGIN; slot <= EQ::invslot::GENERAL_END; slot++) {
-			char *hi_decl = nullptr;
-			int  itemid   = mob->CastToClient()->GetItemIDAt(slot);
-			if (itemid != -1 && itemid != 0) {
-				MakeAnyLenString(&hi_decl, "push (@{$%s{%d}},%d);", hashname.c_str(), itemid, slot);
-				perl->eval(hi_decl);
-				safe_delete_array(hi_decl);
+		ExportLazyVar(package_name, "uguild_id", [mob_id](SV *sv) {
+			Client *c = entity_list.GetClientByID(mob_id);
+			if (c) {
+				sv_setiv(sv, c->GuildID());
+			}
+		});
+		ExportLazyVar(package_name, "uguildrank", [mob_id](SV *sv) {
+			Client *c = entity_list.GetClientByID(mob_id);
+			if (c) {
+				sv_setiv(sv, c->GuildRank());
+			}
+		});
+		ExportLazyVar(package_name, "status", [mob_id](SV *sv) {
+			Client *c = entity_list.GetClientByID(mob_id);
+			if (c) {
+				sv_setiv(sv, c->Admin());
 			}
+		});
+	}
+
+	if (mob) {
+		ExportLazyVar(package_name, "name", [mob_id](SV *sv) {
+			Mob *m = entity_list.GetMob(mob_id);
+			if (m) {
+				sv_setpv(sv, m->GetName());
+			}
+		});
+		ExportLazyVar(package_name, "race", [mob_id](SV *sv) {
+			Mob *m = entity_list.GetMob(mob_id);
+			if (m) {
+				sv_setpv(sv, GetRaceIDName(m->GetRace()));
+			}
+		});
+		ExportLazyVar(package_name, "class", [mob_id](SV *sv) {
+			Mob *m = entity_list.GetMob(mob_id);
+			if (m) {
+				sv_setpv(sv, GetClassIDName(m->GetClass()));
+			}
+		});
+		ExportLazyVar(package_name, "ulevel", [mob_id](SV *sv) {
+			Mob *m = entity_list.GetMob(mob_id);
+			if (m) {
+				sv_setiv(sv, m->GetLevel());
+			}
+		});
+		ExportLazyVar(package_name, "userid", [mob_id](SV *sv) {
+			sv_setiv(sv, mob_id);
+		});
+	}
+
+	if (isPlayerQuest || isGlobalPlayerQuest || isItemQuest || isSpellQuest) {
+		return;
+	}
+
+	if (npcmob) {
+		ExportLazyVar(package_name, "mname", [npc_id](SV *sv) {
+			Mob *n = entity_list.GetMob(npc_id);
+			if (n) {
+				sv_setpv(sv, n->GetName());
+			}
+		});
+		ExportLazyVar(package_name, "mobid", [npc_id](SV *sv) {
+			sv_setiv(sv, npc_id);
+		});
+		ExportLazyVar(package_name, "mlevel", [npc_id](SV *sv) {
+			Mob *n = entity_list.GetMob(npc_id);
+			if (n) {
+				sv_setiv(sv, n->GetLevel());
+			}
+		});
+		ExportLazyVar(package_name, "hpratio", [npc_id](SV *sv) {
+			Mob *n = entity_list.GetMob(npc_id);
+			if (n) {
+				sv_setnv(sv, n->GetHPRatio());
+			}
+		});
+		ExportLazyVar(package_name, "x", [npc_id](SV *sv) {
+			Mob *n = entity_list.GetMob(npc_id);
+			if (n) {
+				sv_setnv(sv, n->GetX());
+			}
+		});
+		ExportLazyVar(package_name, "y", [npc_id](SV *sv) {
+			Mob *n = entity_list.GetMob(npc_id);
+			if (n) {
+				sv_setnv(sv, n->GetY());
+			}
+		});
+		ExportLazyVar(package_name, "z", [npc_id](SV *sv) {
+			Mob *n = entity_list.GetMob(npc_id);
+			if (n) {
+				sv_setnv(sv, n->GetZ());
+			}
+		});
+		ExportLazyVar(package_name, "h", [npc_id](SV *sv) {
+			Mob *n = entity_list.GetMob(npc_id);
+			if (n) {
+				sv_setnv(sv, n->GetHeading());
+			}
+		});
+		if (npcmob->GetTarget()) {
+			ExportLazyVar(package_name, "targetid", [npc_id](SV *sv) {
+				Mob *n = entity_list.GetMob(npc_id);
+				if (n && n->GetTarget()) {
+					sv_setiv(sv, n->GetTarget()->GetID());
+				}
+			});
+			ExportLazyVar(package_name, "targetname", [npc_id](SV *sv) {
+				Mob *n = entity_list.GetMob(npc_id);
+				if (n && n->GetTarget()) {
+					sv_setpv(sv, n->GetTarget()->GetName());
+				}
+			});
 		}
 	}
 
-	if (mob && mob->IsClient()) {
-		std::string hashname = package_name + std::string("::oncursor");
-		perl->eval(std::string("%").append(hashname).append(" = ();").c_str());
-		char *hi_decl = nullptr;
-		int  itemid   = mob->CastToClient()->GetItemIDAt(EQ::invslot::slotCursor);
+	if (mob && npcmob && mob->IsClient()) {
+		ExportLazyVar(package_name, "faction", [mob_id, npc_id](SV *sv) {
+			Client *c = entity_list.GetClientByID(mob_id);
+			NPC    *n = entity_list.GetNPCByID(npc_id);
+			if (!c || !n) {
+				return;
+			}
+
+			uint8 fac = c->GetFactionLevel(
+				c->CharacterID(), n->GetID(), c->GetFactionRace(),
+				c->GetClass(), c->GetDeity(), n->GetPrimaryFaction(), n
+			);
+			if (fac) {
+				sv_setpv(sv, itoa(fac));
+			}
+		});
+	}
+}
+
+void PerlembParser::ExportZoneVariablesLazy(std::string &package_name)
+{
+	if (!zone) {
+		return;
+	}
+
+	ExportLazyVar(package_name, "zoneid", [](SV *sv) {
+		if (zone) {
+			sv_setiv(sv, zone->GetZoneID());
+		}
+	});
+	ExportLazyVar(package_name, "zoneln", [](SV *sv) {
+		if (zone) {
+			sv_setpv(sv, zone->GetLongName());
+		}
+	});
+	ExportLazyVar(package_name, "zonesn", [](SV *sv) {
+		if (zone) {
+			sv_setpv(sv, zone->GetShortName());
+		}
+	});
+	ExportLazyVar(package_name, "instanceid", [](SV *sv) {
+		if (zone) {
+			sv_setiv(sv, zone->GetInstanceID());
+		}
+	});
+	ExportLazyVar(package_name, "instanceversion", [](SV *sv) {
+		if (zone) {
+			sv_setiv(sv, zone->GetInstanceVersion());
+		}
+	});
+	ExportLazyVar(package_name, "zonehour", [](SV *sv) {
+		if (zone) {
+			TimeOfDay_Struct eqTime;
+			zone->zone_time.GetCurrentEQTimeOfDay(time(0), &eqTime);
+			sv_setiv(sv, eqTime.hour - 1);
+		}
+	});
+	ExportLazyVar(package_name, "zonemin", [](SV *sv) {
+		if (zone) {
+			TimeOfDay_Struct eqTime;
+			zone->zone_time.GetCurrentEQTimeOfDay(time(0), &eqTime);
+			sv_setiv(sv, eqTime.minute);
+		}
+	});
+	ExportLazyVar(package_name, "zonetime", [](SV *sv) {
+		if (zone) {
+			TimeOfDay_Struct eqTime;
+			zone->zone_time.GetCurrentEQTimeOfDay(time(0), &eqTime);
+			sv_setiv(sv, (eqTime.hour - 1) * 100 + eqTime.minute);
+		}
+	});
+	ExportLazyVar(package_name, "zoneweather", [](SV *sv) {
+		if (zone) {
+			sv_setiv(sv, zone->zone_weather);
+		}
+	});
+}
+
+void PerlembParser::ExportItemVariables(std::string &package_name, Mob *mob)
+{
+	if (!perl || !mob || !mob->IsClient()) {
+		return;
+	}
+
+	// %hasitem and %oncursor map item id => [slots], built directly rather than eval'ing a push per slot
+	auto push_slot = [](HV *hv, int itemid, int slot) {
+		std::string key = std::to_string(itemid);
+		SV **entry = hv_fetch(hv, key.c_str(), static_cast<I32>(key.length()), 0);
+		AV *slots;
+		if (entry && SvROK(*entry)) {
+			slots = reinterpret_cast<AV *>(SvRV(*entry));
+		}
+		else {
+			slots = newAV();
+			hv_store(hv, key.c_str(), static_cast<I32>(key.length()), newRV_noinc(reinterpret_cast<SV *>(slots)), 0);
+		}
+		av_push(slots, newSViv(slot));
+	};
+
+	Client *client = mob->CastToClient();
+
+	HV *hasitem = get_hv((package_name + "::hasitem").c_str(), true);
+	hv_clear(hasitem);
+	for (int slot = EQ::invslot::EQUIPMENT_BEGIN; slot <= EQ::invslot::GENERAL_END; slot++) {
+		int itemid = client->GetItemIDAt(slot);
 		if (itemid != -1 && itemid != 0) {
-			MakeAnyLenString(&hi_decl, "push (@{$%s{%d}},%d);", hashname.c_str(), itemid, EQ::invslot::slotCursor);
-			perl->eval(hi_decl);
-			safe_delete_array(hi_decl);
+			push_slot(hasitem, itemid, slot);
 		}
 	}
+
+	HV *oncursor = get_hv((package_name + "::oncursor").c_str(), true);
+	hv_clear(oncursor);
+	int itemid = client->GetItemIDAt(EQ::invslot::slotCursor);
+	if (itemid != -1 && itemid != 0) {
+		push_slot(oncursor, itemid, EQ::invslot::slotCursor);
+	}
 }
 
 void PerlembParser::ExportEventVariables(
@@ -25,6 +25,9 @@
 #include <string>
 #include <queue>
 #include <map>
+#include <memory>
+#include <functional>
+#include <unordered_map>
 #include "embperl.h"
 
 class Mob;
@@ -45,6 +48,12 @@ typedef enum
 
 class PerlembParser : public QuestInterface {
 public:
+	//a package variable whose value is filled in by get the first time a script reads it after export
+	struct LazyVar {
+		std::function<void(SV *sv)> get;
+		bool pending;
+	};
+
 	PerlembParser();
 	~PerlembParser();
 	
@@ -78,6 +87,7 @@ public:
 	virtual void AddVar(std::string name, std::string val);
 	virtual std::string GetVar(std::string name);
 	virtual void ReloadQuests();
+	virtual bool UnloadScript(std::string filename);
 	virtual uint32 GetIdentifier() { return 0xf8b05c11; }
 
 private:
@@ -89,6 +99,7 @@ private:
 	void ExportVar(const char *pkgprefix, const char *varname, uint32 value);
 	void ExportVar(const char *pkgprefix, const char *varname, float value);
 	void ExportVarComplex(const char *pkgprefix, const char *varname, const char *value);
+	void ExportLazyVar(const std::string &package_name, const char *varname, std::function<void(SV *sv)> get);
 
 	int EventCommon(QuestEventID event, uint32 objid, const char * data, NPC* npcmob, EQ::ItemInstance* item_inst, Mob* mob, 
 		uint32 extradata, bool global, std::vector<EQ::Any> *extra_pointers);
@@ -105,7 +116,10 @@ private:
 		bool isSpellQuest, std::string &package_name, NPC *npcmob, Mob *mob, int char_id);
 	void ExportMobVariables(bool isPlayerQuest, bool isGlobalPlayerQuest, bool isGlobalNPC, bool isItemQuest, 
 		bool isSpellQuest, std::string &package_name, Mob *mob, NPC *npcmob);
+	void ExportMobVariablesLazy(bool isPlayerQuest, bool isGlobalPlayerQuest, bool isItemQuest, bool isSpellQuest,
+		std::string &package_name, Mob *mob, NPC *npcmob);
 	void ExportZoneVariables(std::string &package_name);
+	void ExportZoneVariablesLazy(std::string &package_name);
 	void ExportItemVariables(std::string &package_name, Mob *mob);
 	void ExportEventVariables(std::string &package_name, QuestEventID event, uint32 objid, const char * data, 
 		NPC* npcmob, EQ::ItemInstance* item_inst, Mob* mob, uint32 extradata, std::vector<EQ::Any> *extra_pointers);
@@ -119,7 +133,23 @@ private:
 
 	std::map<std::string, std::string> vars_;
 	SV *_empty_sv;
+
+	bool lazy_export_;
+	std::unordered_map<std::string, std::unique_ptr<LazyVar>> lazy_vars_;
 	std::map<std::string, int> clear_vars_;
+
+	struct LoadedPackage {
+		std::string package_name;
+		PerlQuestStatus *status;
+		std::map<uint32, PerlQuestStatus> *status_map;
+		uint32 id;
+	};
+
+	void TrackPackage(const std::string &filename, const std::string &package_name, PerlQuestStatus *status,
+		std::map<uint32, PerlQuestStatus> *status_map = nullptr, uint32 id = 0);
+
+	//packages compiled from each quest file, so a changed file can be unloaded on its own
+	std::map<std::string, std::vector<LoadedPackage>> loaded_packages_;
 };
 
 #endif
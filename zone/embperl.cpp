@@ -259,6 +259,13 @@ void Embperl::init_eval_file(void)
 */
 			"}"
 		"}"
+		"sub unload_file {"
+			"my($package, $filename) = @_;"
+			"$filename=~s/\'//g;"
+			"delete $INC{\"./$filename\"};"
+			"delete $Cache{$package};"
+			"delete_package($package);"
+		"}"
 		,FALSE);
  }
 
@@ -270,6 +277,14 @@ int Embperl::eval_file(const char * packagename, const char * filename)
 	return dosub("main::eval_file", &args);
 }
 
+int Embperl::unload_file(const char * packagename, const char * filename)
+{
+	std::vector<std::string> args;
+	args.push_back(packagename);
+	args.push_back(filename);
+	return dosub("main::unload_file", &args);
+}
+
 int Embperl::dosub(const char * subname, const std::vector<std::string> * args, int mode)
 {
 	dSP;
@@ -164,6 +164,8 @@ public:
 	//loads a file and compiles it into our interpreter (assuming it hasn't already been read in)
 	//idea borrowed from perlembed
 	int eval_file(const char * packagename, const char * filename);
+	//drops a package read in by eval_file so the next eval_file compiles the file again
+	int unload_file(const char * packagename, const char * filename);
 
 	inline bool InUse() const { return(in_use); }
 
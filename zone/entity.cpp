@@ -3598,25 +3598,30 @@ void EntityList::AddProximity(NPC *proximity_for)
 {
 	RemoveProximity(proximity_for->GetID());
 
-	proximity_list.push_back(proximity_for);
+	if (!proximity_for->proximity)
+		proximity_for->proximity = new NPCProximity; // deleted in NPC::~NPC
+}
+
+// indexes the NPC's proximity box, call once its bounds are set
+void EntityList::UpdateProximity(NPC *proximity_for)
+{
+	NPCProximity *l = proximity_for->proximity;
+	if (l == nullptr) {
+		RemoveProximity(proximity_for->GetID());
+		return;
+	}
 
-	proximity_for->proximity = new NPCProximity; // deleted in NPC::~NPC
+	proximity_grid.Set(proximity_for->GetID(), l->min_x, l->max_x, l->min_y, l->max_y, l->min_z, l->max_z);
 }
 
 bool EntityList::RemoveProximity(uint16 delete_npc_id)
 {
-	auto it = std::find_if(proximity_list.begin(), proximity_list.end(),
-			[delete_npc_id](const NPC *a) { return a->GetID() == delete_npc_id; });
-	if (it == proximity_list.end())
-		return false;
-
-	proximity_list.erase(it);
-	return true;
+	return proximity_grid.Remove(delete_npc_id);
 }
 
 void EntityList::RemoveAllLocalities()
 {
-	proximity_list.clear();
+	proximity_grid.Clear();
 }
 
 struct quest_proximity_event {
@@ -3634,8 +3639,18 @@ void EntityList::ProcessMove(Client *c, const glm::vec3& location)
 	float last_z = c->ProximityZ();
 
 	std::list<quest_proximity_event> events;
-	for (auto iter = proximity_list.begin(); iter != proximity_list.end(); ++iter) {
-		NPC *d = (*iter);
+
+	// only boxes holding the old or the new position can produce an event
+	proximity_hits.clear();
+	proximity_grid.Query(last_x, last_y, last_z, proximity_hits);
+	proximity_grid.Query(location.x, location.y, location.z, proximity_hits);
+	std::sort(proximity_hits.begin(), proximity_hits.end());
+	proximity_hits.erase(std::unique(proximity_hits.begin(), proximity_hits.end()), proximity_hits.end());
+
+	for (int npc_id : proximity_hits) {
+		NPC *d = GetNPCByID(npc_id);
+		if (d == nullptr)
+			continue;
 		NPCProximity *l = d->proximity;
 		if (l == nullptr)
 			continue;
@@ -3834,18 +3849,19 @@ void EntityList::ProcessProximitySay(const char *Message, Client *c, uint8 langu
 	if (!Message || !c)
 		return;
 
-	auto iter = proximity_list.begin();
-	for (; iter != proximity_list.end(); ++iter) {
-		NPC *d = (*iter);
+	// copied, the events below may move the client or change proximities
+	std::vector<int> hits;
+	proximity_grid.Query(c->GetX(), c->GetY(), c->GetZ(), hits);
+	std::sort(hits.begin(), hits.end());
+
+	for (int npc_id : hits) {
+		NPC *d = GetNPCByID(npc_id);
+		if (d == nullptr)
+			continue;
 		NPCProximity *l = d->proximity;
 		if (l == nullptr || !l->say)
 			continue;
 
-		if (c->GetX() < l->min_x || c->GetX() > l->max_x
-				|| c->GetY() < l->min_y || c->GetY() > l->max_y
-				|| c->GetZ() < l->min_z || c->GetZ() > l->max_z)
-			continue;
-
 		parse->EventNPC(EVENT_PROXIMITY_SAY, d, c, Message, language);
 	}
 }
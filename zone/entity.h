@@ -30,6 +30,7 @@
 #include "position.h"
 #include "zonedump.h"
 #include "common.h"
+#include "proximity_grid.h"
 
 class Encounter;
 class Beacon;
@@ -279,6 +280,7 @@ public:
 	void	AddBeacon(Beacon *beacon);
 	void	AddEncounter(Encounter *encounter);
 	void	AddProximity(NPC *proximity_for);
+	void	UpdateProximity(NPC *proximity_for);
 	void	Clear();
 	bool	RemoveMob(uint16 delete_id);
 	bool	RemoveMob(Mob* delete_mob);
@@ -556,7 +558,8 @@ private:
 	std::unordered_map<uint16, Trap *> trap_list;
 	std::unordered_map<uint16, Beacon *> beacon_list;
 	std::unordered_map<uint16, Encounter *> encounter_list;
-	std::list<NPC *> proximity_list;
+	ProximityGrid proximity_grid; // npc id -> proximity box
+	std::vector<int> proximity_hits;
 	std::list<Group *> group_list;
 	std::list<Raid *> raid_list;
 	std::list<Area> area_list;
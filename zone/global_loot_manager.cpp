@@ -7,13 +7,11 @@ extern Zone *zone;
 
 std::vector<int> GlobalLootManager::GetGlobalLootTables(NPC *mob) const
 {
-	// we may be able to add a cache here if performance is an issue, but for now
-	// just return NRVO'd vector
-	// The cache would have to be keyed by NPCType and level (for NPCs with Max Level set)
 	std::vector<int> tables;
 
-	for (auto &e : m_entries) {
-		if (e.PassesRules(mob)) {
+	for (auto index : GetIndexedEntries(mob)) {
+		auto &e = m_entries[index];
+		if (e.PassesDynamicRules(mob)) {
 			tables.push_back(e.GetLootTableID());
 		}
 	}
@@ -21,6 +19,37 @@ std::vector<int> GlobalLootManager::GetGlobalLootTables(NPC *mob) const
 	return tables;
 }
 
+uint64 GlobalLootManager::MakeRuleKey(uint8 level, uint16 race, uint8 class_, uint8 bodytype)
+{
+	return static_cast<uint64>(level) | (static_cast<uint64>(class_) << 8) |
+	       (static_cast<uint64>(bodytype) << 16) | (static_cast<uint64>(race) << 24);
+}
+
+// Level, race, class and bodytype never change for a given NPC type, so the entries passing them are
+// resolved once per combination and shared by every later spawn; zone limits are applied at load time.
+const std::vector<size_t> &GlobalLootManager::GetIndexedEntries(NPC *mob) const
+{
+	uint8 level    = mob->GetLevel();
+	uint16 race    = mob->GetRace();
+	uint8 class_   = mob->GetClass();
+	uint8 bodytype = mob->GetBodyType();
+
+	auto key  = MakeRuleKey(level, race, class_, bodytype);
+	auto iter = m_rule_index.find(key);
+	if (iter != m_rule_index.end()) {
+		return iter->second;
+	}
+
+	auto &entries = m_rule_index[key];
+	for (size_t i = 0; i < m_entries.size(); ++i) {
+		if (m_entries[i].PassesStaticRules(level, race, class_, bodytype)) {
+			entries.push_back(i);
+		}
+	}
+
+	return entries;
+}
+
 void GlobalLootManager::ShowZoneGlobalLoot(Client *to) const
 {
 	for (auto &e : m_entries)
@@ -36,6 +65,12 @@ void GlobalLootManager::ShowNPCGlobalLoot(Client *to, NPC *who) const
 }
 
 bool GlobalLootEntry::PassesRules(NPC *mob) const
+{
+	return PassesStaticRules(mob->GetLevel(), mob->GetRace(), mob->GetClass(), mob->GetBodyType()) &&
+	       PassesDynamicRules(mob);
+}
+
+bool GlobalLootEntry::PassesStaticRules(uint8 level, uint16 race, uint8 class_, uint8 bodytype) const
 {
 	bool bRace = false;
 	bool bPassesRace = false;
@@ -47,46 +82,28 @@ bool GlobalLootEntry::PassesRules(NPC *mob) const
 	for (auto &r : m_rules) {
 		switch (r.type) {
 		case GlobalLoot::RuleTypes::LevelMin:
-			if (mob->GetLevel() < r.value)
+			if (level < r.value)
 				return false;
 			break;
 		case GlobalLoot::RuleTypes::LevelMax:
-			if (mob->GetLevel() > r.value)
-				return false;
-			break;
-		case GlobalLoot::RuleTypes::Raid: // value == 0 must not be raid, value != 0 must be raid
-			if (mob->IsRaidTarget() && !r.value)
-				return false;
-			if (!mob->IsRaidTarget() && r.value)
-				return false;
-			break;
-		case GlobalLoot::RuleTypes::Rare:
-			if (mob->IsRareSpawn() && !r.value)
-				return false;
-			if (!mob->IsRareSpawn() && r.value)
+			if (level > r.value)
 				return false;
 			break;
 		case GlobalLoot::RuleTypes::Race: // can have multiple races per rule set
 			bRace = true; // we must pass race
-			if (mob->GetRace() == r.value)
+			if (race == r.value)
 				bPassesRace = true;
 			break;
 		case GlobalLoot::RuleTypes::Class: // can have multiple classes per rule set
 			bClass = true; // we must pass class
-			if (mob->GetClass() == r.value)
+			if (class_ == r.value)
 				bPassesClass = true;
 			break;
 		case GlobalLoot::RuleTypes::BodyType: // can have multiple bodytypes per rule set
 			bBodyType = true; // we must pass BodyType
-			if (mob->GetBodyType() == r.value)
+			if (bodytype == r.value)
 				bPassesBodyType = true;
 			break;
-		case GlobalLoot::RuleTypes::HotZone: // value == 0 must not be hot_zone, value != must be hot_zone
-			if (zone->IsHotzone() && !r.value)
-				return false;
-			if (!zone->IsHotzone() && r.value)
-				return false;
-			break;
 		default:
 			break;
 		}
@@ -101,7 +118,37 @@ bool GlobalLootEntry::PassesRules(NPC *mob) const
 	if (bBodyType && !bPassesBodyType)
 		return false;
 
-	// we abort as early as possible if we fail a rule, so if we get here, we passed
 	return true;
 }
 
+// rules that depend on the individual spawn or zone state and can't be indexed
+bool GlobalLootEntry::PassesDynamicRules(NPC *mob) const
+{
+	for (auto &r : m_rules) {
+		switch (r.type) {
+		case GlobalLoot::RuleTypes::Raid: // value == 0 must not be raid, value != 0 must be raid
+			if (mob->IsRaidTarget() && !r.value)
+				return false;
+			if (!mob->IsRaidTarget() && r.value)
+				return false;
+			break;
+		case GlobalLoot::RuleTypes::Rare:
+			if (mob->IsRareSpawn() && !r.value)
+				return false;
+			if (!mob->IsRareSpawn() && r.value)
+				return false;
+			break;
+		case GlobalLoot::RuleTypes::HotZone: // value == 0 must not be hot_zone, value != must be hot_zone
+			if (zone->IsHotzone() && !r.value)
+				return false;
+			if (!zone->IsHotzone() && r.value)
+				return false;
+			break;
+		default:
+			break;
+		}
+	}
+
+	// we abort as early as possible if we fail a rule, so if we get here, we passed
+	return true;
+}
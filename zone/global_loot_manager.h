@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include "../common/types.h"
 
 class NPC;
 class Client;
@@ -39,6 +41,8 @@ public:
 		: m_id(id), m_loottable_id(loottable), m_description(std::move(des))
 	{ }
 	bool PassesRules(NPC *mob) const;
+	bool PassesStaticRules(uint8 level, uint16 race, uint8 class_, uint8 bodytype) const;
+	bool PassesDynamicRules(NPC *mob) const;
 	inline int GetLootTableID() const { return m_loottable_id; }
 	inline int GetID() const { return m_id; }
 	inline const std::string &GetDescription() const { return m_description; }
@@ -50,11 +54,16 @@ public:
 
 class GlobalLootManager {
 	std::vector<GlobalLootEntry> m_entries;
+	// entries passing the level/race/class/bodytype rules, keyed by MakeRuleKey
+	mutable std::unordered_map<uint64, std::vector<size_t>> m_rule_index;
+
+	static uint64 MakeRuleKey(uint8 level, uint16 race, uint8 class_, uint8 bodytype);
+	const std::vector<size_t> &GetIndexedEntries(NPC *mob) const;
 
 public:
 	std::vector<int> GetGlobalLootTables(NPC *mob) const;
-	inline void Clear() { m_entries.clear(); }
-	inline void AddEntry(GlobalLootEntry &in) { m_entries.push_back(in); }
+	inline void Clear() { m_entries.clear(); m_rule_index.clear(); }
+	inline void AddEntry(GlobalLootEntry &in) { m_entries.push_back(in); m_rule_index.clear(); }
 	void ShowZoneGlobalLoot(Client *to) const;
 	void ShowNPCGlobalLoot(Client *to, NPC *who) const;
 };
@@ -28,6 +28,7 @@
 #include "zonedb.h"
 #include "global_loot_manager.h"
 
+#include <algorithm>
 #include <iostream>
 #include <stdlib.h>
 
@@ -145,80 +146,37 @@ void ZoneDatabase::AddLootDropToNPC(NPC* npc,uint32 lootdrop_id, ItemList* iteml
 		droplimit = mindrop;
 	}
 
-	float roll_t = 0.0f;
-	float roll_t_min = 0.0f;
-	bool active_item_list = false;
-	for(uint32 i = 0; i < lds->NumEntries; ++i) {
-		const EQ::ItemData* db_item = GetItem(lds->Entries[i].item_id);
-		if(db_item) {
-			roll_t += lds->Entries[i].chance;
-			active_item_list = true;
-		}
-	}
-
-	roll_t_min = roll_t;
-	roll_t = EQ::ClampLower(roll_t, 100.0f);
-
-	if(!active_item_list) {
+	const LootDropRollTable &roll_table = GetLootDropRollTable(lootdrop_id, lds);
+	if(roll_table.entries.empty()) {
 		return;
 	}
 
-	for(int i = 0; i < mindrop; ++i) {
-		float roll = (float)zone->random.Real(0.0, roll_t_min);
-		for(uint32 j = 0; j < lds->NumEntries; ++j) {
-			const EQ::ItemData* db_item = GetItem(lds->Entries[j].item_id);
-			if(db_item) {
-				if(roll < lds->Entries[j].chance) {
-					npc->AddLootDrop(db_item, itemlist, lds->Entries[j].item_charges, lds->Entries[j].minlevel,
-									 lds->Entries[j].maxlevel, lds->Entries[j].equip_item > 0 ? true : false, false);
-
-					int charges = (int)lds->Entries[i].multiplier;
-					charges = EQ::ClampLower(charges, 1);
-
-					for(int k = 1; k < charges; ++k) {
-						float c_roll = (float)zone->random.Real(0.0, 100.0);
-						if(c_roll <= lds->Entries[i].chance) {
-							npc->AddLootDrop(db_item, itemlist, lds->Entries[j].item_charges, lds->Entries[j].minlevel,
-											 lds->Entries[j].maxlevel, lds->Entries[j].equip_item > 0 ? true : false, false);
-						}
-					}
+	float roll_t_min = roll_table.total_chance;
+	float roll_t = EQ::ClampLower(roll_table.total_chance, 100.0f);
 
-					j = lds->NumEntries;
-					break;
-				}
-				else {
-					roll -= lds->Entries[j].chance;
-				}
-			}
+	for(int i = 0; i < droplimit; ++i) {
+		// the first mindrop rolls are guaranteed a drop, the rest may miss when the chances add up to less than 100
+		float roll = (float)zone->random.Real(0.0, i < mindrop ? roll_t_min : roll_t);
+		auto pick = std::upper_bound(roll_table.cumulative_chance.begin(), roll_table.cumulative_chance.end(), roll);
+		if(pick == roll_table.cumulative_chance.end()) {
+			continue;
 		}
-	}
 
-	for(int i = mindrop; i < droplimit; ++i) {
-		float roll = (float)zone->random.Real(0.0, roll_t);
-		for(uint32 j = 0; j < lds->NumEntries; ++j) {
-			const EQ::ItemData* db_item = GetItem(lds->Entries[j].item_id);
-			if(db_item) {
-				if(roll < lds->Entries[j].chance) {
-					npc->AddLootDrop(db_item, itemlist, lds->Entries[j].item_charges, lds->Entries[j].minlevel,
-										lds->Entries[j].maxlevel, lds->Entries[j].equip_item > 0 ? true : false, false);
-
-					int charges = (int)lds->Entries[i].multiplier;
-					charges = EQ::ClampLower(charges, 1);
-
-					for(int k = 1; k < charges; ++k) {
-						float c_roll = (float)zone->random.Real(0.0, 100.0);
-						if(c_roll <= lds->Entries[i].chance) {
-							npc->AddLootDrop(db_item, itemlist, lds->Entries[j].item_charges, lds->Entries[j].minlevel,
-											lds->Entries[j].maxlevel, lds->Entries[j].equip_item > 0 ? true : false, false);
-						}
-					}
+		size_t index = pick - roll_table.cumulative_chance.begin();
+		const EQ::ItemData* db_item = roll_table.items[index];
+		const LootDropEntries_Struct &entry = lds->Entries[roll_table.entries[index]];
 
-					j = lds->NumEntries;
-					break;
-				}
-				else {
-					roll -= lds->Entries[j].chance;
-				}
+		npc->AddLootDrop(db_item, itemlist, entry.item_charges, entry.minlevel,
+							entry.maxlevel, entry.equip_item > 0 ? true : false, false);
+
+		int charges = (int)entry.multiplier;
+		charges = EQ::ClampLower(charges, 1);
+
+		for(int k = 1; k < charges; ++k) {
+			float c_roll = (float)zone->random.Real(0.0, 100.0);
+			if(c_roll <= entry.chance) {
+				npc->AddLootDrop(db_item, itemlist, entry.item_charges, entry.minlevel,
+									entry.maxlevel, entry.equip_item > 0 ? true : false, false);
 			}
 		}
 	} // We either ran out of items or reached our limit.
@@ -229,6 +187,31 @@ void ZoneDatabase::AddLootDropToNPC(NPC* npc,uint32 lootdrop_id, ItemList* iteml
 	//	npc->SendAppearancePacket(AT_Light, npc->GetActiveLightValue());
 }
 
+// Builds (once per lootdrop) the cumulative chance table AddLootDropToNPC rolls against,
+// so each roll is a binary search instead of a walk over every entry and item lookup
+const LootDropRollTable &ZoneDatabase::GetLootDropRollTable(uint32 lootdrop_id, const LootDrop_Struct *lds) {
+	auto iter = loot_drop_roll_tables.find(lootdrop_id);
+	if(iter != loot_drop_roll_tables.end()) {
+		return iter->second;
+	}
+
+	LootDropRollTable &roll_table = loot_drop_roll_tables[lootdrop_id];
+	roll_table.total_chance = 0.0f;
+	for(uint32 i = 0; i < lds->NumEntries; ++i) {
+		const EQ::ItemData* db_item = GetItem(lds->Entries[i].item_id);
+		if(!db_item) {
+			continue;
+		}
+
+		roll_table.total_chance += lds->Entries[i].chance;
+		roll_table.entries.push_back(i);
+		roll_table.items.push_back(db_item);
+		roll_table.cumulative_chance.push_back(roll_table.total_chance);
+	}
+
+	return roll_table;
+}
+
 //if itemlist is null, just send wear changes
 void NPC::AddLootDrop(const EQ::ItemData *item2, ItemList* itemlist, int16 charges, uint8 minlevel, uint8 maxlevel, bool equipit, bool wearchange, uint32 aug1, uint32 aug2, uint32 aug3, uint32 aug4, uint32 aug5, uint32 aug6) {
 	if(item2 == nullptr)
@@ -0,0 +1,233 @@
+#ifdef LUA_EQEMU
+
+#include "lua.hpp"
+#include "lua_async.h"
+#include "lua_parser.h"
+#include "data_bucket.h"
+#include "zone_config.h"
+#include "../common/database.h"
+#include "../common/event/task.h"
+#include "../common/rulesys.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+extern const ZoneConfig *Config;
+
+namespace
+{
+	// pushes a call's results onto the resumed coroutine, built on the worker from what the query returned
+	typedef std::function<int(lua_State *L)> PushResults;
+	typedef std::function<PushResults(Database &db)> AsyncWork;
+
+	uint32 generation = 0;
+
+	// libuv runs work on a pool of threads; each one gets its own connection and MySQL thread
+	// state so queries on different workers run side by side, torn down when the thread exits
+	struct MySQLThread {
+		MySQLThread() { mysql_thread_init(); }
+		~MySQLThread() { mysql_thread_end(); }
+	};
+
+	struct WorkerDatabase {
+		MySQLThread thread; // declared first so it outlives the connection
+		Database    db;
+		bool        connected = false;
+	};
+
+	Database *AsyncDatabase()
+	{
+		static thread_local WorkerDatabase worker;
+
+		if (!worker.connected) {
+			worker.connected = worker.db.Connect(
+				Config->DatabaseHost.c_str(),
+				Config->DatabaseUsername.c_str(),
+				Config->DatabasePassword.c_str(),
+				Config->DatabaseDB.c_str(),
+				Config->DatabasePort
+			);
+		}
+
+		return worker.connected ? &worker.db : nullptr;
+	}
+
+	PushResults PushError(const std::string &error)
+	{
+		return [error](lua_State *L) {
+			lua_pushnil(L);
+			lua_pushstring(L, error.c_str());
+			return 2;
+		};
+	}
+
+	int Await(lua_State *L, AsyncWork work)
+	{
+		if (lua_pushthread(L)) {
+			lua_pop(L, 1);
+			return luaL_error(L, "eq.async_* functions must be called from inside a coroutine");
+		}
+
+		// keeps the coroutine alive while nothing else may be referencing it
+		int    ref    = luaL_ref(L, LUA_REGISTRYINDEX);
+		uint32 issued = generation;
+
+		EQ::Task([work](EQ::Task::ResolveFn resolve, EQ::Task::RejectFn reject) {
+			RuleManager::ReadScope rules;
+			Database *db = AsyncDatabase();
+			resolve(db ? work(*db) : PushError("no database connection"));
+		})
+		.Then([L, ref, issued](const EQ::Any &result) {
+			if (issued != generation) {
+				return;
+			}
+
+			auto push   = EQ::any_cast<PushResults>(result);
+			int  status = lua_resume(L, push(L));
+			if (status != 0 && status != LUA_YIELD) {
+				const char *error = lua_tostring(L, -1);
+				LuaParser::Instance()->AddError(error ? error : "error resuming coroutine");
+			}
+
+			if (status != LUA_YIELD) {
+				lua_settop(L, 0);
+			}
+
+			luaL_unref(L, LUA_REGISTRYINDEX, ref);
+		})
+		.Run();
+
+		return lua_yield(L, 0);
+	}
+
+	int AsyncGetData(lua_State *L)
+	{
+		std::string key = luaL_checkstring(L, 1);
+		return Await(L, [key](Database &db) -> PushResults {
+			std::string value = DataBucket::GetData(db, key);
+			return [value](lua_State *L) {
+				lua_pushstring(L, value.c_str());
+				return 1;
+			};
+		});
+	}
+
+	int AsyncGetDataExpires(lua_State *L)
+	{
+		std::string key = luaL_checkstring(L, 1);
+		return Await(L, [key](Database &db) -> PushResults {
+			std::string value = DataBucket::GetDataExpires(db, key);
+			return [value](lua_State *L) {
+				lua_pushstring(L, value.c_str());
+				return 1;
+			};
+		});
+	}
+
+	int AsyncSetData(lua_State *L)
+	{
+		std::string key     = luaL_checkstring(L, 1);
+		std::string value   = luaL_checkstring(L, 2);
+		std::string expires = luaL_optstring(L, 3, "");
+		return Await(L, [key, value, expires](Database &db) -> PushResults {
+			DataBucket::SetData(db, key, value, expires);
+			return [](lua_State *L) {
+				return 0;
+			};
+		});
+	}
+
+	int AsyncDeleteData(lua_State *L)
+	{
+		std::string key = luaL_checkstring(L, 1);
+		return Await(L, [key](Database &db) -> PushResults {
+			bool deleted = DataBucket::DeleteData(db, key);
+			return [deleted](lua_State *L) {
+				lua_pushboolean(L, deleted);
+				return 1;
+			};
+		});
+	}
+
+	// rows come back as an array of tables keyed by column name, NULL columns are left out;
+	// returns rows and affected row count or nil and the error
+	int AsyncQuery(lua_State *L)
+	{
+		std::string query = luaL_checkstring(L, 1);
+		return Await(L, [query](Database &db) -> PushResults {
+			auto results = db.QueryDatabase(query);
+			if (!results.Success()) {
+				return PushError(results.ErrorMessage());
+			}
+
+			std::vector<std::string> fields;
+			for (uint32 i = 0; i < results.ColumnCount(); ++i) {
+				fields.push_back(results.FieldName(i));
+			}
+
+			std::vector<std::vector<std::string>> values;
+			std::vector<std::vector<bool>> nulls;
+			for (auto row = results.begin(); row != results.end(); ++row) {
+				values.emplace_back(fields.size());
+				nulls.emplace_back(fields.size(), true);
+				for (size_t i = 0; i < fields.size(); ++i) {
+					if (row[i]) {
+						values.back()[i] = row[i];
+						nulls.back()[i]  = false;
+					}
+				}
+			}
+
+			uint32 affected = results.RowsAffected();
+			return [fields, values, nulls, affected](lua_State *L) {
+				lua_createtable(L, static_cast<int>(values.size()), 0);
+				for (size_t r = 0; r < values.size(); ++r) {
+					lua_createtable(L, 0, static_cast<int>(fields.size()));
+					for (size_t i = 0; i < fields.size(); ++i) {
+						if (!nulls[r][i]) {
+							lua_pushlstring(L, values[r][i].data(), values[r][i].length());
+							lua_setfield(L, -2, fields[i].c_str());
+						}
+					}
+					lua_rawseti(L, -2, static_cast<int>(r + 1));
+				}
+
+				lua_pushinteger(L, affected);
+				return 2;
+			};
+		});
+	}
+
+	const luaL_Reg async_functions[] = {
+		{ "async_get_data",         AsyncGetData },
+		{ "async_get_data_expires", AsyncGetDataExpires },
+		{ "async_set_data",         AsyncSetData },
+		{ "async_delete_data",      AsyncDeleteData },
+		{ "async_query",            AsyncQuery },
+		{ nullptr,                  nullptr }
+	};
+}
+
+int luaopen_async(lua_State *L)
+{
+	lua_getglobal(L, "eq");
+	if (!lua_istable(L, -1)) {
+		lua_pop(L, 1);
+		return 0;
+	}
+
+	for (auto fn = async_functions; fn->name; ++fn) {
+		lua_pushcfunction(L, fn->func);
+		lua_setfield(L, -2, fn->name);
+	}
+
+	return 1;
+}
+
+void lua_async_invalidate()
+{
+	++generation;
+}
+
+#endif
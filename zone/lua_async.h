@@ -0,0 +1,29 @@
+#ifndef EQEMU_LUA_ASYNC_H
+#define EQEMU_LUA_ASYNC_H
+#ifdef LUA_EQEMU
+
+struct lua_State;
+
+/*
+ * eq.async_* variants of the database backed quest calls. Each one yields the
+ * calling coroutine, runs its query on the task pool against a connection of its
+ * own and resumes the coroutine from the event loop with the result:
+ *
+ *   coroutine.wrap(function()
+ *     local value = eq.async_get_data("key")
+ *     local rows, err = eq.async_query("SELECT ...")
+ *   end)()
+ *
+ * They have to be called from a coroutine and not from inside pcall. Entities held
+ * across the call, e.self included, may be gone by the time it returns; look them
+ * up again by id.
+ */
+
+// adds the functions to the eq table, call after luabind has registered it
+int luaopen_async(lua_State *L);
+
+// forgets every pending call, their coroutines die with the lua_State being closed
+void lua_async_invalidate();
+
+#endif
+#endif
@@ -0,0 +1,274 @@
+#ifdef LUA_EQEMU
+
+#include "lua.hpp"
+#include "lua_bytecode_cache.h"
+#include "../common/file_util.h"
+#include "../common/timer.h"
+
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WINDOWS
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const char cache_magic[8] = { 'E', 'Q', 'L', 'U', 'A', 'B', 'C', '1' };
+
+#ifdef LUAJIT_VERSION
+	const char *cache_build = LUAJIT_VERSION;
+#else
+	const char *cache_build = LUA_VERSION;
+#endif
+
+	struct EntryHeader {
+		char   magic[8];
+		char   build[32];
+		uint8  pointer_size;
+		int64  mtime;
+		uint64 size;
+		uint64 hash;
+	};
+
+	uint64 HashBytes(const char *data, size_t len)
+	{
+		uint64 hash = 14695981039346656037ULL;
+		for (size_t i = 0; i < len; ++i) {
+			hash ^= static_cast<uint8>(data[i]);
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	void MakeHeader(EntryHeader &header, int64 mtime, uint64 size, uint64 hash)
+	{
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, cache_magic, sizeof(cache_magic));
+		strncpy(header.build, cache_build, sizeof(header.build) - 1);
+		header.pointer_size = sizeof(void *);
+		header.mtime        = mtime;
+		header.size         = size;
+		header.hash         = hash;
+	}
+
+	int DumpWriter(lua_State *L, const void *p, size_t sz, void *ud)
+	{
+		reinterpret_cast<std::string *>(ud)->append(reinterpret_cast<const char *>(p), sz);
+		return 0;
+	}
+
+	// reads an entry built by this Lua build, whatever source state it was compiled from
+	bool ReadEntry(const std::string &path, EntryHeader &header, std::string &bytecode)
+	{
+		std::ifstream entry(path, std::ios::binary);
+		if (!entry || !entry.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+			return false;
+		}
+
+		EntryHeader build;
+		MakeHeader(build, 0, 0, 0);
+		if (memcmp(header.magic, build.magic, sizeof(build.magic)) != 0 ||
+			memcmp(header.build, build.build, sizeof(build.build)) != 0 ||
+			header.pointer_size != build.pointer_size) {
+			return false;
+		}
+
+		bytecode.assign((std::istreambuf_iterator<char>(entry)), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	// written beside the final name and renamed so another zone never reads a partial entry
+	void WriteEntry(const std::string &path, const EntryHeader &header, const std::string &bytecode)
+	{
+		std::string temp_path = path + ".tmp" + std::to_string(getpid());
+		std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			return;
+		}
+
+		out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		out.write(bytecode.data(), bytecode.length());
+		out.close();
+		if (!out || rename(temp_path.c_str(), path.c_str()) != 0) {
+			remove(temp_path.c_str());
+		}
+	}
+
+	int CachedModuleLoader(lua_State *L)
+	{
+		auto cache = reinterpret_cast<LuaBytecodeCache *>(lua_touserdata(L, lua_upvalueindex(1)));
+		std::string module = luaL_checkstring(L, 1);
+		std::string name = module;
+		for (auto &c : name) {
+			if (c == '.') {
+				c = '/';
+			}
+		}
+
+		lua_getglobal(L, "package");
+		lua_getfield(L, -1, "path");
+		std::string path = lua_isstring(L, -1) ? lua_tostring(L, -1) : "";
+		lua_pop(L, 2);
+
+		std::stringstream templates(path);
+		std::string       entry;
+		while (std::getline(templates, entry, ';')) {
+			std::string filename;
+			for (auto c : entry) {
+				if (c == '?') {
+					filename += name;
+				}
+				else {
+					filename += c;
+				}
+			}
+
+			if (filename.empty() || !FileUtil::exists(filename)) {
+				continue;
+			}
+
+			if (cache->Load(L, filename)) {
+				return luaL_error(
+					L, "error loading module '%s' from file '%s':\n\t%s",
+					lua_tostring(L, 1), filename.c_str(), lua_tostring(L, -1));
+			}
+
+			cache->AddModuleFile(module, filename);
+			return 1;
+		}
+
+		// not found, let the stock searchers produce the usual message
+		return 0;
+	}
+}
+
+LuaBytecodeCache::LuaBytecodeCache()
+{
+	ResetStats();
+}
+
+void LuaBytecodeCache::SetDirectory(const std::string &directory)
+{
+	directory_ = directory;
+	if (!directory_.empty() && directory_.back() != '/') {
+		directory_ += '/';
+	}
+
+	if (!directory_.empty() && !FileUtil::exists(directory_)) {
+		FileUtil::mkdir(directory_);
+	}
+}
+
+void LuaBytecodeCache::ResetStats()
+{
+	memset(&stats_, 0, sizeof(stats_));
+}
+
+std::string LuaBytecodeCache::EntryPath(const std::string &filename) const
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.luac", static_cast<unsigned long long>(HashBytes(filename.c_str(), filename.length())));
+	return directory_ + name;
+}
+
+int LuaBytecodeCache::Load(lua_State *L, const std::string &filename)
+{
+	std::string chunk_name = "@" + filename;
+
+	struct stat st;
+	if (directory_.empty() || stat(filename.c_str(), &st) != 0) {
+		return luaL_loadfile(L, filename.c_str());
+	}
+
+	BenchTimer timer;
+	std::string entry_path = EntryPath(filename);
+
+	EntryHeader header;
+	std::string bytecode;
+	bool        usable = ReadEntry(entry_path, header, bytecode);
+
+	// unchanged mtime and size trust the entry without touching the source
+	if (usable && header.mtime == static_cast<int64>(st.st_mtime) && header.size == static_cast<uint64>(st.st_size)) {
+		if (luaL_loadbuffer(L, bytecode.data(), bytecode.length(), chunk_name.c_str()) == 0) {
+			stats_.hits++;
+			stats_.load_time += timer.elapsed();
+			return 0;
+		}
+
+		// unreadable entry, fall through and rebuild it
+		lua_pop(L, 1);
+		usable = false;
+	}
+
+	std::ifstream source_file(filename, std::ios::binary);
+	if (!source_file) {
+		return luaL_loadfile(L, filename.c_str());
+	}
+
+	std::string source((std::istreambuf_iterator<char>(source_file)), std::istreambuf_iterator<char>());
+	uint64 hash = HashBytes(source.data(), source.length());
+
+	EntryHeader expected;
+	MakeHeader(expected, static_cast<int64>(st.st_mtime), static_cast<uint64>(source.length()), hash);
+
+	// only the mtime moved (a checkout or copy), the hash says the content is what was compiled
+	if (usable && header.size == expected.size && header.hash == expected.hash) {
+		if (luaL_loadbuffer(L, bytecode.data(), bytecode.length(), chunk_name.c_str()) == 0) {
+			WriteEntry(entry_path, expected, bytecode);
+			stats_.hits++;
+			stats_.load_time += timer.elapsed();
+			return 0;
+		}
+
+		lua_pop(L, 1);
+	}
+
+	// luaL_loadfile skips a leading #! line, keep the newline so line numbers still match
+	if (!source.empty() && source[0] == '#') {
+		source.erase(0, source.find('\n') == std::string::npos ? source.length() : source.find('\n'));
+	}
+
+	stats_.misses++;
+	int status = luaL_loadbuffer(L, source.data(), source.length(), chunk_name.c_str());
+	if (status == 0) {
+		bytecode.clear();
+		if (lua_dump(L, DumpWriter, &bytecode) == 0) {
+			WriteEntry(entry_path, expected, bytecode);
+		}
+	}
+
+	stats_.compile_time += timer.elapsed();
+	return status;
+}
+
+void LuaBytecodeCache::InstallModuleLoader(lua_State *L)
+{
+	module_files_.clear();
+
+	lua_getglobal(L, "package");
+	lua_getfield(L, -1, "loaders");
+	if (!lua_istable(L, -1)) {
+		lua_pop(L, 2);
+		return;
+	}
+
+	// shift everything from index 2 up so ours runs right after the preload searcher
+	int count = static_cast<int>(lua_objlen(L, -1));
+	for (int i = count; i >= 2; --i) {
+		lua_rawgeti(L, -1, i);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	lua_pushlightuserdata(L, this);
+	lua_pushcclosure(L, CachedModuleLoader, 1);
+	lua_rawseti(L, -2, 2);
+	lua_pop(L, 2);
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef EQEMU_LUA_BYTECODE_CACHE_H
+#define EQEMU_LUA_BYTECODE_CACHE_H
+#ifdef LUA_EQEMU
+
+#include <map>
+#include <string>
+#include "../common/types.h"
+
+struct lua_State;
+
+/*
+ * Compiled chunks for quest scripts and lua_modules, stored on disk so every zone
+ * process after the first loads bytecode instead of parsing the source again.
+ * An entry is named after the script path and is used without reading the source
+ * while its mtime and size match; if only the mtime moved, the content hash decides.
+ */
+class LuaBytecodeCache
+{
+public:
+	struct Stats {
+		uint32 hits;
+		uint32 misses;
+		double load_time; // seconds spent loading cached bytecode
+		double compile_time; // seconds spent compiling source, including writing the cache entry
+	};
+
+	LuaBytecodeCache();
+
+	void SetDirectory(const std::string &directory);
+
+	// same contract as luaL_loadfile: pushes the chunk, or an error message and returns non-zero
+	int Load(lua_State *L, const std::string &filename);
+
+	// installs a package.loaders searcher in front of the stock Lua file searcher so
+	// require goes through the cache as well
+	void InstallModuleLoader(lua_State *L);
+
+	// module name to the file the module loader found it in, for the current lua_State
+	const std::map<std::string, std::string> &GetModuleFiles() const { return module_files_; }
+	void AddModuleFile(const std::string &name, const std::string &filename) { module_files_[name] = filename; }
+
+	const Stats &GetStats() const { return stats_; }
+	void ResetStats();
+
+private:
+	std::string EntryPath(const std::string &filename) const;
+
+	std::string directory_;
+	Stats stats_;
+	std::map<std::string, std::string> module_files_;
+};
+
+#endif
+#endif
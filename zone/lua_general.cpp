@@ -22,6 +22,7 @@
 #include "qglobals.h"
 #include "encounter.h"
 #include "lua_encounter.h"
+#include "lua_parallel_encounter.h"
 #include "data_bucket.h"
 
 struct Events { };
@@ -138,6 +139,18 @@ void unload_encounter_with_data(std::string name, std::string info_str) {
 	parse->EventEncounter(EVENT_ENCOUNTER_UNLOAD, name, "", 0, &info_ptrs);
 }
 
+bool load_parallel_encounter(std::string name) {
+	return LuaParallelEncounters::Instance()->Load(name);
+}
+
+void unload_parallel_encounter(std::string name) {
+	LuaParallelEncounters::Instance()->Unload(name);
+}
+
+void signal_parallel_encounter(std::string name, int signal) {
+	LuaParallelEncounters::Instance()->Signal(name, signal);
+}
+
 void register_event(std::string package_name, std::string name, int evt, luabind::adl::object func) {
 	if(lua_encounters_loaded.count(name) == 0)
 		return;
@@ -1690,6 +1703,9 @@ luabind::scope lua_register_general() {
 		luabind::def("unload_encounter", &unload_encounter),
 		luabind::def("load_encounter_with_data", &load_encounter_with_data),
 		luabind::def("unload_encounter_with_data", &unload_encounter_with_data),
+		luabind::def("load_parallel_encounter", &load_parallel_encounter),
+		luabind::def("unload_parallel_encounter", &unload_parallel_encounter),
+		luabind::def("signal_parallel_encounter", &signal_parallel_encounter),
 		luabind::def("register_npc_event", (void(*)(std::string, int, int, luabind::adl::object))&register_npc_event),
 		luabind::def("register_npc_event", (void(*)(int, int, luabind::adl::object))&register_npc_event),
 		luabind::def("unregister_npc_event", (void(*)(std::string, int, int))&unregister_npc_event),
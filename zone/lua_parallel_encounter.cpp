@@ -0,0 +1,656 @@
+#ifdef LUA_EQEMU
+
+#include "lua.hpp"
+#include "lua_parallel_encounter.h"
+#include "lua_parser.h"
+#include "../common/event/task_scheduler.h"
+#include "../common/features.h"
+#include "../common/file_util.h"
+#include "../common/rulesys.h"
+#include "entity.h"
+#include "npc.h"
+#include "questmgr.h"
+#include "zone.h"
+#include "zone_config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+
+extern const ZoneConfig *Config;
+extern Zone             *zone;
+extern EntityList       entity_list;
+extern QuestManager     quest_manager;
+
+namespace
+{
+	enum CommandType {
+		CommandSpawn,
+		CommandDepop,
+		CommandSignal,
+		CommandSay,
+		CommandMoveTo,
+		CommandAddHate
+	};
+
+	struct Command {
+		CommandType type;
+		uint16      id;
+		uint32      value;
+		uint32      grid;
+		uint16      target_id;
+		float       x;
+		float       y;
+		float       z;
+		float       heading;
+		std::string text;
+	};
+}
+
+struct LuaParallelEncounters::Encounter {
+	// a tick that overran its deadline may still be running, whoever drops the last reference closes the state
+	~Encounter()
+	{
+		if (L) {
+			lua_close(L);
+		}
+	}
+
+	std::string name;
+	lua_State *L;
+	// written by the zone thread between ticks, read and cleared by the worker
+	std::vector<int> signals;
+	std::vector<Command> commands;
+	std::shared_ptr<const std::vector<EntitySnapshot>> snapshot;
+	uint32 now;
+	std::string error;
+	bool failed;
+	bool unloading;
+	// instructions run by the current call, checked by the count hook against the limit
+	uint32 instructions;
+	uint32 instruction_limit;
+};
+
+namespace
+{
+	typedef LuaParallelEncounters::Encounter Encounter;
+	typedef LuaParallelEncounters::EntitySnapshot EntitySnapshot;
+
+	const int  InstructionHookInterval = 1000;
+	const char EncounterRegistryKey[]  = "parallel_encounter";
+
+	Encounter *Self(lua_State *L)
+	{
+		return reinterpret_cast<Encounter *>(lua_touserdata(L, lua_upvalueindex(1)));
+	}
+
+	void PushEntity(lua_State *L, const EntitySnapshot &e)
+	{
+		lua_createtable(L, 0, 12);
+		lua_pushinteger(L, e.id);
+		lua_setfield(L, -2, "id");
+		lua_pushinteger(L, e.npc_type_id);
+		lua_setfield(L, -2, "npc_type_id");
+		lua_pushstring(L, e.name.c_str());
+		lua_setfield(L, -2, "name");
+		lua_pushnumber(L, e.x);
+		lua_setfield(L, -2, "x");
+		lua_pushnumber(L, e.y);
+		lua_setfield(L, -2, "y");
+		lua_pushnumber(L, e.z);
+		lua_setfield(L, -2, "z");
+		lua_pushnumber(L, e.heading);
+		lua_setfield(L, -2, "heading");
+		lua_pushinteger(L, e.hp_ratio);
+		lua_setfield(L, -2, "hp");
+		lua_pushinteger(L, e.level);
+		lua_setfield(L, -2, "level");
+		lua_pushboolean(L, e.is_client);
+		lua_setfield(L, -2, "is_client");
+		lua_pushboolean(L, e.is_npc);
+		lua_setfield(L, -2, "is_npc");
+		lua_pushboolean(L, e.engaged);
+		lua_setfield(L, -2, "engaged");
+	}
+
+	// encounter.entities([npc_type_id]) every mob in the snapshot, optionally only one npc type
+	int Entities(lua_State *L)
+	{
+		auto   self        = Self(L);
+		uint32 npc_type_id = static_cast<uint32>(luaL_optinteger(L, 1, 0));
+
+		lua_newtable(L);
+		int i = 1;
+		for (auto &e : *self->snapshot) {
+			if (npc_type_id == 0 || e.npc_type_id == npc_type_id) {
+				PushEntity(L, e);
+				lua_rawseti(L, -2, i++);
+			}
+		}
+		return 1;
+	}
+
+	// encounter.entity(id) one mob or nil if it was not there when the snapshot was taken
+	int Entity(lua_State *L)
+	{
+		auto   self = Self(L);
+		uint16 id   = static_cast<uint16>(luaL_checkinteger(L, 1));
+		for (auto &e : *self->snapshot) {
+			if (e.id == id) {
+				PushEntity(L, e);
+				return 1;
+			}
+		}
+
+		lua_pushnil(L);
+		return 1;
+	}
+
+	// encounter.in_radius(x, y, z, radius) every mob within radius of a point
+	int InRadius(lua_State *L)
+	{
+		auto  self   = Self(L);
+		float x      = static_cast<float>(luaL_checknumber(L, 1));
+		float y      = static_cast<float>(luaL_checknumber(L, 2));
+		float z      = static_cast<float>(luaL_checknumber(L, 3));
+		float radius = static_cast<float>(luaL_checknumber(L, 4));
+		float r2     = radius * radius;
+
+		lua_newtable(L);
+		int i = 1;
+		for (auto &e : *self->snapshot) {
+			float dx = e.x - x;
+			float dy = e.y - y;
+			float dz = e.z - z;
+			if (dx * dx + dy * dy + dz * dz <= r2) {
+				PushEntity(L, e);
+				lua_rawseti(L, -2, i++);
+			}
+		}
+		return 1;
+	}
+
+	int Now(lua_State *L)
+	{
+		lua_pushinteger(L, Self(L)->now);
+		return 1;
+	}
+
+	void Queue(lua_State *L, CommandType type, uint16 id, uint32 value, const char *text = nullptr)
+	{
+		Command command = { type, id, value, 0, 0, 0.0f, 0.0f, 0.0f, 0.0f, text ? text : "" };
+		Self(L)->commands.push_back(command);
+	}
+
+	// encounter.spawn(npc_type_id, x, y, z, heading[, grid])
+	int Spawn(lua_State *L)
+	{
+		Command command;
+		command.type      = CommandSpawn;
+		command.id        = 0;
+		command.value     = static_cast<uint32>(luaL_checkinteger(L, 1));
+		command.grid      = static_cast<uint32>(luaL_optinteger(L, 6, 0));
+		command.target_id = 0;
+		command.x         = static_cast<float>(luaL_checknumber(L, 2));
+		command.y         = static_cast<float>(luaL_checknumber(L, 3));
+		command.z         = static_cast<float>(luaL_checknumber(L, 4));
+		command.heading   = static_cast<float>(luaL_optnumber(L, 5, 0.0));
+		Self(L)->commands.push_back(command);
+		return 0;
+	}
+
+	int Depop(lua_State *L)
+	{
+		Queue(L, CommandDepop, static_cast<uint16>(luaL_checkinteger(L, 1)), 0);
+		return 0;
+	}
+
+	// encounter.signal(id, signal)
+	int Signal(lua_State *L)
+	{
+		Queue(L, CommandSignal, static_cast<uint16>(luaL_checkinteger(L, 1)), static_cast<uint32>(luaL_checkinteger(L, 2)));
+		return 0;
+	}
+
+	// encounter.say(id, message)
+	int Say(lua_State *L)
+	{
+		Queue(L, CommandSay, static_cast<uint16>(luaL_checkinteger(L, 1)), 0, luaL_checkstring(L, 2));
+		return 0;
+	}
+
+	// encounter.move_to(id, x, y, z, heading)
+	int MoveTo(lua_State *L)
+	{
+		Command command;
+		command.type      = CommandMoveTo;
+		command.id        = static_cast<uint16>(luaL_checkinteger(L, 1));
+		command.value     = 0;
+		command.grid      = 0;
+		command.target_id = 0;
+		command.x         = static_cast<float>(luaL_checknumber(L, 2));
+		command.y         = static_cast<float>(luaL_checknumber(L, 3));
+		command.z         = static_cast<float>(luaL_checknumber(L, 4));
+		command.heading   = static_cast<float>(luaL_optnumber(L, 5, 0.0));
+		Self(L)->commands.push_back(command);
+		return 0;
+	}
+
+	// encounter.add_hate(npc_id, target_id, amount)
+	int AddHate(lua_State *L)
+	{
+		Command command;
+		command.type      = CommandAddHate;
+		command.id        = static_cast<uint16>(luaL_checkinteger(L, 1));
+		command.value     = static_cast<uint32>(luaL_optinteger(L, 3, 1));
+		command.grid      = 0;
+		command.target_id = static_cast<uint16>(luaL_checkinteger(L, 2));
+		command.x         = 0.0f;
+		command.y         = 0.0f;
+		command.z         = 0.0f;
+		command.heading   = 0.0f;
+		Self(L)->commands.push_back(command);
+		return 0;
+	}
+
+	const luaL_Reg encounter_functions[] = {
+		{ "entities",  Entities },
+		{ "entity",    Entity },
+		{ "in_radius", InRadius },
+		{ "now",       Now },
+		{ "spawn",     Spawn },
+		{ "depop",     Depop },
+		{ "signal",    Signal },
+		{ "say",       Say },
+		{ "move_to",   MoveTo },
+		{ "add_hate",  AddHate },
+		{ nullptr,     nullptr }
+	};
+
+	// a tick runs while the zone thread waits on it, so a script stuck in a loop is stopped with an error
+	void InstructionHook(lua_State *L, lua_Debug *ar)
+	{
+		lua_getfield(L, LUA_REGISTRYINDEX, EncounterRegistryKey);
+		auto encounter = reinterpret_cast<Encounter *>(lua_touserdata(L, -1));
+		lua_pop(L, 1);
+
+		encounter->instructions += InstructionHookInterval;
+		if (encounter->instructions > encounter->instruction_limit) {
+			luaL_error(L, "ran more than %u instructions", encounter->instruction_limit);
+		}
+	}
+
+	void OpenSandbox(lua_State *L, Encounter *encounter)
+	{
+#ifdef LUAJIT_VERSION
+		// compiled traces never call the count hook, so the sandbox always runs interpreted
+		luaJIT_setmode(L, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_OFF);
+#endif
+
+		const luaL_Reg libs[] = {
+			{ "",              luaopen_base },
+			{ LUA_TABLIBNAME,  luaopen_table },
+			{ LUA_STRLIBNAME,  luaopen_string },
+			{ LUA_MATHLIBNAME, luaopen_math },
+			{ nullptr,         nullptr }
+		};
+
+		for (auto lib = libs; lib->func; ++lib) {
+			lua_pushcfunction(L, lib->func);
+			lua_pushstring(L, lib->name);
+			lua_call(L, 1, 0);
+		}
+
+		// nothing outside the script itself gets loaded
+		const char *removed[] = { "dofile", "loadfile", "load", "loadstring", "require", "module" };
+		for (auto name : removed) {
+			lua_pushnil(L);
+			lua_setglobal(L, name);
+		}
+
+		lua_pushlightuserdata(L, encounter);
+		lua_setfield(L, LUA_REGISTRYINDEX, EncounterRegistryKey);
+		lua_sethook(L, InstructionHook, LUA_MASKCOUNT, InstructionHookInterval);
+
+		lua_newtable(L);
+		for (auto fn = encounter_functions; fn->name; ++fn) {
+			lua_pushlightuserdata(L, encounter);
+			lua_pushcclosure(L, fn->func, 1);
+			lua_setfield(L, -2, fn->name);
+		}
+		lua_setglobal(L, "encounter");
+	}
+
+	// calls a global function of the encounter if the script defines it, false on error
+	bool CallHook(Encounter &encounter, const char *hook, int arg, bool has_arg)
+	{
+		lua_State *L = encounter.L;
+		encounter.instructions = 0;
+		lua_getglobal(L, hook);
+		if (!lua_isfunction(L, -1)) {
+			lua_pop(L, 1);
+			return true;
+		}
+
+		if (has_arg) {
+			lua_pushinteger(L, arg);
+		}
+
+		if (lua_pcall(L, has_arg ? 1 : 0, 0, 0)) {
+			const char *error = lua_tostring(L, -1);
+			encounter.error  = "Parallel encounter [" + encounter.name + "] " + hook + ": " + (error ? error : "unknown error");
+			encounter.failed = true;
+			lua_pop(L, 1);
+			return false;
+		}
+
+		return true;
+	}
+
+	void RunTick(Encounter &encounter)
+	{
+		RuleManager::ReadScope rules;
+
+		std::vector<int> signals;
+		signals.swap(encounter.signals);
+		for (auto signal : signals) {
+			if (!CallHook(encounter, "on_signal", signal, true)) {
+				return;
+			}
+		}
+
+		CallHook(encounter, "tick", encounter.now, true);
+	}
+
+	std::string FindScript(const std::string &name)
+	{
+		std::string file = "/encounters/" + name + ".parallel.lua";
+		if (zone) {
+			std::string path = Config->QuestDir + zone->GetShortName() + file;
+			if (FileUtil::exists(path)) {
+				return path;
+			}
+		}
+
+		std::string path = Config->QuestDir + QUEST_GLOBAL_DIRECTORY + file;
+		return FileUtil::exists(path) ? path : std::string();
+	}
+}
+
+LuaParallelEncounters::LuaParallelEncounters() : m_tick_timer(0), m_processing(false)
+{
+	m_tick_timer.Disable();
+}
+
+LuaParallelEncounters::~LuaParallelEncounters()
+{
+	Clear();
+}
+
+bool LuaParallelEncounters::Load(const std::string &name)
+{
+	if (m_encounters.count(name)) {
+		return true;
+	}
+
+	// its on_load asked for it again, the state it would replace is still running
+	if (m_loading.count(name)) {
+		LuaParser::Instance()->AddError("Parallel encounter [" + name + "] loaded again while it was still loading");
+		return false;
+	}
+
+	std::string path = FindScript(name);
+	if (path.empty()) {
+		LuaParser::Instance()->AddError("Parallel encounter [" + name + "] has no encounters/" + name + ".parallel.lua");
+		return false;
+	}
+
+	std::shared_ptr<Encounter> encounter(new Encounter);
+	encounter->name              = name;
+	encounter->L                 = luaL_newstate();
+	encounter->now               = Timer::GetCurrentTime();
+	encounter->failed            = false;
+	encounter->unloading         = false;
+	encounter->instructions      = 0;
+	encounter->instruction_limit = static_cast<uint32>(std::max(InstructionHookInterval, RuleI(Quest, ParallelEncounterInstructionLimit)));
+	OpenSandbox(encounter->L, encounter.get());
+
+	// the chunk and on_load can already look at the zone
+	TakeSnapshot();
+	encounter->snapshot = m_snapshot;
+
+	if (luaL_loadfile(encounter->L, path.c_str()) || lua_pcall(encounter->L, 0, 0, 0)) {
+		const char *error = lua_tostring(encounter->L, -1);
+		LuaParser::Instance()->AddError("Parallel encounter [" + name + "]: " + (error ? error : "failed to load"));
+		return false;
+	}
+
+	if (!m_scheduler) {
+		m_scheduler.reset(new EQ::Event::TaskScheduler(std::max(1, RuleI(Quest, ParallelEncounterThreads))));
+	}
+
+	if (!m_tick_timer.Enabled()) {
+		m_tick_timer.Start(std::max(1, RuleI(Quest, ParallelEncounterTickMS)));
+	}
+
+	// on_load can queue commands too
+	m_loading.insert(name);
+	CallHook(*encounter, "on_load", 0, false);
+	Apply(*encounter);
+	m_loading.erase(name);
+
+	m_encounters[name] = encounter;
+	return true;
+}
+
+void LuaParallelEncounters::Unload(const std::string &name)
+{
+	auto iter = m_encounters.find(name);
+	if (iter == m_encounters.end()) {
+		return;
+	}
+
+	if (m_processing) {
+		iter->second->unloading = true;
+		return;
+	}
+
+	auto &encounter = *iter->second;
+	if (!encounter.failed) {
+		TakeSnapshot();
+		encounter.snapshot = m_snapshot;
+		CallHook(encounter, "on_unload", 0, false);
+		Apply(encounter);
+	}
+
+	m_encounters.erase(iter);
+
+	if (m_encounters.empty()) {
+		m_tick_timer.Disable();
+	}
+}
+
+bool LuaParallelEncounters::IsLoaded(const std::string &name) const
+{
+	return m_encounters.count(name) > 0;
+}
+
+void LuaParallelEncounters::Signal(const std::string &name, int signal)
+{
+	// a failed encounter never ticks again, so nothing would drain its signals
+	auto iter = m_encounters.find(name);
+	if (iter != m_encounters.end() && !iter->second->failed) {
+		iter->second->signals.push_back(signal);
+	}
+}
+
+void LuaParallelEncounters::Clear()
+{
+	// a quest event run while applying commands reloaded quests, Process closes them once it is done
+	if (m_processing) {
+		for (auto &e : m_encounters) {
+			e.second->failed    = true;
+			e.second->unloading = true;
+		}
+		return;
+	}
+
+	m_encounters.clear();
+	m_snapshot.reset();
+	m_tick_timer.Disable();
+}
+
+void LuaParallelEncounters::TakeSnapshot()
+{
+	// ticks that overran keep the snapshot they were given, so every snapshot is a new one
+	std::shared_ptr<std::vector<EntitySnapshot>> snapshot(new std::vector<EntitySnapshot>);
+
+	auto &mobs = entity_list.GetMobList();
+	snapshot->reserve(mobs.size());
+	for (auto &m : mobs) {
+		Mob *mob = m.second;
+		if (!mob->IsClient() && !mob->IsNPC()) {
+			continue;
+		}
+
+		EntitySnapshot e;
+		e.id          = mob->GetID();
+		e.npc_type_id = mob->IsNPC() ? mob->GetNPCTypeID() : 0;
+		e.name        = mob->GetCleanName();
+		e.x           = mob->GetX();
+		e.y           = mob->GetY();
+		e.z           = mob->GetZ();
+		e.heading     = mob->GetHeading();
+		e.hp_ratio    = mob->GetIntHPRatio();
+		e.level       = mob->GetLevel();
+		e.is_client   = mob->IsClient();
+		e.is_npc      = mob->IsNPC();
+		e.engaged     = mob->IsEngaged();
+		snapshot->push_back(e);
+	}
+
+	m_snapshot = snapshot;
+}
+
+void LuaParallelEncounters::Process()
+{
+	if (m_encounters.empty() || !m_tick_timer.Check()) {
+		return;
+	}
+
+	TakeSnapshot();
+
+	uint32 now = Timer::GetCurrentTime();
+	std::vector<std::pair<std::string, std::future<void>>> ticks;
+	for (auto &e : m_encounters) {
+		std::shared_ptr<Encounter> encounter = e.second;
+		if (encounter->failed) {
+			encounter->signals.clear();
+			continue;
+		}
+
+		encounter->now      = now;
+		encounter->snapshot = m_snapshot;
+		ticks.push_back(std::make_pair(e.first, m_scheduler->Enqueue([encounter]() { RunTick(*encounter); })));
+	}
+
+	// the zone waits on these, an encounter that overruns is dropped and its worker left to finish alone
+	auto deadline = std::chrono::steady_clock::now() +
+		std::chrono::milliseconds(std::max(1, RuleI(Quest, ParallelEncounterTickTimeoutMS)));
+	for (auto &tick : ticks) {
+		if (tick.second.wait_until(deadline) == std::future_status::ready) {
+			continue;
+		}
+
+		LuaParser::Instance()->AddError(
+			"Parallel encounter [" + tick.first + "] tick ran past " +
+			std::to_string(RuleI(Quest, ParallelEncounterTickTimeoutMS)) + " ms and was abandoned"
+		);
+		m_encounters.erase(tick.first);
+	}
+
+	if (m_encounters.empty()) {
+		m_tick_timer.Disable();
+		return;
+	}
+
+	// applying commands runs quest events, which may unload encounters
+	m_processing = true;
+	for (auto &e : m_encounters) {
+		Apply(*e.second);
+	}
+	m_processing = false;
+
+	std::vector<std::string> unloading;
+	for (auto &e : m_encounters) {
+		if (e.second->unloading) {
+			unloading.push_back(e.first);
+		}
+	}
+
+	for (auto &name : unloading) {
+		Unload(name);
+	}
+}
+
+void LuaParallelEncounters::Apply(Encounter &encounter)
+{
+	if (!encounter.error.empty()) {
+		LuaParser::Instance()->AddError(encounter.error);
+		encounter.error.clear();
+	}
+
+	std::vector<Command> commands;
+	commands.swap(encounter.commands);
+
+	for (auto &command : commands) {
+		switch (command.type) {
+			case CommandSpawn:
+				quest_manager.spawn2(
+					command.value,
+					command.grid,
+					0,
+					glm::vec4(command.x, command.y, command.z, command.heading)
+				);
+				break;
+			case CommandDepop: {
+				NPC *npc = entity_list.GetNPCByID(command.id);
+				if (npc) {
+					npc->Depop();
+				}
+				break;
+			}
+			case CommandSignal: {
+				NPC *npc = entity_list.GetNPCByID(command.id);
+				if (npc) {
+					npc->SignalNPC(command.value);
+				}
+				break;
+			}
+			case CommandSay: {
+				Mob *mob = entity_list.GetMob(command.id);
+				if (mob) {
+					mob->Say("%s", command.text.c_str());
+				}
+				break;
+			}
+			case CommandMoveTo: {
+				NPC *npc = entity_list.GetNPCByID(command.id);
+				if (npc) {
+					npc->MoveTo(glm::vec4(command.x, command.y, command.z, command.heading), true);
+				}
+				break;
+			}
+			case CommandAddHate: {
+				NPC *npc    = entity_list.GetNPCByID(command.id);
+				Mob *target = entity_list.GetMob(command.target_id);
+				if (npc && target) {
+					npc->AddToHateList(target, command.value);
+				}
+				break;
+			}
+		}
+	}
+}
+
+#endif
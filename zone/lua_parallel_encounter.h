@@ -0,0 +1,90 @@
+#ifndef EQEMU_LUA_PARALLEL_ENCOUNTER_H
+#define EQEMU_LUA_PARALLEL_ENCOUNTER_H
+#ifdef LUA_EQEMU
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "../common/timer.h"
+#include "../common/types.h"
+
+struct lua_State;
+
+namespace EQ
+{
+	namespace Event
+	{
+		class TaskScheduler;
+	}
+}
+
+/*
+ * Encounters that run in Lua states of their own on worker threads. Once per
+ * Quest:ParallelEncounterTickMS the zone takes a snapshot of its mobs, every
+ * loaded encounter's tick() runs against that snapshot in parallel, and the
+ * commands they queued (spawn, depop, signal, say, move_to, add_hate) are applied
+ * on the zone thread once all of them are done. An encounter whose tick is not
+ * done within Quest:ParallelEncounterTickTimeoutMS is dropped.
+ *
+ * Scripts live at encounters/<name>.parallel.lua in the zone or global quest
+ * directory, only get the base, string, table and math libraries and reach the
+ * zone through the encounter table; they never touch a live entity.
+ */
+class LuaParallelEncounters
+{
+public:
+	~LuaParallelEncounters();
+
+	static LuaParallelEncounters *Instance()
+	{
+		static LuaParallelEncounters inst;
+		return &inst;
+	}
+
+	bool Load(const std::string &name);
+	void Unload(const std::string &name);
+	bool IsLoaded(const std::string &name) const;
+	// delivered to the encounter's on_signal before its next tick
+	void Signal(const std::string &name, int signal);
+	void Clear();
+
+	void Process();
+
+	struct EntitySnapshot {
+		uint16 id;
+		uint32 npc_type_id;
+		std::string name;
+		float x;
+		float y;
+		float z;
+		float heading;
+		int hp_ratio;
+		uint8 level;
+		bool is_client;
+		bool is_npc;
+		bool engaged;
+	};
+
+	struct Encounter;
+
+private:
+	LuaParallelEncounters();
+	LuaParallelEncounters(const LuaParallelEncounters &);
+	LuaParallelEncounters &operator=(const LuaParallelEncounters &);
+
+	void TakeSnapshot();
+	void Apply(Encounter &encounter);
+
+	std::map<std::string, std::shared_ptr<Encounter>> m_encounters;
+	// names whose on_load is running, they are not in m_encounters yet
+	std::set<std::string> m_loading;
+	std::shared_ptr<std::vector<EntitySnapshot>> m_snapshot;
+	std::unique_ptr<EQ::Event::TaskScheduler> m_scheduler;
+	Timer m_tick_timer;
+	bool m_processing;
+};
+
+#endif
+#endif
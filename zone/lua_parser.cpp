@@ -17,6 +17,8 @@
 #include "zone_config.h"
 
 #include "lua_parser.h"
+#include "quest_file_watcher.h"
+#include "lua_async.h"
 #include "lua_bit.h"
 #include "lua_entity.h"
 #include "lua_item.h"
@@ -37,8 +39,14 @@
 #include "lua_packet.h"
 #include "lua_general.h"
 #include "lua_encounter.h"
+#include "lua_parallel_encounter.h"
 #include "lua_stat_bonuses.h"
 
+//preallocated hash slots for event tables so filling in the arguments rarely has to rehash
+#define EVENT_TABLE_SIZE_HINT 8
+//most wrapped self objects cached before the cache is flushed
+#define SELF_CACHE_MAX 4096
+
 const char *LuaEvents[_LargestEventID] = {
 	"event_say",
 	"event_trade",
@@ -240,6 +248,8 @@ LuaParser::~LuaParser() {
 	lua_encounters.clear();
 	lua_encounter_events_registered.clear();
 	lua_encounters_loaded.clear();
+	lua_async_invalidate();
+	LuaParallelEncounters::Instance()->Clear();
 	if(L) {
 		lua_close(L);
 	}
@@ -284,25 +294,18 @@ int LuaParser::EventGlobalNPC(QuestEventID evt, NPC* npc, Mob *init, std::string
 
 int LuaParser::_EventNPC(std::string package_name, QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						 std::vector<EQ::Any> *extra_pointers, luabind::adl::object *l_func) {
-	const char *sub_name = LuaEvents[evt];
-
 	int start = lua_gettop(L);
 
 	try {
-		int npop = 1;
 		if(l_func != nullptr) {
 			l_func->push(L);
 		} else {
-			lua_getfield(L, LUA_REGISTRYINDEX, package_name.c_str());
-			lua_getfield(L, -1, sub_name);
-			npop = 2;
+			PushHandler(package_name, evt);
 		}
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, EVENT_TABLE_SIZE_HINT);
 		//always push self
-		Lua_NPC l_npc(npc);
-		luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-		l_npc_o.push(L);
+		PushSelf(npc);
 		lua_setfield(L, -2, "self");
 
 		auto arg_function = NPCArgumentDispatch[evt];
@@ -320,11 +323,11 @@ int LuaParser::_EventNPC(std::string package_name, QuestEventID evt, NPC* npc, M
 
 		if(lua_isnumber(L, -1)) {
 			int ret = static_cast<int>(lua_tointeger(L, -1));
-			lua_pop(L, npop);
+			lua_pop(L, 1);
 			return ret;
 		}
 
-		lua_pop(L, npop);
+		lua_pop(L, 1);
 	} catch(std::exception &ex) {
 		std::string error = "Lua Exception: ";
 		error += std::string(ex.what());
@@ -379,24 +382,18 @@ int LuaParser::EventGlobalPlayer(QuestEventID evt, Client *client, std::string d
 
 int LuaParser::_EventPlayer(std::string package_name, QuestEventID evt, Client *client, std::string data, uint32 extra_data,
 							std::vector<EQ::Any> *extra_pointers, luabind::adl::object *l_func) {
-	const char *sub_name = LuaEvents[evt];
 	int start = lua_gettop(L);
 
 	try {
-		int npop = 1;
 		if(l_func != nullptr) {
 			l_func->push(L);
 		} else {
-			lua_getfield(L, LUA_REGISTRYINDEX, package_name.c_str());
-			lua_getfield(L, -1, sub_name);
-			npop = 2;
+			PushHandler(package_name, evt);
 		}
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, EVENT_TABLE_SIZE_HINT);
 		//push self
-		Lua_Client l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		PushSelf(client);
 		lua_setfield(L, -2, "self");
 
 		auto arg_function = PlayerArgumentDispatch[evt];
@@ -413,11 +410,11 @@ int LuaParser::_EventPlayer(std::string package_name, QuestEventID evt, Client *
 
 		if(lua_isnumber(L, -1)) {
 			int ret = static_cast<int>(lua_tointeger(L, -1));
-			lua_pop(L, npop);
+			lua_pop(L, 1);
 			return ret;
 		}
 
-		lua_pop(L, npop);
+		lua_pop(L, 1);
 	} catch(std::exception &ex) {
 		std::string error = "Lua Exception: ";
 		error += std::string(ex.what());
@@ -456,29 +453,23 @@ int LuaParser::EventItem(QuestEventID evt, Client *client, EQ::ItemInstance *ite
 
 int LuaParser::_EventItem(std::string package_name, QuestEventID evt, Client *client, EQ::ItemInstance *item, Mob *mob,
 						  std::string data, uint32 extra_data, std::vector<EQ::Any> *extra_pointers, luabind::adl::object *l_func) {
-	const char *sub_name = LuaEvents[evt];
-
 	int start = lua_gettop(L);
 
 	try {
-		int npop = 1;
 		if(l_func != nullptr) {
 			l_func->push(L);
 		} else {
-			lua_getfield(L, LUA_REGISTRYINDEX, package_name.c_str());
-			lua_getfield(L, -1, sub_name);
+			PushHandler(package_name, evt);
 		}
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, EVENT_TABLE_SIZE_HINT);
 		//always push self
 		Lua_ItemInst l_item(item);
 		luabind::adl::object l_item_o = luabind::adl::object(L, l_item);
 		l_item_o.push(L);
 		lua_setfield(L, -2, "self");
 
-		Lua_Client l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		PushSelf(client);
 		lua_setfield(L, -2, "owner");
 
 		//redo this arg function
@@ -496,11 +487,11 @@ int LuaParser::_EventItem(std::string package_name, QuestEventID evt, Client *cl
 
 		if(lua_isnumber(L, -1)) {
 			int ret = static_cast<int>(lua_tointeger(L, -1));
-			lua_pop(L, npop);
+			lua_pop(L, 1);
 			return ret;
 		}
 
-		lua_pop(L, npop);
+		lua_pop(L, 1);
 	} catch(std::exception &ex) {
 		std::string error = "Lua Exception: ";
 		error += std::string(ex.what());
@@ -535,21 +526,16 @@ int LuaParser::EventSpell(QuestEventID evt, NPC* npc, Client *client, uint32 spe
 
 int LuaParser::_EventSpell(std::string package_name, QuestEventID evt, NPC* npc, Client *client, uint32 spell_id, uint32 extra_data,
 						   std::vector<EQ::Any> *extra_pointers, luabind::adl::object *l_func) {
-	const char *sub_name = LuaEvents[evt];
-
 	int start = lua_gettop(L);
 
 	try {
-		int npop = 1;
 		if(l_func != nullptr) {
 			l_func->push(L);
 		} else {
-			lua_getfield(L, LUA_REGISTRYINDEX, package_name.c_str());
-			lua_getfield(L, -1, sub_name);
-			npop = 2;
+			PushHandler(package_name, evt);
 		}
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, EVENT_TABLE_SIZE_HINT);
 
 		//always push self even if invalid
 		if(IsValidSpell(spell_id)) {
@@ -577,11 +563,11 @@ int LuaParser::_EventSpell(std::string package_name, QuestEventID evt, NPC* npc,
 
 		if(lua_isnumber(L, -1)) {
 			int ret = static_cast<int>(lua_tointeger(L, -1));
-			lua_pop(L, npop);
+			lua_pop(L, 1);
 			return ret;
 		}
 
-		lua_pop(L, npop);
+		lua_pop(L, 1);
 	} catch(std::exception &ex) {
 		std::string error = "Lua Exception: ";
 		error += std::string(ex.what());
@@ -615,15 +601,12 @@ int LuaParser::EventEncounter(QuestEventID evt, std::string encounter_name, std:
 
 int LuaParser::_EventEncounter(std::string package_name, QuestEventID evt, std::string encounter_name, std::string data, uint32 extra_data,
 							   std::vector<EQ::Any> *extra_pointers) {
-	const char *sub_name = LuaEvents[evt];
-
 	int start = lua_gettop(L);
 
 	try {
-		lua_getfield(L, LUA_REGISTRYINDEX, package_name.c_str());
-		lua_getfield(L, -1, sub_name);
+		PushHandler(package_name, evt);
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, EVENT_TABLE_SIZE_HINT);
 		lua_pushstring(L, encounter_name.c_str());
 		lua_setfield(L, -2, "name");
 
@@ -643,11 +626,11 @@ int LuaParser::_EventEncounter(std::string package_name, QuestEventID evt, std::
 
 		if(lua_isnumber(L, -1)) {
 			int ret = static_cast<int>(lua_tointeger(L, -1));
-			lua_pop(L, 2);
+			lua_pop(L, 1);
 			return ret;
 		}
 
-		lua_pop(L, 2);
+		lua_pop(L, 1);
 	} catch(std::exception &ex) {
 		std::string error = "Lua Exception: ";
 		error += std::string(ex.what());
@@ -672,8 +655,7 @@ bool LuaParser::HasQuestSub(uint32 npc_id, QuestEventID evt) {
 
 	std::string package_name = "npc_" + std::to_string(npc_id);
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, package_name);
+	return HasHandler(package_name, evt);
 }
 
 bool LuaParser::HasGlobalQuestSub(QuestEventID evt) {
@@ -682,8 +664,7 @@ bool LuaParser::HasGlobalQuestSub(QuestEventID evt) {
 		return false;
 	}
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, "global_npc");
+	return HasHandler("global_npc", evt);
 }
 
 bool LuaParser::PlayerHasQuestSub(QuestEventID evt) {
@@ -692,8 +673,7 @@ bool LuaParser::PlayerHasQuestSub(QuestEventID evt) {
 		return false;
 	}
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, "player");
+	return HasHandler("player", evt);
 }
 
 bool LuaParser::GlobalPlayerHasQuestSub(QuestEventID evt) {
@@ -702,8 +682,7 @@ bool LuaParser::GlobalPlayerHasQuestSub(QuestEventID evt) {
 		return false;
 	}
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, "global_player");
+	return HasHandler("global_player", evt);
 }
 
 bool LuaParser::SpellHasQuestSub(uint32 spell_id, QuestEventID evt) {
@@ -714,8 +693,7 @@ bool LuaParser::SpellHasQuestSub(uint32 spell_id, QuestEventID evt) {
 
 	std::string package_name = "spell_" + std::to_string(spell_id);
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, package_name);
+	return HasHandler(package_name, evt);
 }
 
 bool LuaParser::ItemHasQuestSub(EQ::ItemInstance *itm, QuestEventID evt) {
@@ -730,8 +708,7 @@ bool LuaParser::ItemHasQuestSub(EQ::ItemInstance *itm, QuestEventID evt) {
 	std::string package_name = "item_";
 	package_name += std::to_string(itm->GetID());
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, package_name);
+	return HasHandler(package_name, evt);
 }
 
 bool LuaParser::EncounterHasQuestSub(std::string encounter_name, QuestEventID evt) {
@@ -742,8 +719,7 @@ bool LuaParser::EncounterHasQuestSub(std::string encounter_name, QuestEventID ev
 
 	std::string package_name = "encounter_" + encounter_name;
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, package_name);
+	return HasHandler(package_name, evt);
 }
 
 void LuaParser::LoadNPCScript(std::string filename, int npc_id) {
@@ -806,6 +782,15 @@ void LuaParser::ReloadQuests() {
 	loaded_.clear();
 	errors_.clear();
 	mods_.clear();
+	handlers_.clear();
+	ClearSelfCache();
+	//covers scripts loaded since the last report, which the zone makes after its first spawn pass
+	ReportBytecodeCache();
+	bytecode_cache_.SetDirectory(Config->LuaBytecodeDir);
+	package_files_.clear();
+	module_requirers_.clear();
+	loading_package_.clear();
+	require_stack_.clear();
 	lua_encounter_events_registered.clear();
 	lua_encounters_loaded.clear();
 
@@ -818,6 +803,10 @@ void LuaParser::ReloadQuests() {
 	// And there is situations where it wouldn't be :P
 	entity_list.EncounterProcess();
 
+	// parallel encounters run their own copies of scripts that may have just changed on disk
+	LuaParallelEncounters::Instance()->Clear();
+
+	lua_async_invalidate();
 	if(L) {
 		lua_close(L);
 	}
@@ -909,7 +898,15 @@ void LuaParser::ReloadQuests() {
 	lua_setfield(L, -2, "cpath");
 	lua_pop(L, 1);
 
+	bytecode_cache_.InstallModuleLoader(L);
+
+	lua_getglobal(L, "require");
+	lua_pushlightuserdata(L, this);
+	lua_pushcclosure(L, TrackedRequire, 2);
+	lua_setglobal(L, "require");
+
 	MapFunctions(L);
+	luaopen_async(L);
 
 	//load init
 	std::string path = Config->QuestDir;
@@ -921,7 +918,7 @@ void LuaParser::ReloadQuests() {
 	if(f) {
 		fclose(f);
 
-		if(luaL_dofile(L, path.c_str())) {
+		if(!RunScript(path)) {
 			std::string error = lua_tostring(L, -1);
 			AddError(error);
 		}
@@ -939,7 +936,7 @@ void LuaParser::ReloadQuests() {
 		if(f) {
 			fclose(f);
 
-			if(luaL_dofile(L, zone_script.c_str())) {
+			if(!RunScript(zone_script)) {
 				std::string error = lua_tostring(L, -1);
 				AddError(error);
 			}
@@ -953,7 +950,7 @@ void LuaParser::ReloadQuests() {
 			if (f) {
 				fclose(f);
 
-				if (luaL_dofile(L, zone_script.c_str())) {
+				if (!RunScript(zone_script)) {
 					std::string error = lua_tostring(L, -1);
 					AddError(error);
 				}
@@ -974,6 +971,8 @@ void LuaParser::ReloadQuests() {
 			}
 
 			LoadScript("mods/" + std::string(file_name), file_name);
+			//mods are wired into combat code as they load, so anything they require needs a full reload
+			package_files_.erase(file_name);
 			mods_.push_back(LuaMod(L, this, file_name));
 		}
 
@@ -994,7 +993,7 @@ void LuaParser::LoadScript(std::string filename, std::string package_name) {
 	}
 
 	auto top = lua_gettop(L);
-	if(luaL_loadfile(L, filename.c_str())) {
+	if(bytecode_cache_.Load(L, filename)) {
 		std::string error = lua_tostring(L, -1);
 		AddError(error);
 		lua_pop(L, 1);
@@ -1004,10 +1003,25 @@ void LuaParser::LoadScript(std::string filename, std::string package_name) {
 	//This makes an env table named: package_name
 	//And makes it so we can see the global table _G from it
 	//Then sets it so this script is called from that table as an env
+	//Event handlers are kept out of the env in a table between it and _G, so every assignment
+	//to one goes through __newindex and the cached ref follows it
+
+	ReleaseHandlers(package_name);
+	handlers_[package_name].assign(_LargestEventID, LUA_NOREF);
 
 	lua_createtable(L, 0, 0); // anon table
+	lua_createtable(L, 0, 0); // handler table
 	lua_getglobal(L, "_G"); // get _G
-	lua_setfield(L, -2, "__index"); //anon table.__index = _G
+	lua_setfield(L, -2, "__index"); //handler table.__index = _G
+	lua_pushvalue(L, -1);
+	lua_setmetatable(L, -2); //setmetatable(handler_table, handler_table)
+
+	lua_pushlightuserdata(L, this);
+	lua_pushvalue(L, -2);
+	lua_pushstring(L, package_name.c_str());
+	lua_pushcclosure(L, SetPackageGlobal, 3);
+	lua_setfield(L, -3, "__newindex"); //anon table.__newindex = SetPackageGlobal
+	lua_setfield(L, -2, "__index"); //anon table.__index = handler table
 
 	lua_pushvalue(L, -1); //copy table to top of stack
 	lua_setmetatable(L, -2); //setmetatable(anon_table, copied table)
@@ -1017,7 +1031,13 @@ void LuaParser::LoadScript(std::string filename, std::string package_name) {
 
 	lua_setfenv(L, -2); //set the env to the table we made
 
-	if(lua_pcall(L, 0, 0, 0)) {
+	package_files_[package_name] = filename;
+	std::string previous_package = loading_package_;
+	loading_package_ = package_name;
+	int status = lua_pcall(L, 0, 0, 0);
+	loading_package_ = previous_package;
+
+	if(status) {
 		std::string error = lua_tostring(L, -1);
 		AddError(error);
 		lua_pop(L, 1);
@@ -1033,6 +1053,251 @@ void LuaParser::LoadScript(std::string filename, std::string package_name) {
 	}
 }
 
+bool LuaParser::UnloadScript(std::string filename) {
+	if(!L) {
+		return false;
+	}
+
+	for(auto iter = package_files_.begin(); iter != package_files_.end();) {
+		if(iter->second != filename) {
+			++iter;
+			continue;
+		}
+
+		const std::string &package_name = iter->first;
+		ReleaseHandlers(package_name);
+
+		lua_pushnil(L);
+		lua_setfield(L, LUA_REGISTRYINDEX, package_name.c_str());
+		loaded_.erase(package_name);
+
+		for(auto &requirers : module_requirers_) {
+			requirers.second.erase(package_name);
+		}
+
+		iter = package_files_.erase(iter);
+	}
+
+	return true;
+}
+
+QuestFileScope LuaParser::InvalidateFile(std::string filename, std::vector<std::string> &dependents) {
+	std::string path = QuestFileWatcher::NormalizePath(filename);
+
+	std::vector<std::string> modules;
+	for(auto &module : bytecode_cache_.GetModuleFiles()) {
+		if(QuestFileWatcher::NormalizePath(module.second) == path) {
+			modules.push_back(module.first);
+		}
+	}
+
+	if(modules.empty() || !L) {
+		return QuestFileUnknown;
+	}
+
+	//a module that required the changed one holds on to the old copy, so it reloads too
+	bool global = false;
+	std::set<std::string> visited(modules.begin(), modules.end());
+	lua_getglobal(L, "package");
+	lua_getfield(L, -1, "loaded");
+	while(!modules.empty()) {
+		std::string module = modules.back();
+		modules.pop_back();
+
+		lua_pushnil(L);
+		lua_setfield(L, -2, module.c_str());
+
+		auto requirers = module_requirers_.find(module);
+		if(requirers == module_requirers_.end()) {
+			continue;
+		}
+
+		for(auto &requirer : requirers->second) {
+			if(requirer.compare(0, 7, "module:") == 0) {
+				std::string name = requirer.substr(7);
+				if(visited.insert(name).second) {
+					modules.push_back(name);
+				}
+				continue;
+			}
+
+			auto package = package_files_.find(requirer);
+			if(package == package_files_.end()) {
+				global = true;
+			}
+			else if(std::find(dependents.begin(), dependents.end(), package->second) == dependents.end()) {
+				dependents.push_back(package->second);
+			}
+		}
+	}
+	lua_pop(L, 2);
+
+	return global ? QuestFileGlobal : QuestFileDependency;
+}
+
+//records who asked for a module before handing off to the stock require
+int LuaParser::TrackedRequire(lua_State *L) {
+	auto parser = reinterpret_cast<LuaParser*>(lua_touserdata(L, lua_upvalueindex(2)));
+	std::string module = luaL_checkstring(L, 1);
+
+	std::string requirer = parser->require_stack_.empty() ? parser->loading_package_ : "module:" + parser->require_stack_.back();
+	parser->module_requirers_[module].insert(requirer);
+
+	parser->require_stack_.push_back(module);
+	lua_pushvalue(L, lua_upvalueindex(1));
+	lua_insert(L, 1);
+	int status = lua_pcall(L, lua_gettop(L) - 1, LUA_MULTRET, 0);
+	parser->require_stack_.pop_back();
+
+	if(status) {
+		return lua_error(L);
+	}
+	return lua_gettop(L);
+}
+
+// loads through the bytecode cache and runs in the global env, leaves an error on the stack on failure
+bool LuaParser::RunScript(const std::string &filename) {
+	return bytecode_cache_.Load(L, filename) == 0 && lua_pcall(L, 0, LUA_MULTRET, 0) == 0;
+}
+
+void LuaParser::ReportBytecodeCache() {
+	auto stats = bytecode_cache_.GetStats();
+	bytecode_cache_.ResetStats();
+	if (stats.hits == 0 && stats.misses == 0) {
+		return;
+	}
+
+	LogInfo(
+		"Lua scripts loaded: [{}] from bytecode cache in [{:.3f}] ms, [{}] compiled from source in [{:.3f}] ms",
+		stats.hits,
+		stats.load_time * 1000.0,
+		stats.misses,
+		stats.compile_time * 1000.0
+	);
+}
+
+void LuaParser::ReleaseHandlers(const std::string &package_name) {
+	auto iter = handlers_.find(package_name);
+	if(iter == handlers_.end()) {
+		return;
+	}
+
+	for(auto ref : iter->second) {
+		luaL_unref(L, LUA_REGISTRYINDEX, ref);
+	}
+	handlers_.erase(iter);
+}
+
+//__newindex of a package env, upvalues are the parser, the package's handler table and its name
+int LuaParser::SetPackageGlobal(lua_State *L) {
+	static std::unordered_map<std::string, int> event_ids;
+	if(event_ids.empty()) {
+		for(int i = 0; i < _LargestEventID; ++i) {
+			event_ids[LuaEvents[i]] = i;
+		}
+	}
+
+	auto evt = lua_type(L, 2) == LUA_TSTRING ? event_ids.find(lua_tostring(L, 2)) : event_ids.end();
+	if(evt == event_ids.end()) {
+		lua_rawset(L, 1);
+		return 0;
+	}
+
+	lua_pushvalue(L, 2);
+	lua_pushvalue(L, 3);
+	lua_rawset(L, lua_upvalueindex(2));
+
+	//an env left over from before the package was reloaded must not touch the new one's refs
+	lua_getfield(L, LUA_REGISTRYINDEX, lua_tostring(L, lua_upvalueindex(3)));
+	bool current = lua_rawequal(L, -1, 1) != 0;
+	lua_pop(L, 1);
+
+	auto parser = reinterpret_cast<LuaParser*>(lua_touserdata(L, lua_upvalueindex(1)));
+	auto handlers = parser->handlers_.find(lua_tostring(L, lua_upvalueindex(3)));
+	if(!current || handlers == parser->handlers_.end()) {
+		return 0;
+	}
+
+	//the registry is shared by every thread, so refs made from a coroutine are fine
+	int &ref = handlers->second[evt->second];
+	luaL_unref(L, LUA_REGISTRYINDEX, ref);
+	ref = LUA_NOREF;
+	if(lua_isfunction(L, 3)) {
+		lua_pushvalue(L, 3);
+		ref = luaL_ref(L, LUA_REGISTRYINDEX);
+	}
+
+	return 0;
+}
+
+bool LuaParser::HasHandler(const std::string &package_name, QuestEventID evt) {
+	auto iter = handlers_.find(package_name);
+	return iter != handlers_.end() && iter->second[evt] != LUA_NOREF;
+}
+
+void LuaParser::PushHandler(const std::string &package_name, QuestEventID evt) {
+	auto iter = handlers_.find(package_name);
+	if(iter == handlers_.end()) {
+		lua_pushnil(L);
+		return;
+	}
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, iter->second[evt]);
+}
+
+void LuaParser::PushSelf(NPC *npc) {
+	auto iter = npc_self_refs_.find(npc);
+	if(iter != npc_self_refs_.end()) {
+		lua_rawgeti(L, LUA_REGISTRYINDEX, iter->second);
+		return;
+	}
+
+	//wrappers only hold the pointer so an entry left behind by a freed entity is still correct
+	//if the address comes back as the same type; the cap just keeps stale entries in check
+	if(npc_self_refs_.size() + client_self_refs_.size() >= SELF_CACHE_MAX) {
+		ClearSelfCache();
+	}
+
+	Lua_NPC l_npc(npc);
+	luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
+	l_npc_o.push(L);
+	lua_pushvalue(L, -1);
+	npc_self_refs_[npc] = luaL_ref(L, LUA_REGISTRYINDEX);
+}
+
+void LuaParser::PushSelf(Client *client) {
+	auto iter = client_self_refs_.find(client);
+	if(iter != client_self_refs_.end()) {
+		lua_rawgeti(L, LUA_REGISTRYINDEX, iter->second);
+		return;
+	}
+
+	if(npc_self_refs_.size() + client_self_refs_.size() >= SELF_CACHE_MAX) {
+		ClearSelfCache();
+	}
+
+	Lua_Client l_client(client);
+	luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
+	l_client_o.push(L);
+	lua_pushvalue(L, -1);
+	client_self_refs_[client] = luaL_ref(L, LUA_REGISTRYINDEX);
+}
+
+void LuaParser::ClearSelfCache() {
+	if(L) {
+		for(auto &e : npc_self_refs_) {
+			luaL_unref(L, LUA_REGISTRYINDEX, e.second);
+		}
+
+		for(auto &e : client_self_refs_) {
+			luaL_unref(L, LUA_REGISTRYINDEX, e.second);
+		}
+	}
+
+	npc_self_refs_.clear();
+	client_self_refs_.clear();
+}
+
 bool LuaParser::HasFunction(std::string subname, std::string package_name) {
 	//std::transform(subname.begin(), subname.end(), subname.begin(), ::tolower);
 
@@ -7,10 +7,13 @@
 #include <string>
 #include <list>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <exception>
 
 #include "zone_config.h"
 #include "lua_mod.h"
+#include "lua_bytecode_cache.h"
 
 extern const ZoneConfig *Config;
 
@@ -66,6 +69,8 @@ public:
 	virtual void LoadItemScript(std::string filename, EQ::ItemInstance *item);
 	virtual void LoadSpellScript(std::string filename, uint32 spell_id);
 	virtual void LoadEncounterScript(std::string filename, std::string encounter_name);
+	virtual bool UnloadScript(std::string filename);
+	virtual QuestFileScope InvalidateFile(std::string filename, std::vector<std::string> &dependents);
 
 	virtual void AddVar(std::string name, std::string val);
 	virtual std::string GetVar(std::string name);
@@ -88,6 +93,8 @@ public:
 	}
 
 	bool HasFunction(std::string function, std::string package_name);
+	//logs and resets the bytecode cache counters
+	void ReportBytecodeCache();
 
 	//Mod Extensions
 	void MeleeMitigation(Mob *self, Mob *attacker, DamageHitInfo &hit, ExtraAttackOptions *opts, bool &ignoreDefault);
@@ -117,13 +124,38 @@ private:
 		std::vector<EQ::Any> *extra_pointers);
 
 	void LoadScript(std::string filename, std::string package_name);
+	bool RunScript(const std::string &filename);
 	void MapFunctions(lua_State *L);
 	QuestEventID ConvertLuaEvent(QuestEventID evt);
 
+	void ReleaseHandlers(const std::string &package_name);
+	bool HasHandler(const std::string &package_name, QuestEventID evt);
+	void PushHandler(const std::string &package_name, QuestEventID evt);
+	void PushSelf(NPC *npc);
+	void PushSelf(Client *client);
+	void ClearSelfCache();
+	static int TrackedRequire(lua_State *L);
+	static int SetPackageGlobal(lua_State *L);
+
 	std::map<std::string, std::string> vars_;
 	std::map<std::string, bool> loaded_;
 	std::vector<LuaMod> mods_;
 	lua_State *L;
+	LuaBytecodeCache bytecode_cache_;
+
+	//registry refs to each package's event handlers, kept current by the package env's __newindex so a
+	//handler defined, replaced or cleared at any time is seen without looking it up per event
+	std::unordered_map<std::string, std::vector<int>> handlers_;
+	//registry refs to the self wrappers handed to scripts, keyed by the wrapped pointer
+	std::unordered_map<NPC*, int> npc_self_refs_;
+	std::unordered_map<Client*, int> client_self_refs_;
+
+	//file each quest package was loaded from and the packages ("module:name" for modules) that required each
+	//module, an empty requirer is script_init or a require made outside of loading a script
+	std::map<std::string, std::string> package_files_;
+	std::map<std::string, std::set<std::string>> module_requirers_;
+	std::string loading_package_;
+	std::vector<std::string> require_stack_;
 
 	NPCArgumentHandler NPCArgumentDispatch[_LargestEventID];
 	PlayerArgumentHandler PlayerArgumentDispatch[_LargestEventID];
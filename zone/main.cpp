@@ -486,6 +486,11 @@ int main(int argc, char** argv) {
 			opts.daybreak_options.resend_delay_min = RuleI(Network, ResendDelayMinMS);
 			opts.daybreak_options.resend_delay_max = RuleI(Network, ResendDelayMaxMS);
 			opts.daybreak_options.outgoing_data_rate = RuleR(Network, ClientDataRate);
+			opts.daybreak_options.compression_level = RuleI(Network, CompressionLevel);
+			opts.daybreak_options.compression_min_size = RuleI(Network, CompressionMinSize);
+			opts.daybreak_options.congestion_control = RuleB(Network, CongestionControl);
+			opts.daybreak_options.congestion_window_max = RuleI(Network, CongestionWindowMax);
+			opts.capture_directory = Config->PacketCaptureDir;
 			eqsm.reset(new EQ::Net::EQStreamManager(opts));
 			eqsf_open = true;
 
@@ -493,6 +498,17 @@ int main(int argc, char** argv) {
 				stream_identifier.AddStream(stream);
 				LogF(Logs::Detail, Logs::WorldServer, "New connection from IP {0}:{1}", stream->GetRemoteIP(), ntohs(stream->GetRemotePort()));
 			});
+
+			//identify streams from their first packet rather than polling every pending stream each loop
+			eqsm->OnPacketRecv([&stream_identifier](std::shared_ptr<EQ::Net::EQStream> stream) {
+				stream_identifier.PacketReceived(stream.get());
+			});
+
+			eqsm->OnConnectionStateChange([&stream_identifier](std::shared_ptr<EQ::Net::EQStream> stream, EQ::Net::DbProtocolStatus from, EQ::Net::DbProtocolStatus to) {
+				if (to == EQ::Net::StatusDisconnecting || to == EQ::Net::StatusDisconnected) {
+					stream_identifier.StreamClosed(stream.get());
+				}
+			});
 		}
 
 		//give the stream identifier a chance to do its work....
@@ -5141,6 +5141,9 @@ int8 Mob::GetDecayEffectValue(uint16 spell_id, uint16 spelleffect) {
 
 // Faction Mods for Alliance type spells
 void Mob::AddFactionBonus(uint32 pFactionID,int32 bonus) {
+	if (IsClient())
+		CastToClient()->InvalidateFactionLevelCache();
+
 	std::map <uint32, int32> :: const_iterator faction_bonus;
 	typedef std::pair <uint32, int32> NewFactionBonus;
 
@@ -5161,6 +5164,9 @@ void Mob::AddFactionBonus(uint32 pFactionID,int32 bonus) {
 
 // Faction Mods from items
 void Mob::AddItemFactionBonus(uint32 pFactionID,int32 bonus) {
+	if (IsClient())
+		CastToClient()->InvalidateFactionLevelCache();
+
 	std::map <uint32, int32> :: const_iterator faction_bonus;
 	typedef std::pair <uint32, int32> NewFactionBonus;
 
@@ -5201,6 +5207,8 @@ int32 Mob::GetItemFactionBonus(uint32 pFactionID) {
 
 void Mob::ClearItemFactionBonuses() {
 	item_faction_bonuses.clear();
+	if (IsClient())
+		CastToClient()->InvalidateFactionLevelCache();
 }
 
 FACTION_VALUE Mob::GetSpecialFactionCon(Mob* iOther) {
@@ -0,0 +1,153 @@
+#include "proximity_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// boxes spanning more cells than this are tested on every lookup instead
+	const int64 MaxCellsPerBox = 256;
+	// keeps cell coordinates well inside an int
+	const float MaxCoordinate  = 1.0e7f;
+}
+
+ProximityGrid::ProximityGrid(float cell_size)
+	: m_cell_size(cell_size > 0.0f ? cell_size : 100.0f)
+{
+}
+
+bool ProximityGrid::CellOf(float v, int &cell) const
+{
+	if (!(std::fabs(v) <= MaxCoordinate)) {
+		return false;
+	}
+
+	cell = static_cast<int>(std::floor(v / m_cell_size));
+	return true;
+}
+
+uint64 ProximityGrid::CellKey(int x, int y)
+{
+	return (static_cast<uint64>(static_cast<uint32>(x)) << 32) | static_cast<uint32>(y);
+}
+
+void ProximityGrid::Set(int id, float min_x, float max_x, float min_y, float max_y, float min_z, float max_z)
+{
+	Remove(id);
+
+	Box box;
+	box.min_x      = min_x;
+	box.max_x      = max_x;
+	box.min_y      = min_y;
+	box.max_y      = max_y;
+	box.min_z      = min_z;
+	box.max_z      = max_z;
+	box.min_cell_x = box.max_cell_x = box.min_cell_y = box.max_cell_y = 0;
+	box.oversized  = false;
+	box.empty      = !(min_x <= max_x && min_y <= max_y && min_z <= max_z);
+
+	if (!box.empty) {
+		box.oversized = !CellOf(min_x, box.min_cell_x) || !CellOf(max_x, box.max_cell_x) ||
+						!CellOf(min_y, box.min_cell_y) || !CellOf(max_y, box.max_cell_y) ||
+						static_cast<int64>(box.max_cell_x - box.min_cell_x + 1) *
+						(box.max_cell_y - box.min_cell_y + 1) > MaxCellsPerBox;
+	}
+
+	m_boxes[id] = box;
+
+	if (box.empty) {
+		return;
+	}
+
+	if (box.oversized) {
+		m_oversized.push_back(id);
+		return;
+	}
+
+	for (int x = box.min_cell_x; x <= box.max_cell_x; ++x) {
+		for (int y = box.min_cell_y; y <= box.max_cell_y; ++y) {
+			m_cells[CellKey(x, y)].push_back(id);
+		}
+	}
+}
+
+void ProximityGrid::Unlink(int id, const Box &box)
+{
+	if (box.empty) {
+		return;
+	}
+
+	if (box.oversized) {
+		m_oversized.erase(std::remove(m_oversized.begin(), m_oversized.end(), id), m_oversized.end());
+		return;
+	}
+
+	for (int x = box.min_cell_x; x <= box.max_cell_x; ++x) {
+		for (int y = box.min_cell_y; y <= box.max_cell_y; ++y) {
+			auto cell = m_cells.find(CellKey(x, y));
+			if (cell == m_cells.end()) {
+				continue;
+			}
+
+			auto &ids = cell->second;
+			auto iter = std::find(ids.begin(), ids.end(), id);
+			if (iter != ids.end()) {
+				*iter = ids.back();
+				ids.pop_back();
+			}
+
+			if (ids.empty()) {
+				m_cells.erase(cell);
+			}
+		}
+	}
+}
+
+bool ProximityGrid::Remove(int id)
+{
+	auto iter = m_boxes.find(id);
+	if (iter == m_boxes.end()) {
+		return false;
+	}
+
+	Unlink(id, iter->second);
+	m_boxes.erase(iter);
+	return true;
+}
+
+void ProximityGrid::Clear()
+{
+	m_boxes.clear();
+	m_cells.clear();
+	m_oversized.clear();
+}
+
+void ProximityGrid::Query(float x, float y, float z, std::vector<int> &out) const
+{
+	if (m_boxes.empty()) {
+		return;
+	}
+
+	for (int id : m_oversized) {
+		if (m_boxes.at(id).Contains(x, y, z)) {
+			out.push_back(id);
+		}
+	}
+
+	int cell_x;
+	int cell_y;
+	if (!CellOf(x, cell_x) || !CellOf(y, cell_y)) {
+		return;
+	}
+
+	auto cell = m_cells.find(CellKey(cell_x, cell_y));
+	if (cell == m_cells.end()) {
+		return;
+	}
+
+	for (int id : cell->second) {
+		if (m_boxes.at(id).Contains(x, y, z)) {
+			out.push_back(id);
+		}
+	}
+}
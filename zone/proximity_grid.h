@@ -0,0 +1,61 @@
+#ifndef PROXIMITY_GRID_H
+#define PROXIMITY_GRID_H
+
+#include <unordered_map>
+#include <vector>
+#include "../common/types.h"
+
+/*
+ * Axis aligned boxes bucketed into a uniform grid over x/y so a point lookup
+ * only tests the boxes sharing its cell. Boxes that would cover too many
+ * cells are kept aside and tested on every lookup. Containment is inclusive
+ * on every edge and a box with a min above its max never contains anything,
+ * matching the checks this replaces.
+ */
+class ProximityGrid {
+public:
+	explicit ProximityGrid(float cell_size = 100.0f);
+
+	// adds the box or moves it if the id is already present
+	void Set(int id, float min_x, float max_x, float min_y, float max_y, float min_z, float max_z);
+	bool Remove(int id);
+	void Clear();
+
+	bool Empty() const { return m_boxes.empty(); }
+	std::size_t Size() const { return m_boxes.size(); }
+
+	// appends the ids of every box containing the point, out is not cleared
+	void Query(float x, float y, float z, std::vector<int> &out) const;
+
+private:
+	struct Box {
+		float min_x;
+		float max_x;
+		float min_y;
+		float max_y;
+		float min_z;
+		float max_z;
+		int min_cell_x;
+		int max_cell_x;
+		int min_cell_y;
+		int max_cell_y;
+		bool oversized;
+		bool empty;
+
+		bool Contains(float x, float y, float z) const
+		{
+			return !(x < min_x || x > max_x || y < min_y || y > max_y || z < min_z || z > max_z);
+		}
+	};
+
+	bool CellOf(float v, int &cell) const;
+	static uint64 CellKey(int x, int y);
+	void Unlink(int id, const Box &box);
+
+	float m_cell_size;
+	std::unordered_map<int, Box> m_boxes;
+	std::unordered_map<uint64, std::vector<int>> m_cells;
+	std::vector<int> m_oversized;
+};
+
+#endif
@@ -0,0 +1,195 @@
+#include "quest_file_watcher.h"
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+QuestFileWatcher::QuestFileWatcher() : m_fd(-1)
+{
+}
+
+QuestFileWatcher::~QuestFileWatcher()
+{
+	Clear();
+}
+
+std::string QuestFileWatcher::NormalizePath(const std::string &path)
+{
+	std::string out;
+	out.reserve(path.length());
+
+	size_t i = 0;
+	while (i < path.length()) {
+		char c = path[i] == '\\' ? '/' : path[i];
+		bool segment_start = out.empty() || out.back() == '/';
+
+		if (c == '/' && !out.empty() && out.back() == '/') {
+			++i;
+			continue;
+		}
+
+		if (segment_start && c == '.' && (i + 1 == path.length() || path[i + 1] == '/' || path[i + 1] == '\\')) {
+			i += 2;
+			continue;
+		}
+
+		out += c;
+		++i;
+	}
+
+	return out;
+}
+
+#ifdef __linux__
+
+bool QuestFileWatcher::Watch(const std::string &directory)
+{
+	if (m_fd == -1) {
+		m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_fd == -1) {
+			return false;
+		}
+	}
+
+	auto watches = m_watches.size();
+	AddWatch(NormalizePath(directory));
+	return m_watches.size() > watches;
+}
+
+void QuestFileWatcher::AddWatch(const std::string &directory)
+{
+	std::string dir = directory;
+	while (dir.length() > 1 && dir.back() == '/') {
+		dir.pop_back();
+	}
+
+	int wd = inotify_add_watch(
+		m_fd,
+		dir.c_str(),
+		IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE | IN_ONLYDIR
+	);
+	if (wd == -1) {
+		return;
+	}
+
+	m_watches[wd] = dir;
+
+	DIR *d = opendir(dir.c_str());
+	if (!d) {
+		return;
+	}
+
+	struct dirent *entry;
+	while ((entry = readdir(d)) != nullptr) {
+		if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+			continue;
+		}
+
+		std::string child = dir + "/" + entry->d_name;
+		bool is_dir = entry->d_type == DT_DIR;
+		if (entry->d_type == DT_UNKNOWN) {
+			struct stat st;
+			is_dir = stat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+		}
+
+		if (is_dir) {
+			AddWatch(child);
+		}
+	}
+
+	closedir(d);
+}
+
+void QuestFileWatcher::Clear()
+{
+	if (m_fd != -1) {
+		close(m_fd);
+		m_fd = -1;
+	}
+
+	m_watches.clear();
+}
+
+void QuestFileWatcher::Poll(std::vector<std::string> &changed, bool &overflowed)
+{
+	overflowed = false;
+	if (m_fd == -1) {
+		return;
+	}
+
+	alignas(struct inotify_event) char buffer[4096];
+	for (;;) {
+		ssize_t len = read(m_fd, buffer, sizeof(buffer));
+		if (len <= 0) {
+			break;
+		}
+
+		for (char *p = buffer; p < buffer + len;) {
+			auto event = reinterpret_cast<struct inotify_event *>(p);
+			p += sizeof(struct inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW) {
+				overflowed = true;
+				continue;
+			}
+
+			if (event->mask & IN_IGNORED) {
+				m_watches.erase(event->wd);
+				continue;
+			}
+
+			auto iter = m_watches.find(event->wd);
+			if (iter == m_watches.end() || event->len == 0) {
+				continue;
+			}
+
+			std::string path = iter->second + "/" + event->name;
+			if (event->mask & IN_ISDIR) {
+				if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+					AddWatch(path);
+				}
+				continue;
+			}
+
+			// a new file is reported again once it has been written and closed
+			if (event->mask & IN_CREATE) {
+				continue;
+			}
+
+			path = NormalizePath(path);
+			if (std::find(changed.begin(), changed.end(), path) == changed.end()) {
+				changed.push_back(path);
+			}
+		}
+	}
+}
+
+#else
+
+bool QuestFileWatcher::Watch(const std::string &directory)
+{
+	return false;
+}
+
+void QuestFileWatcher::AddWatch(const std::string &directory)
+{
+}
+
+void QuestFileWatcher::Clear()
+{
+	m_watches.clear();
+}
+
+void QuestFileWatcher::Poll(std::vector<std::string> &changed, bool &overflowed)
+{
+	overflowed = false;
+}
+
+#endif
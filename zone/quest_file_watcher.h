@@ -0,0 +1,37 @@
+#ifndef QUEST_FILE_WATCHER_H
+#define QUEST_FILE_WATCHER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+ * Reports files written, moved or deleted under a set of directory trees so
+ * quest hot reload can pick up just what changed. Backed by inotify and polled
+ * without blocking; on other platforms Watch fails and nothing is reported.
+ */
+class QuestFileWatcher {
+public:
+	QuestFileWatcher();
+	~QuestFileWatcher();
+
+	// watches the directory and everything below it, directories created later are picked up as well
+	bool Watch(const std::string &directory);
+	void Clear();
+	bool IsWatching() const { return !m_watches.empty(); }
+
+	// appends every changed path since the last poll; overflowed is set when the
+	// kernel dropped events and the caller can no longer tell what changed
+	void Poll(std::vector<std::string> &changed, bool &overflowed);
+
+	// strips ./ segments and duplicate separators so paths built by different code compare equal
+	static std::string NormalizePath(const std::string &path);
+
+private:
+	void AddWatch(const std::string &directory);
+
+	int m_fd;
+	std::map<int, std::string> m_watches;
+};
+
+#endif
@@ -26,6 +26,12 @@
 class Client;
 class NPC;
 
+enum QuestFileScope {
+	QuestFileUnknown,    // not something this interface loaded
+	QuestFileDependency, // shared code pulled in by the listed scripts
+	QuestFileGlobal      // loaded into every script's environment
+};
+
 namespace EQ
 {
 	class ItemInstance;
@@ -64,6 +70,11 @@ public:
 	virtual void LoadSpellScript(std::string filename, uint32 spell_id) { }
 	virtual void LoadEncounterScript(std::string filename, std::string encounter_name) { }
 
+	//drops everything loaded from filename so the next Load*Script compiles it again, false if only a full reload will do
+	virtual bool UnloadScript(std::string filename) { return false; }
+	//forgets any cached copy of a shared file and reports the script files that have to reload with it
+	virtual QuestFileScope InvalidateFile(std::string filename, std::vector<std::string> &dependents) { return QuestFileUnknown; }
+
 	virtual int DispatchEventNPC(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 		std::vector<EQ::Any> *extra_pointers) { return 0; }
 	virtual int DispatchEventPlayer(QuestEventID evt, Client *client, std::string data, uint32 extra_data,
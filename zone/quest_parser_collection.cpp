@@ -27,6 +27,7 @@
 #include "questmgr.h"
 #include "zone_config.h"
 
+#include <algorithm>
 #include <stdio.h>
 
 extern Zone* zone;
@@ -36,6 +37,7 @@ QuestParserCollection::QuestParserCollection() {
 	_player_quest_status = QuestUnloaded;
 	_global_player_quest_status = QuestUnloaded;
 	_global_npc_quest_status = QuestUnloaded;
+	ClearEventMasks();
 }
 
 QuestParserCollection::~QuestParserCollection() {
@@ -82,6 +84,8 @@ void QuestParserCollection::ReloadQuests(bool reset_timers) {
 	_spell_quest_status.clear();
 	_item_quest_status.clear();
 	_encounter_quest_status.clear();
+	_script_files.clear();
+	ClearEventMasks();
 	auto iter = _load_precedence.begin();
 	while(iter != _load_precedence.end()) {
 		(*iter)->ReloadQuests();
@@ -89,122 +93,474 @@ void QuestParserCollection::ReloadQuests(bool reset_timers) {
 	}
 }
 
-bool QuestParserCollection::HasQuestSub(uint32 npcid, QuestEventID evt) {
-	return HasQuestSubLocal(npcid, evt) || HasQuestSubGlobal(evt);
+void QuestParserCollection::WatchQuestFiles() {
+	_file_watcher.Clear();
+	if(!zone) {
+		return;
+	}
+
+	std::vector<std::string> directories = {
+		Config->QuestDir + zone->GetShortName(),
+		Config->QuestDir + QUEST_GLOBAL_DIRECTORY,
+		Config->PluginDir,
+		Config->LuaModuleDir,
+		"mods"
+	};
+
+	for(auto &directory : directories) {
+		if(_file_watcher.Watch(directory)) {
+			LogHotReloadDetail("Watching [{}] for quest changes", directory);
+		}
+	}
 }
 
-bool QuestParserCollection::HasQuestSubLocal(uint32 npcid, QuestEventID evt) {
-	auto iter = _npc_quest_status.find(npcid);
+void QuestParserCollection::StopWatchingQuestFiles() {
+	_file_watcher.Clear();
+}
 
-	if(iter != _npc_quest_status.end()) {
-		//loaded or failed to load
-		if(iter->second != QuestFailedToLoad) {
-			auto qiter = _interfaces.find(iter->second);
-			if(qiter->second->HasQuestSub(npcid, evt)) {
-				return true;
+bool QuestParserCollection::ReloadChangedQuests(bool reset_timers, std::vector<std::string> &reloaded) {
+	std::vector<std::string> changed;
+	bool overflowed = false;
+	_file_watcher.Poll(changed, overflowed);
+	if(overflowed) {
+		return false;
+	}
+
+	std::string module_dir = QuestFileWatcher::NormalizePath(Config->LuaModuleDir);
+	std::string plugin_dir = QuestFileWatcher::NormalizePath(Config->PluginDir);
+	bool resolve_scripts = false;
+
+	for(auto &path : changed) {
+		if(!IsQuestFile(path)) {
+			continue;
+		}
+
+		if(_script_files.find(path) != _script_files.end()) {
+			if(!UnloadScriptFile(path, reset_timers)) {
+				return false;
 			}
+			reloaded.push_back(path);
+			continue;
 		}
-	} else {
-		std::string filename;
-		QuestInterface *qi = GetQIByNPCQuest(npcid, filename);
-		if(qi) {
-			_npc_quest_status[npcid] = qi->GetIdentifier();
 
-			qi->LoadNPCScript(filename, npcid);
-			if(qi->HasQuestSub(npcid, evt)) {
-				return true;
+		bool dependency = false;
+		for(auto qi : _load_precedence) {
+			std::vector<std::string> dependents;
+			auto scope = qi->InvalidateFile(path, dependents);
+			if(scope == QuestFileGlobal) {
+				return false;
 			}
-		} else {
-			_npc_quest_status[npcid] = QuestFailedToLoad;
+
+			if(scope != QuestFileDependency) {
+				continue;
+			}
+
+			dependency = true;
+			for(auto &dependent : dependents) {
+				std::string dependent_path = QuestFileWatcher::NormalizePath(dependent);
+				if(_script_files.find(dependent_path) == _script_files.end()) {
+					continue;
+				}
+
+				if(!UnloadScriptFile(dependent_path, reset_timers)) {
+					return false;
+				}
+				reloaded.push_back(dependent_path);
+			}
+		}
+
+		if(dependency) {
+			continue;
+		}
+
+		//a module nothing has required yet cannot affect a loaded script
+		if(path.compare(0, module_dir.length(), module_dir) == 0) {
+			continue;
+		}
+
+		//plugins, mods and script_init run in every script's environment
+		auto slash = path.find_last_of('/');
+		std::string file = slash == std::string::npos ? path : path.substr(slash + 1);
+		if(path.compare(0, plugin_dir.length(), plugin_dir) == 0 || path.compare(0, 5, "mods/") == 0 ||
+			file.compare(0, 11, "script_init") == 0) {
+			return false;
+		}
+
+		//a script nothing has loaded yet, it may now be found for something that had none or take precedence over one in use
+		resolve_scripts = true;
+	}
+
+	if(resolve_scripts) {
+		for(auto iter = _npc_quest_status.begin(); iter != _npc_quest_status.end();) {
+			iter = iter->second == QuestFailedToLoad ? _npc_quest_status.erase(iter) : std::next(iter);
+		}
+		for(auto iter = _spell_quest_status.begin(); iter != _spell_quest_status.end();) {
+			iter = iter->second == QuestFailedToLoad ? _spell_quest_status.erase(iter) : std::next(iter);
+		}
+		for(auto iter = _item_quest_status.begin(); iter != _item_quest_status.end();) {
+			iter = iter->second == QuestFailedToLoad ? _item_quest_status.erase(iter) : std::next(iter);
+		}
+		for(auto iter = _encounter_quest_status.begin(); iter != _encounter_quest_status.end();) {
+			iter = iter->second == QuestFailedToLoad ? _encounter_quest_status.erase(iter) : std::next(iter);
+		}
+		if(_global_npc_quest_status == QuestFailedToLoad) {
+			_global_npc_quest_status = QuestUnloaded;
+		}
+		ClearEventMasks();
+
+		std::vector<std::string> shadowed;
+		for(auto &script_file : _script_files) {
+			for(auto &script : script_file.second) {
+				if(!ResolvesTo(script)) {
+					shadowed.push_back(script_file.first);
+					break;
+				}
+			}
+		}
+
+		for(auto &path : shadowed) {
+			if(!UnloadScriptFile(path, reset_timers)) {
+				return false;
+			}
+			reloaded.push_back(path);
+		}
+	}
+
+	return true;
+}
+
+void QuestParserCollection::OnScriptLoaded(QuestInterface *qi, QuestProfiler::ScriptType type, uint32 id,
+	const std::string &filename, const std::string &name) {
+	_profiler.SetScriptFile(type, id, filename, type == QuestProfiler::ScriptEncounter ? name : std::string());
+
+	LoadedScript script = { type, id, name, qi, filename };
+	_script_files[QuestFileWatcher::NormalizePath(filename)].push_back(script);
+}
+
+bool QuestParserCollection::IsQuestFile(const std::string &path) {
+	auto dot = path.find_last_of('.');
+	if(dot == std::string::npos) {
+		return false;
+	}
+
+	std::string ext = path.substr(dot + 1);
+	for(auto &e : _extensions) {
+		if(e.second == ext) {
+			return true;
 		}
 	}
 	return false;
 }
 
-bool QuestParserCollection::HasQuestSubGlobal(QuestEventID evt) {
+bool QuestParserCollection::ResolvesTo(const LoadedScript &script) {
+	std::string filename;
+	QuestInterface *qi = nullptr;
+	switch(script.type) {
+		case QuestProfiler::ScriptNPC:
+			qi = GetQIByNPCQuest(script.id, filename);
+			break;
+		case QuestProfiler::ScriptGlobalNPC:
+			qi = GetQIByGlobalNPCQuest(filename);
+			break;
+		case QuestProfiler::ScriptPlayer:
+			qi = GetQIByPlayerQuest(filename);
+			break;
+		case QuestProfiler::ScriptGlobalPlayer:
+			qi = GetQIByGlobalPlayerQuest(filename);
+			break;
+		case QuestProfiler::ScriptSpell:
+			qi = GetQIBySpellQuest(script.id, filename);
+			break;
+		case QuestProfiler::ScriptItem:
+			qi = GetQIByItemQuest(script.name, filename);
+			break;
+		case QuestProfiler::ScriptEncounter:
+			qi = GetQIByEncounterQuest(script.name, filename);
+			break;
+		default:
+			return true;
+	}
+
+	return qi == script.qi && QuestFileWatcher::NormalizePath(filename) == QuestFileWatcher::NormalizePath(script.filename);
+}
+
+bool QuestParserCollection::UnloadScriptFile(const std::string &path, bool reset_timers) {
+	auto iter = _script_files.find(path);
+	if(iter == _script_files.end()) {
+		return true;
+	}
+
+	//encounters register handlers on other scripts' events, only a full reload untangles those
+	for(auto &script : iter->second) {
+		if(script.type == QuestProfiler::ScriptEncounter) {
+			return false;
+		}
+	}
+
+	std::vector<QuestInterface*> unloaded;
+	for(auto &script : iter->second) {
+		if(std::find(unloaded.begin(), unloaded.end(), script.qi) == unloaded.end()) {
+			if(!script.qi->UnloadScript(script.filename)) {
+				return false;
+			}
+			unloaded.push_back(script.qi);
+		}
+
+		switch(script.type) {
+			case QuestProfiler::ScriptNPC:
+				_npc_quest_status.erase(script.id);
+				ClearEventSlot(_npc_event_slots, script.id);
+				if(reset_timers) {
+					for(auto &npc : entity_list.GetNPCList()) {
+						if(npc.second->GetNPCTypeID() == script.id) {
+							quest_manager.stopalltimers(npc.second);
+						}
+					}
+				}
+				break;
+			case QuestProfiler::ScriptGlobalNPC:
+				_global_npc_quest_status = QuestUnloaded;
+				_global_npc_events.known = false;
+				if(reset_timers) {
+					for(auto &npc : entity_list.GetNPCList()) {
+						quest_manager.stopalltimers(npc.second);
+					}
+				}
+				break;
+			case QuestProfiler::ScriptPlayer:
+			case QuestProfiler::ScriptGlobalPlayer:
+				if(script.type == QuestProfiler::ScriptPlayer) {
+					_player_quest_status = QuestUnloaded;
+					_player_events.known = false;
+				} else {
+					_global_player_quest_status = QuestUnloaded;
+					_global_player_events.known = false;
+				}
+				if(reset_timers) {
+					for(auto &client : entity_list.GetClientList()) {
+						quest_manager.stopalltimers(client.second);
+					}
+				}
+				break;
+			case QuestProfiler::ScriptSpell:
+				_spell_quest_status.erase(script.id);
+				ClearEventSlot(_spell_event_slots, script.id);
+				break;
+			case QuestProfiler::ScriptItem:
+				_item_quest_status.erase(script.id);
+				ClearEventSlot(_item_event_slots, script.id);
+				break;
+			default:
+				break;
+		}
+	}
+
+	_script_files.erase(iter);
+	return true;
+}
+
+bool QuestParserCollection::HasQuestSub(uint32 npcid, QuestEventID evt) {
+	if(evt >= _LargestEventID) {
+		return false;
+	}
+
+	return GetNPCEvents(npcid)[evt] ||
+		GetGlobalEvents(_global_npc_events, &QuestParserCollection::LoadGlobalNPCQuest, &QuestInterface::HasGlobalQuestSub)[evt];
+}
+
+bool QuestParserCollection::PlayerHasQuestSub(QuestEventID evt) {
+	if(evt >= _LargestEventID) {
+		return false;
+	}
+
+	return GetGlobalEvents(_player_events, &QuestParserCollection::LoadPlayerQuest, &QuestInterface::PlayerHasQuestSub)[evt] ||
+		GetGlobalEvents(_global_player_events, &QuestParserCollection::LoadGlobalPlayerQuest, &QuestInterface::GlobalPlayerHasQuestSub)[evt];
+}
+
+bool QuestParserCollection::SpellHasQuestSub(uint32 spell_id, QuestEventID evt) {
+	if(evt >= _LargestEventID) {
+		return false;
+	}
+
+	uint32 slot = spell_id < _spell_event_slots.size() ? _spell_event_slots[spell_id] : 0;
+	if(slot) {
+		return _event_masks[slot - 1][evt];
+	}
+
+	QuestEventMask mask;
+	QuestInterface *qi = LoadSpellQuest(spell_id);
+	for(int i = 0; qi && i < _LargestEventID; ++i) {
+		mask[i] = qi->SpellHasQuestSub(spell_id, static_cast<QuestEventID>(i));
+	}
+
+	return CacheEventMask(_spell_event_slots, spell_id, mask)[evt];
+}
+
+bool QuestParserCollection::ItemHasQuestSub(EQ::ItemInstance *itm, QuestEventID evt) {
+	if (itm == nullptr || evt >= _LargestEventID)
+		return false;
+
+	uint32 item_id = itm->GetID();
+	uint32 slot = item_id < _item_event_slots.size() ? _item_event_slots[item_id] : 0;
+	if(slot) {
+		return _event_masks[slot - 1][evt];
+	}
+
+	QuestEventMask mask;
+	QuestInterface *qi = LoadItemQuest(itm);
+	for(int i = 0; qi && i < _LargestEventID; ++i) {
+		mask[i] = qi->ItemHasQuestSub(itm, static_cast<QuestEventID>(i));
+	}
+
+	return CacheEventMask(_item_event_slots, item_id, mask)[evt];
+}
+
+QuestParserCollection::QuestEventMask QuestParserCollection::GetNPCEvents(uint32 npcid) {
+	uint32 slot = npcid < _npc_event_slots.size() ? _npc_event_slots[npcid] : 0;
+	if(slot) {
+		return _event_masks[slot - 1];
+	}
+
+	QuestEventMask mask;
+	QuestInterface *qi = LoadNPCQuest(npcid);
+	for(int i = 0; qi && i < _LargestEventID; ++i) {
+		mask[i] = qi->HasQuestSub(npcid, static_cast<QuestEventID>(i));
+	}
+
+	return CacheEventMask(_npc_event_slots, npcid, mask);
+}
+
+const QuestParserCollection::QuestEventMask &QuestParserCollection::GetGlobalEvents(CachedEvents &events,
+	QuestInterface *(QuestParserCollection::*load)(), bool (QuestInterface::*has_sub)(QuestEventID)) {
+	if(!events.known) {
+		events.mask.reset();
+		QuestInterface *qi = (this->*load)();
+		for(int i = 0; qi && i < _LargestEventID; ++i) {
+			events.mask[i] = (qi->*has_sub)(static_cast<QuestEventID>(i));
+		}
+		events.known = true;
+	}
+
+	return events.mask;
+}
+
+QuestParserCollection::QuestEventMask QuestParserCollection::CacheEventMask(std::vector<uint32> &slots, uint32 id,
+	const QuestEventMask &mask) {
+	//ids past this are rare enough not to be worth the memory, they just get looked up every time
+	if(id >= MaxEventSlotIndex) {
+		return mask;
+	}
+
+	if(slots.size() <= id) {
+		slots.resize(id + 1, 0);
+	}
+
+	_event_masks.push_back(mask);
+	slots[id] = static_cast<uint32>(_event_masks.size());
+	return mask;
+}
+
+void QuestParserCollection::ClearEventSlot(std::vector<uint32> &slots, uint32 id) {
+	//the old mask stays in _event_masks until the next ReloadQuests, a changed script is reloaded rarely enough
+	if(id < slots.size()) {
+		slots[id] = 0;
+	}
+}
+
+void QuestParserCollection::ClearEventMasks() {
+	_npc_event_slots.clear();
+	_spell_event_slots.clear();
+	_item_event_slots.clear();
+	_event_masks.clear();
+	_global_npc_events.known = false;
+	_player_events.known = false;
+	_global_player_events.known = false;
+}
+
+QuestInterface *QuestParserCollection::LoadNPCQuest(uint32 npcid) {
+	auto iter = _npc_quest_status.find(npcid);
+	if(iter != _npc_quest_status.end()) {
+		//loaded or failed to load
+		return iter->second != QuestFailedToLoad ? _interfaces[iter->second] : nullptr;
+	}
+
+	std::string filename;
+	QuestInterface *qi = GetQIByNPCQuest(npcid, filename);
+	if(qi) {
+		_npc_quest_status[npcid] = qi->GetIdentifier();
+		qi->LoadNPCScript(filename, npcid);
+		OnScriptLoaded(qi, QuestProfiler::ScriptNPC, npcid, filename);
+	} else {
+		_npc_quest_status[npcid] = QuestFailedToLoad;
+	}
+	return qi;
+}
+
+QuestInterface *QuestParserCollection::LoadGlobalNPCQuest() {
 	if(_global_npc_quest_status == QuestUnloaded) {
 		std::string filename;
 		QuestInterface *qi = GetQIByGlobalNPCQuest(filename);
 		if(qi) {
 			qi->LoadGlobalNPCScript(filename);
+			OnScriptLoaded(qi, QuestProfiler::ScriptGlobalNPC, 0, filename);
 			_global_npc_quest_status = qi->GetIdentifier();
-			if(qi->HasGlobalQuestSub(evt)) {
-				return true;
-			}
-		}
-	} else {
-		if(_global_npc_quest_status != QuestFailedToLoad) {
-			auto qiter = _interfaces.find(_global_npc_quest_status);
-			if(qiter->second->HasGlobalQuestSub(evt)) {
-				return true;
-			}
 		}
+		return qi;
 	}
-	return false;
-}
 
-bool QuestParserCollection::PlayerHasQuestSub(QuestEventID evt) {
-	return PlayerHasQuestSubLocal(evt) || PlayerHasQuestSubGlobal(evt);
+	return _global_npc_quest_status != QuestFailedToLoad ? _interfaces[_global_npc_quest_status] : nullptr;
 }
 
-bool QuestParserCollection::PlayerHasQuestSubLocal(QuestEventID evt) {
+QuestInterface *QuestParserCollection::LoadPlayerQuest() {
 	if(_player_quest_status == QuestUnloaded) {
-		std::string filename;	
+		std::string filename;
 		QuestInterface *qi = GetQIByPlayerQuest(filename);
 		if(qi) {
 			_player_quest_status = qi->GetIdentifier();
 			qi->LoadPlayerScript(filename);
-			return qi->PlayerHasQuestSub(evt);
+			OnScriptLoaded(qi, QuestProfiler::ScriptPlayer, 0, filename);
 		}
-	} else if(_player_quest_status != QuestFailedToLoad) {
-		auto iter = _interfaces.find(_player_quest_status);
-		return iter->second->PlayerHasQuestSub(evt);
+		return qi;
 	}
-	return false;
+
+	return _player_quest_status != QuestFailedToLoad ? _interfaces[_player_quest_status] : nullptr;
 }
 
-bool QuestParserCollection::PlayerHasQuestSubGlobal(QuestEventID evt) {
+QuestInterface *QuestParserCollection::LoadGlobalPlayerQuest() {
 	if(_global_player_quest_status == QuestUnloaded) {
-		std::string filename;	
+		std::string filename;
 		QuestInterface *qi = GetQIByGlobalPlayerQuest(filename);
 		if(qi) {
 			_global_player_quest_status = qi->GetIdentifier();
 			qi->LoadGlobalPlayerScript(filename);
-			return qi->GlobalPlayerHasQuestSub(evt);
+			OnScriptLoaded(qi, QuestProfiler::ScriptGlobalPlayer, 0, filename);
 		}
-	} else if(_global_player_quest_status != QuestFailedToLoad) {
-		auto iter = _interfaces.find(_global_player_quest_status);
-		return iter->second->GlobalPlayerHasQuestSub(evt);
+		return qi;
 	}
-	return false;
+
+	return _global_player_quest_status != QuestFailedToLoad ? _interfaces[_global_player_quest_status] : nullptr;
 }
 
-bool QuestParserCollection::SpellHasQuestSub(uint32 spell_id, QuestEventID evt) {
+QuestInterface *QuestParserCollection::LoadSpellQuest(uint32 spell_id) {
 	auto iter = _spell_quest_status.find(spell_id);
 	if(iter != _spell_quest_status.end()) {
 		//loaded or failed to load
-		if(iter->second != QuestFailedToLoad) {
-			auto qiter = _interfaces.find(iter->second);
-			return qiter->second->SpellHasQuestSub(spell_id, evt);
-		}
-	} else if(_spell_quest_status[spell_id] != QuestFailedToLoad){
-		std::string filename;
-		QuestInterface *qi = GetQIBySpellQuest(spell_id, filename);
-		if(qi) {
-			_spell_quest_status[spell_id] = qi->GetIdentifier();
-			qi->LoadSpellScript(filename, spell_id);
-			return qi->SpellHasQuestSub(spell_id, evt);
-		} else {
-			_spell_quest_status[spell_id] = QuestFailedToLoad;
-		}
+		return iter->second != QuestFailedToLoad ? _interfaces[iter->second] : nullptr;
 	}
-	return false;
-}
 
-bool QuestParserCollection::ItemHasQuestSub(EQ::ItemInstance *itm, QuestEventID evt) {
-	if (itm == nullptr)
-		return false;
+	std::string filename;
+	QuestInterface *qi = GetQIBySpellQuest(spell_id, filename);
+	if(qi) {
+		_spell_quest_status[spell_id] = qi->GetIdentifier();
+		qi->LoadSpellScript(filename, spell_id);
+		OnScriptLoaded(qi, QuestProfiler::ScriptSpell, spell_id, filename);
+	} else {
+		_spell_quest_status[spell_id] = QuestFailedToLoad;
+	}
+	return qi;
+}
 
+QuestInterface *QuestParserCollection::LoadItemQuest(EQ::ItemInstance *itm) {
 	std::string item_script;
 	if(itm->GetItem()->ScriptFileID != 0) {
 		item_script = "script_";
@@ -219,22 +575,19 @@ bool QuestParserCollection::ItemHasQuestSub(EQ::ItemInstance *itm, QuestEventID
 	auto iter = _item_quest_status.find(item_id);
 	if(iter != _item_quest_status.end()) {
 		//loaded or failed to load
-		if(iter->second != QuestFailedToLoad) {
-			auto qiter = _interfaces.find(iter->second);
-			return qiter->second->ItemHasQuestSub(itm, evt);
-		}
+		return iter->second != QuestFailedToLoad ? _interfaces[iter->second] : nullptr;
+	}
+
+	std::string filename;
+	QuestInterface *qi = GetQIByItemQuest(item_script, filename);
+	if(qi) {
+		_item_quest_status[item_id] = qi->GetIdentifier();
+		qi->LoadItemScript(filename, itm);
+		OnScriptLoaded(qi, QuestProfiler::ScriptItem, item_id, filename, item_script);
 	} else {
-		std::string filename;
-		QuestInterface *qi = GetQIByItemQuest(item_script, filename);
-		if(qi) {
-			_item_quest_status[item_id] = qi->GetIdentifier();
-			qi->LoadItemScript(filename, itm);
-			return qi->ItemHasQuestSub(itm, evt);
-		} else {
-			_item_quest_status[item_id] = QuestFailedToLoad;
-		}
+		_item_quest_status[item_id] = QuestFailedToLoad;
 	}
-	return false;
+	return qi;
 }
 
 int QuestParserCollection::EventNPC(QuestEventID evt, NPC *npc, Mob *init, std::string data, uint32 extra_data,
@@ -262,6 +615,7 @@ int QuestParserCollection::EventNPCLocal(QuestEventID evt, NPC* npc, Mob *init,
 		//loaded or failed to load
 		if(iter->second != QuestFailedToLoad) {
 			auto qiter = _interfaces.find(iter->second);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptNPC, npc->GetNPCTypeID(), evt);
 			return qiter->second->EventNPC(evt, npc, init, data, extra_data, extra_pointers);
 		}
 	} else if (_npc_quest_status[npc->GetNPCTypeID()] != QuestFailedToLoad){
@@ -270,6 +624,8 @@ int QuestParserCollection::EventNPCLocal(QuestEventID evt, NPC* npc, Mob *init,
 		if(qi) {
 			_npc_quest_status[npc->GetNPCTypeID()] = qi->GetIdentifier();
 			qi->LoadNPCScript(filename, npc->GetNPCTypeID());
+			OnScriptLoaded(qi, QuestProfiler::ScriptNPC, npc->GetNPCTypeID(), filename);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptNPC, npc->GetNPCTypeID(), evt);
 			return qi->EventNPC(evt, npc, init, data, extra_data, extra_pointers);
 		} else {
 			_npc_quest_status[npc->GetNPCTypeID()] = QuestFailedToLoad;
@@ -282,6 +638,7 @@ int QuestParserCollection::EventNPCGlobal(QuestEventID evt, NPC* npc, Mob *init,
 										  std::vector<EQ::Any> *extra_pointers) {
 	if(_global_npc_quest_status != QuestUnloaded && _global_npc_quest_status != QuestFailedToLoad) {
 		auto qiter = _interfaces.find(_global_npc_quest_status);
+		QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptGlobalNPC, 0, evt);
 		return qiter->second->EventGlobalNPC(evt, npc, init, data, extra_data, extra_pointers);
 	} 
 	else if(_global_npc_quest_status != QuestFailedToLoad){
@@ -290,6 +647,8 @@ int QuestParserCollection::EventNPCGlobal(QuestEventID evt, NPC* npc, Mob *init,
 		if(qi) {
 			_global_npc_quest_status = qi->GetIdentifier();
 			qi->LoadGlobalNPCScript(filename);
+			OnScriptLoaded(qi, QuestProfiler::ScriptGlobalNPC, 0, filename);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptGlobalNPC, 0, evt);
 			return qi->EventGlobalNPC(evt, npc, init, data, extra_data, extra_pointers);
 		} else {
 			_global_npc_quest_status = QuestFailedToLoad;
@@ -324,11 +683,14 @@ int QuestParserCollection::EventPlayerLocal(QuestEventID evt, Client *client, st
 		if(qi) {
 			_player_quest_status = qi->GetIdentifier();
 			qi->LoadPlayerScript(filename);
+			OnScriptLoaded(qi, QuestProfiler::ScriptPlayer, 0, filename);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptPlayer, 0, evt);
 			return qi->EventPlayer(evt, client, data, extra_data, extra_pointers);
 		}
 	} else { 
 		if(_player_quest_status != QuestFailedToLoad) {
 			auto iter = _interfaces.find(_player_quest_status);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptPlayer, 0, evt);
 			return iter->second->EventPlayer(evt, client, data, extra_data, extra_pointers);
 		}
 	}
@@ -343,11 +705,14 @@ int QuestParserCollection::EventPlayerGlobal(QuestEventID evt, Client *client, s
 		if(qi) {
 			_global_player_quest_status = qi->GetIdentifier();
 			qi->LoadGlobalPlayerScript(filename);
+			OnScriptLoaded(qi, QuestProfiler::ScriptGlobalPlayer, 0, filename);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptGlobalPlayer, 0, evt);
 			return qi->EventGlobalPlayer(evt, client, data, extra_data, extra_pointers);
 		}
 	} else { 
 		if(_global_player_quest_status != QuestFailedToLoad) {
 			auto iter = _interfaces.find(_global_player_quest_status);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptGlobalPlayer, 0, evt);
 			return iter->second->EventGlobalPlayer(evt, client, data, extra_data, extra_pointers);
 		}
 	}
@@ -375,6 +740,7 @@ int QuestParserCollection::EventItem(QuestEventID evt, Client *client, EQ::ItemI
 		if(iter->second != QuestFailedToLoad) {
 			auto qiter = _interfaces.find(iter->second);
 			int ret = DispatchEventItem(evt, client, item, mob, data, extra_data, extra_pointers);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptItem, item_id, evt);
 			int i = qiter->second->EventItem(evt, client, item, mob, data, extra_data, extra_pointers);
             if(i != 0) {
                 ret = i;
@@ -388,7 +754,9 @@ int QuestParserCollection::EventItem(QuestEventID evt, Client *client, EQ::ItemI
 		if(qi) {
 			_item_quest_status[item_id] = qi->GetIdentifier();
 			qi->LoadItemScript(filename, item);
+			OnScriptLoaded(qi, QuestProfiler::ScriptItem, item_id, filename, item_script);
 			int ret = DispatchEventItem(evt, client, item, mob, data, extra_data, extra_pointers);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptItem, item_id, evt);
 			int i = qi->EventItem(evt, client, item, mob, data, extra_data, extra_pointers);
             if(i != 0) {
                 ret = i;
@@ -410,6 +778,7 @@ int QuestParserCollection::EventSpell(QuestEventID evt, NPC* npc, Client *client
 		if(iter->second != QuestFailedToLoad) {
 			auto qiter = _interfaces.find(iter->second);
 			int ret = DispatchEventSpell(evt, npc, client, spell_id, extra_data, extra_pointers);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptSpell, spell_id, evt);
 			int i = qiter->second->EventSpell(evt, npc, client, spell_id, extra_data, extra_pointers);
             if(i != 0) {
                 ret = i;
@@ -424,7 +793,9 @@ int QuestParserCollection::EventSpell(QuestEventID evt, NPC* npc, Client *client
 		if (qi) {
 			_spell_quest_status[spell_id] = qi->GetIdentifier();
 			qi->LoadSpellScript(filename, spell_id);
+			OnScriptLoaded(qi, QuestProfiler::ScriptSpell, spell_id, filename);
 			int ret = DispatchEventSpell(evt, npc, client, spell_id, extra_data, extra_pointers);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptSpell, spell_id, evt);
 			int i = qi->EventSpell(evt, npc, client, spell_id, extra_data, extra_pointers);
 			if (i != 0) {
 				ret = i;
@@ -446,6 +817,7 @@ int QuestParserCollection::EventEncounter(QuestEventID evt, std::string encounte
 		//loaded or failed to load
 		if(iter->second != QuestFailedToLoad) {
 			auto qiter = _interfaces.find(iter->second);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptEncounter, 0, evt, encounter_name);
 			return qiter->second->EventEncounter(evt, encounter_name, data, extra_data, extra_pointers);
 		}
 	} else if(_encounter_quest_status[encounter_name] != QuestFailedToLoad){
@@ -454,6 +826,8 @@ int QuestParserCollection::EventEncounter(QuestEventID evt, std::string encounte
 		if(qi) {
 			_encounter_quest_status[encounter_name] = qi->GetIdentifier();
 			qi->LoadEncounterScript(filename, encounter_name);
+			OnScriptLoaded(qi, QuestProfiler::ScriptEncounter, 0, filename, encounter_name);
+			QuestProfiler::Scope profile(_profiler, QuestProfiler::ScriptEncounter, 0, evt, encounter_name);
 			return qi->EventEncounter(evt, encounter_name, data, extra_data, extra_pointers);
 		} else {
 			_encounter_quest_status[encounter_name] = QuestFailedToLoad;
@@ -33,11 +33,15 @@
 #include "trap.h"
 
 #include "quest_interface.h"
+#include "quest_profiler.h"
+#include "quest_file_watcher.h"
 
 #include "zone_config.h"
 
+#include <bitset>
 #include <list>
 #include <map>
+#include <vector>
 
 #define QuestFailedToLoad 0xFFFFFFFF
 #define QuestUnloaded 0x00
@@ -84,6 +88,16 @@ public:
 	
 	void GetErrors(std::list<std::string> &err);
 
+	QuestProfiler &GetProfiler() { return _profiler; }
+
+	//watches this zone's quest, plugin and module directories for ReloadChangedQuests
+	void WatchQuestFiles();
+	void StopWatchingQuestFiles();
+	bool IsWatchingQuestFiles() const { return _file_watcher.IsWatching(); }
+	//unloads scripts whose files changed since the last call, plus the scripts that depend on them, so they
+	//compile again on their next event; returns false when a change touches every script and a full ReloadQuests is needed
+	bool ReloadChangedQuests(bool reset_timers, std::vector<std::string> &reloaded);
+
 	/*
 		Internally used memory reference for all Perl Event Export Settings
 		Some exports are very taxing on CPU given how much an event is called.
@@ -106,10 +120,29 @@ public:
 	void LoadPerlEventExportSettings(PerlEventExportSettings* perl_event_export_settings);
 
 private:
-	bool HasQuestSubLocal(uint32 npcid, QuestEventID evt);
-	bool HasQuestSubGlobal(QuestEventID evt);
-	bool PlayerHasQuestSubLocal(QuestEventID evt);
-	bool PlayerHasQuestSubGlobal(QuestEventID evt);
+	typedef std::bitset<_LargestEventID> QuestEventMask;
+
+	struct CachedEvents {
+		bool known;
+		QuestEventMask mask;
+	};
+
+	//ids at or above this are not given a slot
+	static const uint32 MaxEventSlotIndex = 4 * 1024 * 1024;
+
+	QuestEventMask GetNPCEvents(uint32 npcid);
+	const QuestEventMask &GetGlobalEvents(CachedEvents &events, QuestInterface *(QuestParserCollection::*load)(),
+		bool (QuestInterface::*has_sub)(QuestEventID));
+	QuestEventMask CacheEventMask(std::vector<uint32> &slots, uint32 id, const QuestEventMask &mask);
+	void ClearEventSlot(std::vector<uint32> &slots, uint32 id);
+	void ClearEventMasks();
+
+	QuestInterface *LoadNPCQuest(uint32 npcid);
+	QuestInterface *LoadGlobalNPCQuest();
+	QuestInterface *LoadPlayerQuest();
+	QuestInterface *LoadGlobalPlayerQuest();
+	QuestInterface *LoadSpellQuest(uint32 spell_id);
+	QuestInterface *LoadItemQuest(EQ::ItemInstance *itm);
 
 	int EventNPCLocal(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data, std::vector<EQ::Any> *extra_pointers);
 	int EventNPCGlobal(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data, std::vector<EQ::Any> *extra_pointers);
@@ -133,6 +166,20 @@ private:
 	int DispatchEventSpell(QuestEventID evt, NPC* npc, Client *client, uint32 spell_id, uint32 extra_data,
 		std::vector<EQ::Any> *extra_pointers);
 
+	struct LoadedScript {
+		QuestProfiler::ScriptType type;
+		uint32 id;
+		std::string name;
+		QuestInterface *qi;
+		std::string filename;
+	};
+
+	void OnScriptLoaded(QuestInterface *qi, QuestProfiler::ScriptType type, uint32 id, const std::string &filename,
+		const std::string &name = std::string());
+	bool UnloadScriptFile(const std::string &path, bool reset_timers);
+	bool IsQuestFile(const std::string &path);
+	bool ResolvesTo(const LoadedScript &script);
+
 	std::map<uint32, QuestInterface*> _interfaces;
 	std::map<uint32, std::string> _extensions;
 	std::list<QuestInterface*> _load_precedence;
@@ -146,6 +193,22 @@ private:
 	std::map<uint32, uint32> _spell_quest_status;
 	std::map<uint32, uint32> _item_quest_status;
 	std::map<std::string, uint32> _encounter_quest_status;
+
+	//the events each loaded script implements, so HasQuestSub is a bit test instead of a map lookup and a virtual
+	//call per interface; slots map an npc type, spell or item id to 1 + its index in _event_masks, 0 is not looked up yet
+	std::vector<uint32> _npc_event_slots;
+	std::vector<uint32> _spell_event_slots;
+	std::vector<uint32> _item_event_slots;
+	std::vector<QuestEventMask> _event_masks;
+	CachedEvents _global_npc_events;
+	CachedEvents _player_events;
+	CachedEvents _global_player_events;
+
+	QuestProfiler _profiler;
+
+	//scripts loaded since the last ReloadQuests keyed by normalized path, one file can back several item scripts
+	std::map<std::string, std::vector<LoadedScript>> _script_files;
+	QuestFileWatcher _file_watcher;
 };
 
 extern QuestParserCollection *parse;
@@ -0,0 +1,90 @@
+#include "quest_profiler.h"
+#include "../common/dbcore.h"
+
+#include <algorithm>
+
+QuestProfiler::Scope::Scope(QuestProfiler &profiler, ScriptType type, uint32 id, int event, const std::string &name)
+	: m_profiler(profiler), m_type(type), m_id(id), m_event(event), m_name(name),
+	m_start(std::chrono::steady_clock::now()), m_db_start(DBcore::GetThreadQueryTime())
+{
+}
+
+QuestProfiler::Scope::~Scope()
+{
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count();
+	m_profiler.Record(m_type, m_id, m_event, m_name, static_cast<uint64>(elapsed), DBcore::GetThreadQueryTime() - m_db_start);
+}
+
+void QuestProfiler::Record(ScriptType type, uint32 id, int event, const std::string &name, uint64 elapsed, uint64 db_time)
+{
+	Key key{ type, id, event, name };
+	auto iter = m_stats.find(key);
+	if (iter == m_stats.end()) {
+		iter = m_stats.emplace(std::move(key), Stats{ 0, 0, 0, 0 }).first;
+	}
+
+	Stats &stats = iter->second;
+	stats.calls++;
+	stats.total_time += elapsed;
+	stats.max_time = std::max(stats.max_time, elapsed);
+	stats.db_time += db_time;
+}
+
+void QuestProfiler::SetScriptFile(ScriptType type, uint32 id, const std::string &filename, const std::string &name)
+{
+	m_files[ScriptName(type, id, name)] = filename;
+}
+
+void QuestProfiler::Reset()
+{
+	m_stats.clear();
+}
+
+std::string QuestProfiler::ScriptName(ScriptType type, uint32 id, const std::string &name)
+{
+	switch (type) {
+	case ScriptNPC:
+		return "npc_" + std::to_string(id);
+	case ScriptGlobalNPC:
+		return "global_npc";
+	case ScriptPlayer:
+		return "player";
+	case ScriptGlobalPlayer:
+		return "global_player";
+	case ScriptItem:
+		return "item_" + std::to_string(id);
+	case ScriptSpell:
+		return "spell_" + std::to_string(id);
+	case ScriptEncounter:
+		return "encounter_" + name;
+	}
+
+	return std::string();
+}
+
+std::vector<QuestProfiler::Entry> QuestProfiler::GetTop(size_t count) const
+{
+	std::vector<Entry> entries;
+	entries.reserve(m_stats.size());
+	for (auto &e : m_stats) {
+		Entry entry;
+		entry.script = ScriptName(e.first.type, e.first.id, e.first.name);
+		auto file = m_files.find(entry.script);
+		if (file != m_files.end()) {
+			entry.filename = file->second;
+		}
+		entry.event = e.first.event;
+		entry.calls = e.second.calls;
+		entry.total_time = e.second.total_time;
+		entry.max_time = e.second.max_time;
+		entry.db_time = e.second.db_time;
+		entries.push_back(std::move(entry));
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.total_time > b.total_time; });
+	if (entries.size() > count) {
+		entries.resize(count);
+	}
+
+	return entries;
+}
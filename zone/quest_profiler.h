@@ -0,0 +1,91 @@
+#ifndef QUEST_PROFILER_H
+#define QUEST_PROFILER_H
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../common/types.h"
+
+/*
+ * Call count and wall time per (script, event), collected around every quest
+ * interface call in QuestParserCollection. Times are inclusive: an event that
+ * triggers another event is charged for both, and db_time is whatever queries
+ * ran on the zone thread while the event was on the stack.
+ */
+class QuestProfiler {
+public:
+	enum ScriptType : uint8 {
+		ScriptNPC,
+		ScriptGlobalNPC,
+		ScriptPlayer,
+		ScriptGlobalPlayer,
+		ScriptItem,
+		ScriptSpell,
+		ScriptEncounter
+	};
+
+	struct Entry {
+		std::string script;
+		std::string filename;
+		int event;
+		uint64 calls;
+		uint64 total_time; // microseconds
+		uint64 max_time;
+		uint64 db_time;
+	};
+
+	class Scope {
+	public:
+		Scope(QuestProfiler &profiler, ScriptType type, uint32 id, int event, const std::string &name = std::string());
+		~Scope();
+	private:
+		QuestProfiler &m_profiler;
+		ScriptType m_type;
+		uint32 m_id;
+		int m_event;
+		std::string m_name;
+		std::chrono::steady_clock::time_point m_start;
+		uint64 m_db_start;
+	};
+
+	void SetScriptFile(ScriptType type, uint32 id, const std::string &filename, const std::string &name = std::string());
+	void Reset();
+
+	// entries sorted by total time, slowest first
+	std::vector<Entry> GetTop(size_t count) const;
+
+private:
+	struct Key {
+		ScriptType type;
+		uint32 id;
+		int event;
+		std::string name;
+
+		bool operator==(const Key &o) const { return type == o.type && id == o.id && event == o.event && name == o.name; }
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key &k) const
+		{
+			size_t h = std::hash<std::string>()(k.name);
+			h ^= (static_cast<uint64>(k.type) << 56 | static_cast<uint64>(k.id) << 16 | static_cast<uint16>(k.event)) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+			return h;
+		}
+	};
+
+	struct Stats {
+		uint64 calls;
+		uint64 total_time;
+		uint64 max_time;
+		uint64 db_time;
+	};
+
+	void Record(ScriptType type, uint32 id, int event, const std::string &name, uint64 elapsed, uint64 db_time);
+	static std::string ScriptName(ScriptType type, uint32 id, const std::string &name);
+
+	std::unordered_map<Key, Stats, KeyHash> m_stats;
+	std::unordered_map<std::string, std::string> m_files;
+};
+
+#endif
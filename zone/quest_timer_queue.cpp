@@ -0,0 +1,161 @@
+#include "quest_timer_queue.h"
+#include "../common/timer.h"
+
+#include <algorithm>
+#include <functional>
+
+QuestTimerQueue::QuestTimerQueue()
+	: m_next_serial(1), m_clock(0), m_last_time(Timer::GetCurrentTime())
+{
+}
+
+uint64 QuestTimerQueue::Now() const
+{
+	uint32 current_time = Timer::GetCurrentTime();
+	m_clock += static_cast<uint32>(current_time - m_last_time);
+	m_last_time = current_time;
+	return m_clock;
+}
+
+void QuestTimerQueue::Push(uint64 due, uint64 serial)
+{
+	m_heap.push_back({ due, serial });
+	std::push_heap(m_heap.begin(), m_heap.end(), std::greater<HeapNode>());
+
+	// timers that are restarted over and over without firing leave stale nodes behind
+	if (m_heap.size() > 64 && m_heap.size() > m_timers.size() * 2)
+		Compact();
+}
+
+void QuestTimerQueue::Compact()
+{
+	m_heap.clear();
+	m_heap.reserve(m_timers.size());
+	for (auto &e : m_timers)
+		m_heap.push_back({ e.second.due, e.first });
+	std::make_heap(m_heap.begin(), m_heap.end(), std::greater<HeapNode>());
+}
+
+void QuestTimerQueue::Start(Mob *mob, const std::string &name, uint32 duration)
+{
+	uint64 now = Now();
+	auto &names = m_index[mob];
+	auto iter = names.find(name);
+	if (iter != names.end()) {
+		// Timer::Start(0, false) kept the previous duration, restarting with 0 rearms a full interval
+		auto &timer = m_timers[iter->second];
+		timer.due = now + (duration ? duration : timer.interval) + 1;
+		Push(timer.due, iter->second);
+		return;
+	}
+
+	uint64 serial = m_next_serial++;
+	TimerState &timer = m_timers[serial];
+	timer.mob = mob;
+	timer.name = name;
+	timer.interval = duration;
+	timer.due = now + duration + 1;
+	names.emplace(name, serial);
+	Push(timer.due, serial);
+}
+
+void QuestTimerQueue::Erase(uint64 serial)
+{
+	// heap nodes for this serial are dropped lazily in PopExpired
+	m_timers.erase(serial);
+	if (m_heap.size() > 64 && m_heap.size() > m_timers.size() * 2)
+		Compact();
+}
+
+bool QuestTimerQueue::Stop(Mob *mob, const std::string &name)
+{
+	auto mob_iter = m_index.find(mob);
+	if (mob_iter == m_index.end())
+		return false;
+
+	auto iter = mob_iter->second.find(name);
+	if (iter == mob_iter->second.end())
+		return false;
+
+	uint64 serial = iter->second;
+	mob_iter->second.erase(iter);
+	if (mob_iter->second.empty())
+		m_index.erase(mob_iter);
+	Erase(serial);
+	return true;
+}
+
+void QuestTimerQueue::StopAll(Mob *mob)
+{
+	auto mob_iter = m_index.find(mob);
+	if (mob_iter == m_index.end())
+		return;
+
+	std::vector<uint64> serials;
+	serials.reserve(mob_iter->second.size());
+	for (auto &e : mob_iter->second)
+		serials.push_back(e.second);
+	m_index.erase(mob_iter);
+
+	for (auto serial : serials)
+		Erase(serial);
+}
+
+void QuestTimerQueue::Clear()
+{
+	m_timers.clear();
+	m_index.clear();
+	m_heap.clear();
+}
+
+bool QuestTimerQueue::Has(Mob *mob, const std::string &name) const
+{
+	auto mob_iter = m_index.find(mob);
+	if (mob_iter == m_index.end())
+		return false;
+
+	return mob_iter->second.count(name) != 0;
+}
+
+uint32 QuestTimerQueue::GetRemainingTime(Mob *mob, const std::string &name) const
+{
+	auto mob_iter = m_index.find(mob);
+	if (mob_iter == m_index.end())
+		return 0;
+
+	auto iter = mob_iter->second.find(name);
+	if (iter == mob_iter->second.end())
+		return 0;
+
+	auto &timer = m_timers.at(iter->second);
+	uint64 now = Now();
+	if (timer.due <= now + 1)
+		return 0;
+
+	return static_cast<uint32>(timer.due - now - 1);
+}
+
+bool QuestTimerQueue::PopExpired(Expired &out)
+{
+	uint64 now = Now();
+	while (!m_heap.empty() && m_heap.front().due <= now) {
+		HeapNode node = m_heap.front();
+		std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<HeapNode>());
+		m_heap.pop_back();
+
+		auto iter = m_timers.find(node.serial);
+		if (iter == m_timers.end() || iter->second.due != node.due)
+			continue;
+
+		TimerState &timer = iter->second;
+		timer.due = now + timer.interval + 1;
+		m_heap.push_back({ timer.due, node.serial });
+		std::push_heap(m_heap.begin(), m_heap.end(), std::greater<HeapNode>());
+
+		out.mob = timer.mob;
+		out.name = timer.name;
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,72 @@
+#ifndef QUEST_TIMER_QUEUE_H
+#define QUEST_TIMER_QUEUE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../common/types.h"
+
+class Mob;
+
+/*
+ * Script timers ordered by due time. Timers are addressed by (mob, name),
+ * the heap only holds (due, serial) pairs and restarting or stopping a timer
+ * simply leaves its old heap node behind to be skipped when it surfaces.
+ * Timing follows Timer: a timer started at t with duration d fires once the
+ * clock passes t + d and is rearmed from the time it fired.
+ */
+class QuestTimerQueue {
+public:
+	struct Expired {
+		Mob *mob;
+		std::string name;
+	};
+
+	QuestTimerQueue();
+
+	// starts a new timer or restarts an existing one due in duration ms; like
+	// Timer::Start(d, false) a restart does not change the interval used once
+	// the timer fires, and a restart with a duration of 0 waits that interval
+	void Start(Mob *mob, const std::string &name, uint32 duration);
+	bool Stop(Mob *mob, const std::string &name);
+	void StopAll(Mob *mob);
+	void Clear();
+
+	bool Has(Mob *mob, const std::string &name) const;
+	uint32 GetRemainingTime(Mob *mob, const std::string &name) const;
+	size_t Size() const { return m_timers.size(); }
+
+	// pops the next timer that is due, rearming it first so the caller may
+	// stop or restart it from its event handler
+	bool PopExpired(Expired &out);
+
+private:
+	struct TimerState {
+		Mob *mob;
+		std::string name;
+		uint64 due;
+		uint32 interval;
+	};
+
+	struct HeapNode {
+		uint64 due;
+		uint64 serial;
+		bool operator>(const HeapNode &o) const { return due != o.due ? due > o.due : serial > o.serial; }
+	};
+
+	uint64 Now() const;
+	void Push(uint64 due, uint64 serial);
+	void Erase(uint64 serial);
+	void Compact();
+
+	std::unordered_map<uint64, TimerState> m_timers;
+	std::unordered_map<Mob *, std::unordered_map<std::string, uint64>> m_index;
+	std::vector<HeapNode> m_heap;
+	uint64 m_next_serial;
+
+	// Timer's clock is 32 bit, this widens it so due times never wrap
+	mutable uint64 m_clock;
+	mutable uint32 m_last_time;
+};
+
+#endif
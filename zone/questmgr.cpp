@@ -77,30 +77,21 @@ QuestManager::~QuestManager() {
 }
 
 void QuestManager::Process() {
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if (cur->Timer_.Enabled() && cur->Timer_.Check()) {
-			if(entity_list.IsMobInZone(cur->mob)) {
-				if(cur->mob->IsNPC()) {
-					parse->EventNPC(EVENT_TIMER, cur->mob->CastToNPC(), nullptr, cur->name, 0);
-				} else if (cur->mob->IsEncounter()) {
-					parse->EventEncounter(EVENT_TIMER, cur->mob->CastToEncounter()->GetEncounterName(), cur->name, 0, nullptr);
-				} else {
-					//this is inheriently unsafe if we ever make it so more than npc/client start timers
-					parse->EventPlayer(EVENT_TIMER, cur->mob->CastToClient(), cur->name, 0);
-				}
-
-				//we MUST reset our iterator since the quest could have removed/added any
-				//number of timers... worst case we have to check a bunch of timers twice
-				cur = QTimerList.begin();
-				end = QTimerList.end();	//dunno if this is needed, cant hurt...
+	//the timer is rearmed before its event runs, so the quest is free to add or remove timers
+	QuestTimerQueue::Expired expired;
+	while (QTimers.PopExpired(expired)) {
+		if(entity_list.IsMobInZone(expired.mob)) {
+			if(expired.mob->IsNPC()) {
+				parse->EventNPC(EVENT_TIMER, expired.mob->CastToNPC(), nullptr, expired.name, 0);
+			} else if (expired.mob->IsEncounter()) {
+				parse->EventEncounter(EVENT_TIMER, expired.mob->CastToEncounter()->GetEncounterName(), expired.name, 0, nullptr);
 			} else {
-				cur = QTimerList.erase(cur);
+				//this is inheriently unsafe if we ever make it so more than npc/client start timers
+				parse->EventPlayer(EVENT_TIMER, expired.mob->CastToClient(), expired.name, 0);
 			}
-		} else
-			++cur;
+		} else {
+			QTimers.Stop(expired.mob, expired.name);
+		}
 	}
 
 	auto cur_iter = STimerList.begin();
@@ -130,22 +121,14 @@ void QuestManager::EndQuest() {
 	running_quest run = quests_running_.top();
 	if(run.depop_npc && run.owner->IsNPC()) {
 		//clear out any timers for them...
-		std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-		end = QTimerList.end();
-		while (cur != end) {
-			if (cur->mob == run.owner)
-				cur = QTimerList.erase(cur);
-			else
-				++cur;
-		}
+		QTimers.StopAll(run.owner);
 		run.owner->Depop();
 	}
 	quests_running_.pop();
 }
 
 void QuestManager::ClearAllTimers() {
-	QTimerList.clear();
+	QTimers.Clear();
 }
 
 //quest perl functions
@@ -415,20 +398,7 @@ void QuestManager::settimer(const char *timer_name, int seconds) {
 		return;
 	}
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if(cur->mob && cur->mob == owner && cur->name == timer_name)
-		{
-			cur->Timer_.Enable();
-			cur->Timer_.Start(seconds * 1000, false);
-			return;
-		}
-		++cur;
-	}
-
-	QTimerList.push_back(QuestTimer(seconds * 1000, owner, timer_name));
+	QTimers.Start(owner, timer_name, seconds * 1000);
 }
 
 void QuestManager::settimerMS(const char *timer_name, int milliseconds) {
@@ -439,20 +409,7 @@ void QuestManager::settimerMS(const char *timer_name, int milliseconds) {
 		return;
 	}
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if(cur->mob && cur->mob == owner && cur->name == timer_name)
-		{
-			cur->Timer_.Enable();
-			cur->Timer_.Start(milliseconds, false);
-			return;
-		}
-		++cur;
-	}
-
-	QTimerList.push_back(QuestTimer(milliseconds, owner, timer_name));
+	QTimers.Start(owner, timer_name, milliseconds);
 }
 
 void QuestManager::settimerMS(const char *timer_name, int milliseconds, EQ::ItemInstance *inst) {
@@ -462,20 +419,7 @@ void QuestManager::settimerMS(const char *timer_name, int milliseconds, EQ::Item
 }
 
 void QuestManager::settimerMS(const char *timer_name, int milliseconds, Mob *mob) {
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if (cur->mob && cur->mob == mob && cur->name == timer_name)
-		{
-			cur->Timer_.Enable();
-			cur->Timer_.Start(milliseconds, false);
-			return;
-		}
-		++cur;
-	}
-
-	QTimerList.push_back(QuestTimer(milliseconds, mob, timer_name));
+	QTimers.Start(mob, timer_name, milliseconds);
 }
 
 void QuestManager::stoptimer(const char *timer_name) {
@@ -486,16 +430,7 @@ void QuestManager::stoptimer(const char *timer_name) {
 		return;
 	}
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if (cur->mob && cur->mob == owner && cur->name == timer_name) {
-			QTimerList.erase(cur);
-			return;
-		}
-		++cur;
-	}
+	QTimers.Stop(owner, timer_name);
 }
 
 void QuestManager::stoptimer(const char *timer_name, EQ::ItemInstance *inst) {
@@ -505,16 +440,7 @@ void QuestManager::stoptimer(const char *timer_name, EQ::ItemInstance *inst) {
 }
 
 void QuestManager::stoptimer(const char *timer_name, Mob *mob) {
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if (cur->mob && cur->mob == mob && cur->name == timer_name) {
-			QTimerList.erase(cur);
-			return;
-		}
-		++cur;
-	}
+	QTimers.Stop(mob, timer_name);
 }
 
 void QuestManager::stopalltimers() {
@@ -525,15 +451,7 @@ void QuestManager::stopalltimers() {
 		return;
 	}
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end, tmp;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if(cur->mob && cur->mob == owner)
-			cur = QTimerList.erase(cur);
-		else
-			++cur;
-	}
+	QTimers.StopAll(owner);
 }
 
 void QuestManager::stopalltimers(EQ::ItemInstance *inst) {
@@ -543,21 +461,12 @@ void QuestManager::stopalltimers(EQ::ItemInstance *inst) {
 }
 
 void QuestManager::stopalltimers(Mob *mob) {
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end, tmp;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if (cur->mob && cur->mob == mob)
-			cur = QTimerList.erase(cur);
-		else
-			++cur;
-	}
+	QTimers.StopAll(mob);
 }
 
 void QuestManager::pausetimer(const char *timer_name) {
 	QuestManagerCurrentQuestVars();
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
 	std::list<PausedTimer>::iterator pcur = PTimerList.begin(), pend;
 	PausedTimer pt;
 	uint32 milliseconds = 0;
@@ -573,16 +482,10 @@ void QuestManager::pausetimer(const char *timer_name) {
 		++pcur;
 	}
 
-	end = QTimerList.end();
-	while (cur != end)
+	if (QTimers.Has(owner, timer_name))
 	{
-		if (cur->mob && cur->mob == owner && cur->name == timer_name)
-		{
-			milliseconds = cur->Timer_.GetRemainingTime();
-			QTimerList.erase(cur);
-			break;
-		}
-		++cur;
+		milliseconds = QTimers.GetRemainingTime(owner, timer_name);
+		QTimers.Stop(owner, timer_name);
 	}
 
 	std::string timername = timer_name;
@@ -596,7 +499,6 @@ void QuestManager::pausetimer(const char *timer_name) {
 void QuestManager::resumetimer(const char *timer_name) {
 	QuestManagerCurrentQuestVars();
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
 	std::list<PausedTimer>::iterator pcur = PTimerList.begin(), pend;
 	PausedTimer pt;
 	uint32 milliseconds = 0;
@@ -619,20 +521,14 @@ void QuestManager::resumetimer(const char *timer_name) {
 		return;
 	}
 
-	end = QTimerList.end();
-	while (cur != end)
+	if (QTimers.Has(owner, timer_name))
 	{
-		if (cur->mob && cur->mob == owner && cur->name == timer_name)
-		{
-			cur->Timer_.Enable();
-			cur->Timer_.Start(milliseconds, false);
-			LogQuests("Resuming timer [{}] for [{}] with [{}] ms remaining", timer_name, owner->GetName(), milliseconds);
-			return;
-		}
-		++cur;
+		QTimers.Start(owner, timer_name, milliseconds);
+		LogQuests("Resuming timer [{}] for [{}] with [{}] ms remaining", timer_name, owner->GetName(), milliseconds);
+		return;
 	}
 
-	QTimerList.push_back(QuestTimer(milliseconds, owner, timer_name));
+	QTimers.Start(owner, timer_name, milliseconds);
 	LogQuests("Creating a new timer and resuming [{}] for [{}] with [{}] ms remaining", timer_name, owner->GetName(), milliseconds);
 
 }
@@ -1812,6 +1708,8 @@ void QuestManager::set_proximity(float minx, float maxx, float miny, float maxy,
 	owner->CastToNPC()->proximity->max_z         = maxz;
 	owner->CastToNPC()->proximity->say           = bSay;
 	owner->CastToNPC()->proximity->proximity_set = true;
+
+	entity_list.UpdateProximity(owner->CastToNPC());
 }
 
 void QuestManager::clear_proximity() {
@@ -20,6 +20,7 @@
 
 #include "../common/timer.h"
 #include "tasks.h"
+#include "quest_timer_queue.h"
 
 #include <list>
 #include <stack>
@@ -323,14 +324,6 @@ private:
 	int QGVarDuration(const char *fmt);
 	int InsertQuestGlobal(int charid, int npcid, int zoneid, const char *name, const char *value, int expdate);
 
-	class QuestTimer {
-	public:
-		inline QuestTimer(int duration, Mob *_mob, std::string _name)
-			: mob(_mob), name(_name), Timer_(duration) { Timer_.Start(duration, false); }
-		Mob*   mob;
-		std::string name;
-		Timer Timer_;
-	};
 	class SignalTimer {
 	public:
 		inline SignalTimer(int duration, int _npc_id, int _signal_id) : npc_id(_npc_id), signal_id(_signal_id), Timer_(duration) { Timer_.Start(duration, false); }
@@ -338,7 +331,7 @@ private:
 		int signal_id;
 		Timer Timer_;
 	};
-	std::list<QuestTimer>	QTimerList;
+	QuestTimerQueue	QTimers;
 	std::list<SignalTimer>	STimerList;
 	std::list<PausedTimer>	PTimerList;
 	size_t item_timers;
@@ -3490,6 +3490,7 @@ bool TaskProximityManager::LoadProximities(int zoneID) {
 
 	Log(Logs::General, Logs::Tasks, "[GLOBALLOAD] TaskProximityManager::LoadProximities Called for zone %i", zoneID);
 	TaskProximities.clear();
+	ProximityIndex.Clear();
 
     std::string query = StringFormat("SELECT `exploreid`, `minx`, `maxx`, "
                                     "`miny`, `maxy`, `minz`, `maxz` "
@@ -3509,6 +3510,8 @@ bool TaskProximityManager::LoadProximities(int zoneID) {
         proximity.MinZ = atof(row[5]);
         proximity.MaxZ = atof(row[6]);
 
+        ProximityIndex.Set(TaskProximities.size(), proximity.MinX, proximity.MaxX, proximity.MinY,
+                           proximity.MaxY, proximity.MinZ, proximity.MaxZ);
         TaskProximities.push_back(proximity);
     }
 
@@ -3518,20 +3521,17 @@ bool TaskProximityManager::LoadProximities(int zoneID) {
 
 int TaskProximityManager::CheckProximities(float X, float Y, float Z) {
 
-	for(unsigned int i=0; i<TaskProximities.size(); i++) {
-
-		TaskProximity* P = &TaskProximities[i];
-
-		Log(Logs::General, Logs::Tasks, "[PROXIMITY] Checking %8.3f, %8.3f, %8.3f against %8.3f, %8.3f, %8.3f, %8.3f, %8.3f, %8.3f",
-				X, Y, Z, P->MinX, P->MaxX, P->MinY, P->MaxY, P->MinZ, P->MaxZ);
-
-		if(X < P->MinX || X > P->MaxX || Y < P->MinY || Y > P->MaxY ||
-			Z < P->MinZ || Z > P->MaxZ) continue;
+	ProximityHits.clear();
+	ProximityIndex.Query(X, Y, Z, ProximityHits);
+	if (ProximityHits.empty())
+		return 0;
 
-		return P->ExploreID;
+	// overlapping boxes resolve to the first one loaded, as the linear scan did
+	TaskProximity* P = &TaskProximities[*std::min_element(ProximityHits.begin(), ProximityHits.end())];
 
-	}
+	Log(Logs::General, Logs::Tasks, "[PROXIMITY] %8.3f, %8.3f, %8.3f is inside %8.3f, %8.3f, %8.3f, %8.3f, %8.3f, %8.3f",
+			X, Y, Z, P->MinX, P->MaxX, P->MinY, P->MaxY, P->MinZ, P->MaxZ);
 
-	return 0;
+	return P->ExploreID;
 }
 
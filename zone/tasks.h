@@ -21,6 +21,7 @@ Copyright (C) 2001-2004 EQEMu Development Team (http://eqemulator.net)
 #define TASKS_H
 
 #include "../common/types.h"
+#include "proximity_grid.h"
 
 #include <list>
 #include <vector>
@@ -96,6 +97,8 @@ public:
 
 private:
 	std::vector<TaskProximity> TaskProximities;
+	ProximityGrid ProximityIndex; // index into TaskProximities
+	std::vector<int> ProximityHits;
 };
 
 typedef enum { METHODSINGLEID = 0, METHODLIST = 1, METHODQUEST = 2 } TaskMethodType;
@@ -2105,6 +2105,7 @@ void WorldServer::HandleMessage(uint16 opcode, const EQ::Net::Packet &p)
 		if (!database.LoadLoot(hotfix_name)) {
 			LogError("Loading loot failed!");
 		}
+		database.ClearLootDropRollTables();
 
 		LogInfo("Loading skill caps");
 		if (!database.LoadSkillCaps(std::string(hotfix_name))) {
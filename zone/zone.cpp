@@ -46,6 +46,8 @@
 #include "pathfinder_waypoint.h"
 #include "petitions.h"
 #include "quest_parser_collection.h"
+#include "lua_parallel_encounter.h"
+#include "lua_parser.h"
 #include "spawn2.h"
 #include "spawngroup.h"
 #include "water_map.h"
@@ -804,6 +806,7 @@ void Zone::Shutdown(bool quiet)
 	zone->ResetAuth();
 	safe_delete(zone);
 	entity_list.ClearAreas();
+	parse->StopWatchingQuestFiles();
 	parse->ReloadQuests(true);
 	UpdateWindowTitle(nullptr);
 
@@ -940,6 +943,7 @@ Zone::Zone(uint32 in_zoneid, uint32 in_instanceid, const char* in_short_name)
 	map_name = nullptr;
 	Instance_Warning_timer = nullptr;
 	did_adventure_actions = false;
+	did_script_cache_report = false;
 	database.QGlobalPurge();
 
 	if(zoneid == RuleI(World, GuildBankZoneID))
@@ -1100,6 +1104,10 @@ bool Zone::Init(bool iStaticZone) {
 
 	LogInfo("Init Finished: ZoneID = [{}], Time Offset = [{}]", zoneid, zone->zone_time.getEQTimeZone());
 
+	if (RuleB(HotReload, QuestsWatchFiles)) {
+		parse->WatchQuestFiles();
+	}
+
 	LoadTickItems();
 
 	//MODDING HOOK FOR ZONE INIT
@@ -1309,26 +1317,41 @@ bool Zone::Process() {
 		if (GetNpcPositionUpdateDistance() == 0) {
 			CalculateNpcUpdateDistanceSpread();
 		}
+
+#ifdef LUA_EQEMU
+		//quest scripts load on first use, the first spawn pass is what loads most of them
+		if (!did_script_cache_report) {
+			LuaParser::Instance()->ReportBytecodeCache();
+			did_script_cache_report = true;
+		}
+#endif
 	}
 
-	if (hot_reload_timer.Check() && IsQuestHotReloadQueued()) {
+#ifdef LUA_EQEMU
+	LuaParallelEncounters::Instance()->Process();
+#endif
 
-		LogHotReloadDetail("Hot reload timer check...");
+	if (hot_reload_timer.Check()) {
+		ZoneReload::HotReloadChangedQuests();
 
-		bool perform_reload = true;
+		if (IsQuestHotReloadQueued()) {
+			LogHotReloadDetail("Hot reload timer check...");
 
-		if (RuleB(HotReload, QuestsRepopWhenPlayersNotInCombat)) {
-			for (auto &it : entity_list.GetClientList()) {
-				auto client = it.second;
-				if (client->GetAggroCount() > 0) {
-					perform_reload = false;
-					break;
+			bool perform_reload = true;
+
+			if (RuleB(HotReload, QuestsRepopWhenPlayersNotInCombat)) {
+				for (auto &it : entity_list.GetClientList()) {
+					auto client = it.second;
+					if (client->GetAggroCount() > 0) {
+						perform_reload = false;
+						break;
+					}
 				}
 			}
-		}
 
-		if (perform_reload) {
-			ZoneReload::HotReloadQuests();
+			if (perform_reload) {
+				ZoneReload::HotReloadQuests();
+			}
 		}
 	}
 
@@ -101,6 +101,7 @@ public:
 	bool CanLevitate() const { return (can_levitate); } // Magoth78
 	bool Depop(bool StartSpawnTimer = false);
 	bool did_adventure_actions;
+	bool did_script_cache_report;
 	bool GetAuth(
 		uint32 iIP,
 		const char *iCharName,
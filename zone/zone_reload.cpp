@@ -44,3 +44,33 @@ void ZoneReload::HotReloadQuests()
 		timer.elapsed()
 	);
 }
+
+void ZoneReload::HotReloadChangedQuests()
+{
+	if (!parse->IsWatchingQuestFiles()) {
+		return;
+	}
+
+	BenchTimer timer;
+
+	std::vector<std::string> reloaded;
+	if (!parse->ReloadChangedQuests(RuleB(HotReload, QuestsResetTimersWithReload), reloaded)) {
+		LogHotReload("[Quests] A change affects every script in [{}], queueing a full reload", zone->GetShortName());
+		zone->SetQuestHotReloadQueued(true);
+		return;
+	}
+
+	for (auto &file : reloaded) {
+		LogHotReloadDetail("[Quests] Unloaded [{}]", file);
+	}
+
+	if (!reloaded.empty()) {
+		LogHotReload(
+			"[Quests] Reloading [{}] changed scripts in [{}] reset_timers [{}] Time [{:.4f}]",
+			reloaded.size(),
+			zone->GetShortName(),
+			(RuleB(HotReload, QuestsResetTimersWithReload) ? "true" : "false"),
+			timer.elapsed()
+		);
+	}
+}
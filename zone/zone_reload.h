@@ -25,6 +25,7 @@
 class ZoneReload {
 public:
 	static void HotReloadQuests();
+	static void HotReloadChangedQuests();
 };
 
 
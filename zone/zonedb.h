@@ -122,6 +122,14 @@ struct DBTradeskillRecipe_Struct {
 	bool quest;
 };
 
+// Cumulative roll table for a lootdrop, only entries whose item exists are kept
+struct LootDropRollTable {
+	std::vector<uint32> entries; // index into LootDrop_Struct::Entries
+	std::vector<const EQ::ItemData *> items;
+	std::vector<float> cumulative_chance;
+	float total_chance;
+};
+
 struct PetRecord {
 	uint32 npc_type;	// npc_type id for the pet data to use
 	bool temporary;
@@ -454,6 +462,8 @@ public:
 	bool		GetBasePetItems(int32 equipmentset, uint32 *items);
 	void		AddLootTableToNPC(NPC* npc, uint32 loottable_id, ItemList* itemlist, uint32* copper, uint32* silver, uint32* gold, uint32* plat);
 	void		AddLootDropToNPC(NPC* npc, uint32 lootdrop_id, ItemList* itemlist, uint8 droplimit, uint8 mindrop);
+	const LootDropRollTable &GetLootDropRollTable(uint32 lootdrop_id, const LootDrop_Struct *lds);
+	void ClearLootDropRollTables() { loot_drop_roll_tables.clear(); }
 	uint32		GetMaxNPCSpellsID();
 	uint32		GetMaxNPCSpellsEffectsID();
 	bool GetAuraEntry(uint16 spell_id, AuraRecord &record);
@@ -571,6 +581,7 @@ protected:
 	uint32 npc_spellseffects_maxid;
 	std::unordered_map<uint32, DBnpcspells_Struct> npc_spells_cache;
 	std::unordered_set<uint32> npc_spells_loadtried;
+	std::unordered_map<uint32, LootDropRollTable> loot_drop_roll_tables;
 	DBnpcspellseffects_Struct** npc_spellseffects_cache;
 	bool*				npc_spellseffects_loadtried;
 	uint8 door_isopen_array[255];